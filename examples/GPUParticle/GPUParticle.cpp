@@ -218,13 +218,6 @@ GPUParticleEmitPass::GPUParticleEmitPass(GPUParticleContext* context) : context_
 {
 	shader_ = context_->shaders().emitShader;
 
-	for (int i = 0; i < context_->GetMaxFrameCount(); i++)
-	{
-		auto vb = LLGI::CreateSharedPtr(
-			context_->GetGraphcis()->CreateBuffer(LLGI::BufferUsageType::Vertex, sizeof(EmitDataVertex) * context_->GetMaxParticles()));
-		emitDataVertexBuffer_.push_back(vb);
-	}
-
 	emitDataIndexBuffer_ = LLGI::CreateSharedPtr(
 		context_->GetGraphcis()->CreateBuffer(LLGI::BufferUsageType::Index, sizeof(uint32_t) * context_->GetMaxParticles()));
 	auto ib_buf = (uint32_t*)emitDataIndexBuffer_->Lock();
@@ -265,11 +258,16 @@ void GPUParticleEmitPass::Render(LLGI::CommandList* commandList, const std::vect
 	if (particleDataCount <= 0)
 		return;
 
-	// Apply new particles
-	auto currentVB = emitDataVertexBuffer_[context_->GetFrameIndex()].get();
+	// Apply new particles with a memory which is available only in this frame
+	const int32_t vbSize = sizeof(EmitDataVertex) * particleDataCount;
+	LLGI::Buffer* currentVB = nullptr;
+	int32_t vbOffset = 0;
+	if (!context_->GetMemoryPool()->AllocateVertexBuffer(vbSize, currentVB, vbOffset))
+		return;
+
 	{
-		auto vb_buf = (EmitDataVertex*)currentVB->Lock();
-		memcpy(vb_buf, emitData.data(), sizeof(EmitDataVertex) * particleDataCount);
+		auto vb_buf = (EmitDataVertex*)currentVB->Lock(vbOffset, vbSize);
+		memcpy(vb_buf, emitData.data(), vbSize);
 		currentVB->Unlock();
 	}
 
@@ -277,7 +275,7 @@ void GPUParticleEmitPass::Render(LLGI::CommandList* commandList, const std::vect
 
 	commandList->BeginRenderPass(emitParticleRenderPass_[bufferIndex].get());
 
-	commandList->SetVertexBuffer(currentVB, sizeof(EmitDataVertex), 0);
+	commandList->SetVertexBuffer(currentVB, sizeof(EmitDataVertex), vbOffset);
 	commandList->SetIndexBuffer(emitDataIndexBuffer_.get(), 2);
 	commandList->SetConstantBuffer(context_->GetTextureInfoConstantBuffer(), 0);
 	commandList->SetPipelineState(pipelineState_[bufferIndex].get());
@@ -451,12 +449,14 @@ void GPUParticleRenderPass::Render(LLGI::RenderPass* renderPass, LLGI::CommandLi
 // GPUParticleContext
 
 GPUParticleContext::GPUParticleContext(LLGI::Graphics* graphics,
+									   LLGI::SingleFrameMemoryPool* memoryPool,
 									   LLGI::DeviceType deviceType,
 									   int frameCount,
 									   int textureSize,
 									   LLGI::Texture* particleTexture,
 									   GPUParticleShaders shaders)
 	: graphcis_(graphics)
+	, memoryPool_(memoryPool)
 	, deviceType_(deviceType)
 	, bufferTextureWidth_(textureSize)
 	, maxTexels_(textureSize * textureSize)
@@ -90,9 +90,6 @@ private:
 
 	std::shared_ptr<Shader> shader_;
 
-	// LLGI::CommandList::SetData() が未対応なので、Lock/Unlock で対応することになるが、そのため FrameCount 分必要/
-	std::vector<std::shared_ptr<LLGI::Buffer>> emitDataVertexBuffer_;
-
 	// いまは DX12 バックエンドが IndexBuffer 必須となっているので用意する必要がある
 	std::shared_ptr<LLGI::Buffer> emitDataIndexBuffer_;
 
@@ -145,6 +142,7 @@ public:
 	static const int kMaxOneFrameEmitCount = 1024;
 
 	GPUParticleContext(LLGI::Graphics* graphics,
+					   LLGI::SingleFrameMemoryPool* memoryPool,
 					   LLGI::DeviceType deviceType,
 					   int frameCount,
 					   int textureSize,
@@ -153,6 +151,8 @@ public:
 
 	LLGI::Graphics* GetGraphcis() const { return graphcis_; }
 
+	LLGI::SingleFrameMemoryPool* GetMemoryPool() const { return memoryPool_; }
+
 	LLGI::DeviceType GetDeviceType() const { return deviceType_; }
 
 	int GetFrameIndex() const { return frameIndex_; }
@@ -189,6 +189,7 @@ public:
 
 private:
 	LLGI::Graphics* graphcis_;
+	LLGI::SingleFrameMemoryPool* memoryPool_;
 	LLGI::DeviceType deviceType_;
 	int frameIndex_;
 	int maxFrameCount_;
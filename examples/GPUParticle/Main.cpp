@@ -111,7 +111,7 @@ int main()
 	}
 
 	auto particleContext = std::make_unique<GPUParticleContext>(
-		graphics, pp.Device, platform->GetMaxFrameCount(), 512, particleTexture.get(), shaders);
+		graphics, sfMemoryPool, pp.Device, platform->GetMaxFrameCount(), 512, particleTexture.get(), shaders);
 
 	//localFront.x = makeRandom(particle, -1.0, 1.0, ParticleRandomSource::Self);
 	//localFront.y = makeRandom(particle, -1.0, 1.0, ParticleRandomSource::Self);
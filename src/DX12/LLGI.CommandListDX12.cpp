@@ -57,46 +57,85 @@ D3D12_SHADER_RESOURCE_VIEW_DESC CommandListDX12::GetSRVDescFromTexture(const Tex
 	return srvDesc;
 }
 
-D3D12_SAMPLER_DESC CommandListDX12::GeSamplerDescFromBindingTexture(const CommandList::BindingTexture& texture)
+static D3D12_TEXTURE_ADDRESS_MODE GetTextureAddressMode(TextureWrapMode wrapMode)
 {
-	auto wrapMode = texture.wrapMode;
-	auto minMagFilter = texture.minMagFilter;
-
-	D3D12_SAMPLER_DESC samplerDesc = {};
-
-	if (minMagFilter == TextureMinMagFilter::Nearest)
-	{
-		samplerDesc.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
-	}
-	else
+	switch (wrapMode)
 	{
-		samplerDesc.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+	case TextureWrapMode::Repeat:
+		return D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	case TextureWrapMode::Mirror:
+		return D3D12_TEXTURE_ADDRESS_MODE_MIRROR;
+	case TextureWrapMode::Border:
+		return D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+	default:
+		return D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
 	}
+}
+
+static D3D12_FILTER_TYPE GetFilterType(TextureMinMagFilter filter)
+{
+	return filter == TextureMinMagFilter::Linear ? D3D12_FILTER_TYPE_LINEAR : D3D12_FILTER_TYPE_POINT;
+}
 
-	if (wrapMode == TextureWrapMode::Repeat)
+static D3D12_COMPARISON_FUNC GetComparisonFunc(CompareFuncType func)
+{
+	switch (func)
 	{
-		samplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
-		samplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
-		samplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	case CompareFuncType::Never:
+		return D3D12_COMPARISON_FUNC_NEVER;
+	case CompareFuncType::Less:
+		return D3D12_COMPARISON_FUNC_LESS;
+	case CompareFuncType::Equal:
+		return D3D12_COMPARISON_FUNC_EQUAL;
+	case CompareFuncType::LessEqual:
+		return D3D12_COMPARISON_FUNC_LESS_EQUAL;
+	case CompareFuncType::Greater:
+		return D3D12_COMPARISON_FUNC_GREATER;
+	case CompareFuncType::NotEqual:
+		return D3D12_COMPARISON_FUNC_NOT_EQUAL;
+	case CompareFuncType::GreaterEqual:
+		return D3D12_COMPARISON_FUNC_GREATER_EQUAL;
+	default:
+		return D3D12_COMPARISON_FUNC_ALWAYS;
 	}
-	else if (wrapMode == TextureWrapMode::Clamp)
+}
+
+D3D12_SAMPLER_DESC CommandListDX12::GeSamplerDescFromBindingTexture(const CommandList::BindingTexture& texture)
+{
+	const auto& parameter = texture.sampler;
+
+	D3D12_SAMPLER_DESC samplerDesc = {};
+
+	auto reduction = parameter.IsCompareEnabled ? D3D12_FILTER_REDUCTION_TYPE_COMPARISON : D3D12_FILTER_REDUCTION_TYPE_STANDARD;
+
+	if (parameter.MaxAnisotropy > 1)
 	{
-		samplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-		samplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-		samplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+		samplerDesc.Filter = D3D12_ENCODE_ANISOTROPIC_FILTER(reduction);
+		samplerDesc.MaxAnisotropy = static_cast<UINT>(std::min(parameter.MaxAnisotropy, D3D12_MAX_MAXANISOTROPY));
 	}
-	else if (wrapMode == TextureWrapMode::Mirror)
+	else
 	{
-		samplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_MIRROR;
-		samplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_MIRROR;
-		samplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_MIRROR;
+		auto mipFilter = parameter.MipFilter == TextureMipFilter::Linear ? D3D12_FILTER_TYPE_LINEAR : D3D12_FILTER_TYPE_POINT;
+		samplerDesc.Filter =
+			D3D12_ENCODE_BASIC_FILTER(GetFilterType(parameter.MinFilter), GetFilterType(parameter.MagFilter), mipFilter, reduction);
+		samplerDesc.MaxAnisotropy = 0;
 	}
 
-	samplerDesc.MipLODBias = 0;
-	samplerDesc.MaxAnisotropy = 0;
-	samplerDesc.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
-	samplerDesc.MinLOD = 0.0f;
-	samplerDesc.MaxLOD = D3D12_FLOAT32_MAX;
+	samplerDesc.AddressU = GetTextureAddressMode(parameter.WrapModeU);
+	samplerDesc.AddressV = GetTextureAddressMode(parameter.WrapModeV);
+	samplerDesc.AddressW = GetTextureAddressMode(parameter.WrapModeW);
+
+	samplerDesc.MipLODBias = parameter.MipLodBias;
+	samplerDesc.ComparisonFunc = parameter.IsCompareEnabled ? GetComparisonFunc(parameter.CompareFunc) : D3D12_COMPARISON_FUNC_NEVER;
+	samplerDesc.MinLOD = parameter.MinLod;
+	samplerDesc.MaxLOD = parameter.MipFilter == TextureMipFilter::None ? parameter.MinLod : parameter.MaxLod;
+
+	auto borderAlpha = parameter.BorderColor == TextureBorderColor::TransparentBlack ? 0.0f : 1.0f;
+	auto borderValue = parameter.BorderColor == TextureBorderColor::OpaqueWhite ? 1.0f : 0.0f;
+	samplerDesc.BorderColor[0] = borderValue;
+	samplerDesc.BorderColor[1] = borderValue;
+	samplerDesc.BorderColor[2] = borderValue;
+	samplerDesc.BorderColor[3] = borderAlpha;
 	return samplerDesc;
 }
 
@@ -293,9 +332,18 @@ void CommandListDX12::BeginRenderPass(RenderPass* renderPass)
 		currentCommandList_->RSSetScissorRects(renderPass_->GetCount(), rects);
 		currentCommandList_->RSSetViewports(renderPass_->GetCount(), viewports);
 
-		if (renderPass_->GetIsColorCleared())
+		// only clears are available without a render pass api, so other contents are always loaded and stored
+		auto handle = renderPass_->GetHandleRTV();
+		for (int i = 0; i < renderPass_->GetCount(); i++)
 		{
-			Clear(renderPass_->GetClearColor());
+			if (renderPass_->GetColorLoadOp(i) != AttachmentLoadOp::Clear)
+			{
+				continue;
+			}
+
+			const auto color = renderPass_->GetClearColor(i);
+			float color_[] = {color.R / 255.0f, color.G / 255.0f, color.B / 255.0f, color.A / 255.0f};
+			currentCommandList_->ClearRenderTargetView(handle[i], color_, 0, nullptr);
 		}
 
 		if (renderPass_->GetIsDepthCleared())
@@ -740,6 +788,14 @@ void CommandListDX12::CopyBuffer(Buffer* src, Buffer* dst)
 	}
 }
 
+void CommandListDX12::SetTexture(Texture* texture, TextureWrapMode wrapMode, TextureMinMagFilter minmagFilter, int32_t unit)
+{
+	// mipmaps were sampled with the same filter as min and mag filters with the legacy arguments in DX12
+	SamplerParameter sampler(wrapMode, minmagFilter);
+	sampler.MipFilter = minmagFilter == TextureMinMagFilter::Nearest ? TextureMipFilter::Nearest : TextureMipFilter::Linear;
+	CommandList::SetTexture(texture, sampler, unit);
+}
+
 bool CommandListDX12::ResetQuery(Query* query)
 {
 	return true;
@@ -1011,7 +1067,12 @@ void CommandListDX12::ClearDepth()
 	}
 
 	auto handle = rt->GetHandleDSV();
-	currentCommandList_->ClearDepthStencilView(handle[0], D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
+	currentCommandList_->ClearDepthStencilView(handle[0],
+											   D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL,
+											   rt->GetClearDepth(),
+											   static_cast<UINT8>(rt->GetClearStencil()),
+											   0,
+											   nullptr);
 }
 
 ID3D12GraphicsCommandList* CommandListDX12::GetCommandList() const { return commandList_.get(); }
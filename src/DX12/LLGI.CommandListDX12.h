@@ -63,6 +63,9 @@ public:
 
 	void CopyBuffer(Buffer* src, Buffer* dst) override;
 
+	using CommandList::SetTexture;
+	void SetTexture(Texture* texture, TextureWrapMode wrapMode, TextureMinMagFilter minmagFilter, int32_t unit) override;
+
 	bool ResetQuery(Query* query) override;
 	bool BeginQuery(Query* query, uint32_t queryIndex) override;
 	bool EndQuery(Query* query, uint32_t queryIndex) override;
@@ -201,6 +201,9 @@ bool PlatformDX12::GenerateSwapBuffer()
 		renderTargets_[i] = new TextureDX12(renderResources_[i], device, commandQueue);
 		renderPasses_[i] = new RenderPassDX12(device);
 		renderPasses_[i]->Initialize(&renderTargets_[i], 1, nullptr, nullptr, nullptr);
+
+		// a depth of a screen is not used after the frame, so it is not written back
+		renderPasses_[i]->SetDepthStoreOp(AttachmentStoreOp::Discard);
 	}
 
 	return true;
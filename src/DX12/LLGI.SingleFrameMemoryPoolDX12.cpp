@@ -30,7 +30,7 @@ void InternalSingleFrameMemoryPoolDX12::Reset() { constantBufferOffset_ = 0; }
 
 SingleFrameMemoryPoolDX12::SingleFrameMemoryPoolDX12(
 	GraphicsDX12* graphics, bool isStrongRef, int32_t swapBufferCount, int32_t constantBufferPoolSize, int32_t drawingCount)
-	: SingleFrameMemoryPool(swapBufferCount), graphics_(graphics), isStrongRef_(isStrongRef), drawingCount_(drawingCount)
+	: SingleFrameMemoryPool(swapBufferCount, graphics), graphics_(graphics), isStrongRef_(isStrongRef), drawingCount_(drawingCount)
 {
 	if (isStrongRef)
 	{
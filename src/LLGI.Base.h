@@ -28,6 +28,9 @@ enum class DeviceType
 	DirectX12,
 	Metal,
 	Vulkan,
+
+	//! record commands on cpu without a driver to measure an overhead of LLGI itself
+	Null,
 };
 
 enum class ErrorCode
@@ -96,6 +99,9 @@ enum class TextureWrapMode
 	Clamp,
 	Repeat,
 	Mirror,
+
+	//! a border color is returned outside of a texture
+	Border,
 };
 
 enum class TextureMinMagFilter
@@ -104,6 +110,21 @@ enum class TextureMinMagFilter
 	Linear,
 };
 
+enum class TextureMipFilter
+{
+	//! only the first mip level is sampled
+	None,
+	Nearest,
+	Linear,
+};
+
+enum class TextureBorderColor
+{
+	TransparentBlack,
+	OpaqueBlack,
+	OpaqueWhite,
+};
+
 enum class DepthFuncType
 {
 	Never,
@@ -128,6 +149,80 @@ enum class CompareFuncType
 	Always,
 };
 
+/**
+	@brief	a description of how a texture is sampled
+	@note
+	Samplers are shared among command lists if their descriptions are same.
+*/
+struct SamplerParameter
+{
+	TextureWrapMode WrapModeU = TextureWrapMode::Clamp;
+	TextureWrapMode WrapModeV = TextureWrapMode::Clamp;
+	TextureWrapMode WrapModeW = TextureWrapMode::Clamp;
+	TextureMinMagFilter MinFilter = TextureMinMagFilter::Nearest;
+	TextureMinMagFilter MagFilter = TextureMinMagFilter::Nearest;
+	TextureMipFilter MipFilter = TextureMipFilter::Linear;
+
+	//! anisotropic filtering is enabled if it is larger than 1. It is clamped with a limit of a device.
+	int32_t MaxAnisotropy = 1;
+
+	float MipLodBias = 0.0f;
+	float MinLod = 0.0f;
+	float MaxLod = 1000.0f;
+
+	//! it is used with TextureWrapMode::Border
+	TextureBorderColor BorderColor = TextureBorderColor::TransparentBlack;
+
+	//! a result of comparing a reference value with a sampled depth is returned instead of the depth (ex. shadow maps)
+	bool IsCompareEnabled = false;
+	CompareFuncType CompareFunc = CompareFuncType::LessEqual;
+
+	SamplerParameter() = default;
+
+	//! a sampler which is specified with the legacy SetTexture
+	SamplerParameter(TextureWrapMode wrapMode, TextureMinMagFilter minMagFilter)
+		: WrapModeU(wrapMode), WrapModeV(wrapMode), WrapModeW(wrapMode), MinFilter(minMagFilter), MagFilter(minMagFilter)
+	{
+	}
+
+	bool operator==(const SamplerParameter& value) const
+	{
+		return WrapModeU == value.WrapModeU && WrapModeV == value.WrapModeV && WrapModeW == value.WrapModeW &&
+			   MinFilter == value.MinFilter && MagFilter == value.MagFilter && MipFilter == value.MipFilter &&
+			   MaxAnisotropy == value.MaxAnisotropy && MipLodBias == value.MipLodBias && MinLod == value.MinLod &&
+			   MaxLod == value.MaxLod && BorderColor == value.BorderColor && IsCompareEnabled == value.IsCompareEnabled &&
+			   CompareFunc == value.CompareFunc;
+	}
+
+	bool operator!=(const SamplerParameter& value) const { return !(*this == value); }
+
+	struct Hash
+	{
+		typedef std::size_t result_type;
+
+		std::size_t operator()(const SamplerParameter& value) const
+		{
+			// enums are packed because they are small
+			uint32_t modes = static_cast<uint32_t>(value.WrapModeU);
+			modes = (modes << 2) | static_cast<uint32_t>(value.WrapModeV);
+			modes = (modes << 2) | static_cast<uint32_t>(value.WrapModeW);
+			modes = (modes << 1) | static_cast<uint32_t>(value.MinFilter);
+			modes = (modes << 1) | static_cast<uint32_t>(value.MagFilter);
+			modes = (modes << 2) | static_cast<uint32_t>(value.MipFilter);
+			modes = (modes << 2) | static_cast<uint32_t>(value.BorderColor);
+			modes = (modes << 1) | (value.IsCompareEnabled ? 1 : 0);
+			modes = (modes << 3) | static_cast<uint32_t>(value.CompareFunc);
+
+			auto ret = std::hash<uint32_t>()(modes);
+			ret = ret * 31 + std::hash<int32_t>()(value.MaxAnisotropy);
+			ret = ret * 31 + std::hash<float>()(value.MipLodBias);
+			ret = ret * 31 + std::hash<float>()(value.MinLod);
+			ret = ret * 31 + std::hash<float>()(value.MaxLod);
+			return ret;
+		}
+	};
+};
+
 enum class StencilOperatorType
 {
 	Keep,
@@ -276,6 +371,9 @@ enum class TextureUsageType : uint32_t
 	Array = 1 << 1,
 	Storage = 1 << 2,
 	External = 1 << 3,
+
+	//! an attachment whose contents are used only in a render pass. It cannot be sampled, copied or read back.
+	Transient = 1 << 4,
 };
 
 inline TextureUsageType operator|(TextureUsageType lhs, TextureUsageType rhs)
@@ -288,6 +386,34 @@ inline TextureUsageType operator&(TextureUsageType lhs, TextureUsageType rhs)
 	return static_cast<TextureUsageType>(static_cast<uint32_t>(lhs) & static_cast<uint32_t>(rhs));
 }
 
+enum class AttachmentLoadOp
+{
+	//! keep previous contents
+	Load,
+
+	//! fill with a clear value
+	Clear,
+
+	//! previous contents are undefined, so nothing is read from memory
+	DontCare,
+};
+
+/**
+	@note
+	Multisampled contents are resolved into a resolved texture whenever it is assigned to a render pass.
+*/
+enum class AttachmentStoreOp
+{
+	//! write contents into memory
+	Store,
+
+	//! contents are undefined after a render pass, so nothing is written into memory
+	Discard,
+
+	//! write only contents which are resolved into a resolved texture
+	Resolve,
+};
+
 enum class BufferUsageType : uint32_t
 {
 	Index = 1 << 0,
@@ -471,6 +597,8 @@ class Compiler;
 class RenderPass;
 class RenderPassPipelineState;
 class Query;
+class Readback;
+class SingleFrameMemoryPool;
 
 enum class LogType
 {
@@ -1,6 +1,7 @@
 
 #include "LLGI.CommandList.h"
 #include "LLGI.Buffer.h"
+#include "LLGI.Graphics.h"
 #include "LLGI.PipelineState.h"
 #include "LLGI.Texture.h"
 
@@ -37,6 +38,13 @@ void CommandList::RegisterReferencedObject(ReferenceObject* referencedObject)
 	swapObjects[swapIndex_].referencedObjects.push_back(referencedObject);
 }
 
+void CommandList::SetBoundStatesDirtied()
+{
+	isVertexBufferDirtied = true;
+	isCurrentIndexBufferDirtied = true;
+	isPipelineDirtied = true;
+}
+
 CommandList::CommandList(int32_t swapCount) : swapCount_(swapCount)
 {
 	constantBuffers_.fill(nullptr);
@@ -89,6 +97,7 @@ void CommandList::Begin()
 	isVertexBufferDirtied = true;
 	isCurrentIndexBufferDirtied = true;
 	isPipelineDirtied = true;
+	isPipelineStateSkipped_ = false;
 	ResetTextures();
 	ResetComputeBuffer();
 
@@ -111,6 +120,7 @@ bool CommandList::BeginWithPlatform(void* platformContextPtr)
 	isVertexBufferDirtied = true;
 	isCurrentIndexBufferDirtied = true;
 	isPipelineDirtied = true;
+	isPipelineStateSkipped_ = false;
 	ResetTextures();
 	ResetComputeBuffer();
 
@@ -185,12 +195,35 @@ void CommandList::SetIndexBuffer(Buffer* indexBuffer, int32_t stride, int32_t of
 
 void CommandList::SetPipelineState(PipelineState* pipelineState)
 {
+	if (pipelineState != nullptr && pipelineState->GetIsCompiling())
+	{
+		pipelineState->WaitUntilCompiled();
+	}
+
 	currentPipelineState = pipelineState;
 	isPipelineDirtied = true;
+	isPipelineStateSkipped_ = false;
 
 	RegisterReferencedObject(pipelineState);
 }
 
+void CommandList::SetPipelineState(PipelineState* pipelineState, PipelineState* fallbackPipelineState)
+{
+	if (pipelineState != nullptr && pipelineState->GetIsCompiling())
+	{
+		if (fallbackPipelineState == nullptr)
+		{
+			isPipelineStateSkipped_ = true;
+			return;
+		}
+
+		SetPipelineState(fallbackPipelineState);
+		return;
+	}
+
+	SetPipelineState(pipelineState);
+}
+
 void CommandList::SetConstantBuffer(Buffer* constantBuffer, int32_t unit)
 {
 	SafeAssign(constantBuffers_[unit], constantBuffer);
@@ -207,10 +240,14 @@ void CommandList::SetComputeBuffer(Buffer* computeBuffer, int32_t stride, int32_
 }
 
 void CommandList::SetTexture(Texture* texture, TextureWrapMode wrapMode, TextureMinMagFilter minmagFilter, int32_t unit)
+{
+	SetTexture(texture, SamplerParameter(wrapMode, minmagFilter), unit);
+}
+
+void CommandList::SetTexture(Texture* texture, const SamplerParameter& sampler, int32_t unit)
 {
 	SafeAssign(currentTextures_[unit].texture, texture);
-	currentTextures_[unit].wrapMode = wrapMode;
-	currentTextures_[unit].minMagFilter = minmagFilter;
+	currentTextures_[unit].sampler = sampler;
 
 	RegisterReferencedObject(texture);
 }
@@ -220,8 +257,7 @@ void CommandList::ResetTextures()
 	for (auto& texture : currentTextures_)
 	{
 		SafeRelease(texture.texture);
-		texture.wrapMode = TextureWrapMode::Clamp;
-		texture.minMagFilter = TextureMinMagFilter::Nearest;
+		texture.sampler = SamplerParameter();
 	}
 }
 
@@ -231,6 +267,21 @@ void CommandList::BeginRenderPass(RenderPass* renderPass)
 	isCurrentIndexBufferDirtied = true;
 	isPipelineDirtied = true;
 	isInRenderPass_ = true;
+
+	// attachments must not be destroyed until gpu completes this command list, even if they are released after Present
+	if (renderPass != nullptr)
+	{
+		RegisterReferencedObject(renderPass);
+
+		for (int32_t i = 0; i < renderPass->GetRenderTextureCount(); i++)
+		{
+			RegisterReferencedObject(renderPass->GetRenderTexture(i));
+		}
+
+		RegisterReferencedObject(renderPass->GetDepthTexture());
+		RegisterReferencedObject(renderPass->GetResolvedRenderTexture());
+		RegisterReferencedObject(renderPass->GetResolvedDepthTexture());
+	}
 }
 
 bool CommandList::BeginRenderPassWithPlatformPtr(void* platformPtr)
@@ -242,6 +293,13 @@ bool CommandList::BeginRenderPassWithPlatformPtr(void* platformPtr)
 	return true;
 }
 
+void CommandList::BeginRenderPassWithSubCommandLists(RenderPass* renderPass) { BeginRenderPass(renderPass); }
+
+void CommandList::ExecuteSubCommandLists(CommandList** subCommandLists, int32_t count)
+{
+	Log(LogType::Warning, "ExecuteSubCommandLists is not supported on this platform.");
+}
+
 void CommandList::Dispatch(int32_t groupX, int32_t groupY, int32_t groupZ, int32_t threadX, int32_t threadY, int32_t threadZ)
 {
 	isPipelineDirtied = false;
@@ -43,8 +43,7 @@ protected:
 	struct BindingTexture
 	{
 		Texture* texture = nullptr;
-		TextureWrapMode wrapMode = TextureWrapMode::Clamp;
-		TextureMinMagFilter minMagFilter = TextureMinMagFilter::Nearest;
+		SamplerParameter sampler;
 	};
 
 	struct BindingComputeBuffer
@@ -78,6 +77,9 @@ protected:
 	bool isInRenderPass_ = false;
 	bool isInBegin_ = false;
 
+	//! draws are skipped because a pipeline state is being compiled
+	bool isPipelineStateSkipped_ = false;
+
 	std::array<Buffer*, NumConstantBuffer> constantBuffers_;
 	std::array<BindingTexture, NumTexture> currentTextures_;
 	std::array<BindingComputeBuffer, NumComputeBuffer> computeBuffers_;
@@ -88,6 +90,10 @@ protected:
 	void GetCurrentPipelineState(PipelineState*& pipelineState, bool& isDirtied);
 	void GetCurrentComputeBuffer(int32_t unit, BindingComputeBuffer& buffer);
 	void RegisterReferencedObject(ReferenceObject* referencedObject);
+	bool GetDoesBeginWithPlatform() const { return doesBeginWithPlatform_; }
+
+	//! bind a pipeline state and buffers again in the next draw because bound states of a command buffer become undefined
+	void SetBoundStatesDirtied();
 
 public:
 	CommandList(int32_t swapCount = 3);
@@ -115,7 +121,22 @@ public:
 	virtual void Draw(int32_t primitiveCount, int32_t instanceCount = 1);
 	virtual void SetVertexBuffer(Buffer* vertexBuffer, int32_t stride, int32_t offset);
 	virtual void SetIndexBuffer(Buffer* indexBuffer, int32_t stride, int32_t offset = 0);
+
+	/**
+		@brief	specify a pipeline state
+		@note
+		It waits until the pipeline state is compiled if it is being compiled with PipelineState::CompileAsync.
+	*/
 	virtual void SetPipelineState(PipelineState* pipelineState);
+
+	/**
+		@brief	specify a pipeline state without waiting for compiling
+		@note
+		If pipelineState is being compiled with PipelineState::CompileAsync, fallbackPipelineState is specified instead.
+		If fallbackPipelineState is null, Draw and Dispatch are skipped until a pipeline state is specified again.
+	*/
+	void SetPipelineState(PipelineState* pipelineState, PipelineState* fallbackPipelineState);
+
 	virtual void SetConstantBuffer(Buffer* constantBuffer, int32_t unit);
 	virtual void SetComputeBuffer(Buffer* computeBuffer, int32_t stride, int32_t unit, bool is_readonly);
 
@@ -134,9 +155,18 @@ public:
 
 	/**
 		@brief specify textures
+		@note
+		Mipmaps are sampled linearly, except DX12 which samples them with minmagFilter as before.
 	*/
 	virtual void SetTexture(Texture* texture, TextureWrapMode wrapMode, TextureMinMagFilter minmagFilter, int32_t unit);
 
+	/**
+		@brief	specify a texture with a sampler which is described in detail
+		@note
+		Anisotropic filtering, lod, border colors and comparison are available only with it.
+	*/
+	virtual void SetTexture(Texture* texture, const SamplerParameter& sampler, int32_t unit);
+
 	/**
 		@brief generate mipmap
 		@note
@@ -159,6 +189,22 @@ public:
 
 	virtual void EndRenderPass() { isInRenderPass_ = false; }
 
+	/**
+		@brief	begin a render pass whose commands are recorded in sub command lists
+		@note
+		Draw can't be called with this command list until EndRenderPass. Call ExecuteSubCommandLists instead.
+	*/
+	virtual void BeginRenderPassWithSubCommandLists(RenderPass* renderPass);
+
+	/**
+		@brief	execute commands which are recorded in sub command lists in the current render pass
+		@note
+		Sub command lists are created with Graphics::CreateSubCommandList.
+		Each of them calls Begin, BeginRenderPass with the same render pass, EndRenderPass and End on its own thread.
+		A thread must use its own SingleFrameMemoryPool because it is not thread safe.
+	*/
+	virtual void ExecuteSubCommandLists(CommandList** subCommandLists, int32_t count);
+
 	/**
 		@brief
 		The pair of BeginRenderPassWithPlatformPtr
@@ -180,6 +226,24 @@ public:
 
 	virtual void CopyBuffer(Buffer* src, Buffer* dst) {}
 
+	/**
+		@brief	record a copy of mip 0 of a texture into memory which is read by cpu
+		@return	a ticket to get data after this command list is executed. It must be released by a caller.
+		@note
+		This function is supported in some platform.
+		It is not supported with BeginWithPlatform because a command list is not submitted with Graphics::Execute.
+	*/
+	virtual Readback* ReadbackTexture(Texture* texture) { return nullptr; }
+
+	/**
+		@brief	record a copy of a buffer into memory which is read by cpu
+		@return	a ticket to get data after this command list is executed. It must be released by a caller.
+		@note
+		This function is supported in some platform.
+		It is not supported with BeginWithPlatform because a command list is not submitted with Graphics::Execute.
+	*/
+	virtual Readback* ReadbackBuffer(Buffer* buffer) { return nullptr; }
+
 	/**
 		@brief	send a memory in specified texture from cpu to gpu
 	*/
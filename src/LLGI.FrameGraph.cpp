@@ -0,0 +1,558 @@
+#include "LLGI.FrameGraph.h"
+#include "LLGI.Buffer.h"
+#include "LLGI.CommandList.h"
+#include "LLGI.Texture.h"
+#include <algorithm>
+
+namespace LLGI
+{
+
+static bool IsSameTextureParameter(const TextureParameter& a, const TextureParameter& b)
+{
+	return a.Usage == b.Usage && a.Format == b.Format && a.Dimension == b.Dimension && a.Size == b.Size &&
+		   a.MipLevelCount == b.MipLevelCount && a.SampleCount == b.SampleCount;
+}
+
+static void AddUniqueIndex(std::vector<int32_t>& indexes, int32_t index)
+{
+	if (std::find(indexes.begin(), indexes.end(), index) == indexes.end())
+	{
+		indexes.emplace_back(index);
+	}
+}
+
+FrameGraphResource FrameGraphPassBuilder::CreateTexture(const TextureParameter& parameter)
+{
+	FrameGraph::Resource resource;
+	resource.isTransient = true;
+	resource.parameter = parameter;
+	return frameGraph_->AddResource(resource);
+}
+
+FrameGraphResource FrameGraphPassBuilder::Read(FrameGraphResource resource)
+{
+	if (!frameGraph_->IsValidResource(resource))
+	{
+		Log(LogType::Error, "FrameGraphPassBuilder::Read : An invalid resource is specified.");
+		return resource;
+	}
+
+	AddUniqueIndex(frameGraph_->passes_[passIndex_].reads, resource.Index);
+	return resource;
+}
+
+FrameGraphResource FrameGraphPassBuilder::Write(FrameGraphResource resource)
+{
+	if (!frameGraph_->IsValidResource(resource))
+	{
+		Log(LogType::Error, "FrameGraphPassBuilder::Write : An invalid resource is specified.");
+		return resource;
+	}
+
+	AddUniqueIndex(frameGraph_->passes_[passIndex_].writes, resource.Index);
+	return resource;
+}
+
+void FrameGraphPassBuilder::SetRenderTarget(int32_t index, FrameGraphResource texture)
+{
+	if (index < 0 || index >= RenderTargetMax || !frameGraph_->IsValidResource(texture))
+	{
+		Log(LogType::Error, "FrameGraphPassBuilder::SetRenderTarget : An invalid index or texture is specified.");
+		return;
+	}
+
+	auto& pass = frameGraph_->passes_[passIndex_];
+	if (static_cast<int32_t>(pass.renderTargets.size()) <= index)
+	{
+		pass.renderTargets.resize(index + 1, -1);
+	}
+
+	pass.renderTargets[index] = texture.Index;
+	Write(texture);
+}
+
+void FrameGraphPassBuilder::SetDepthTarget(FrameGraphResource texture)
+{
+	if (!frameGraph_->IsValidResource(texture))
+	{
+		Log(LogType::Error, "FrameGraphPassBuilder::SetDepthTarget : An invalid texture is specified.");
+		return;
+	}
+
+	frameGraph_->passes_[passIndex_].depthTarget = texture.Index;
+	Write(texture);
+}
+
+void FrameGraphPassBuilder::SetClearColor(const Color8& color)
+{
+	auto& pass = frameGraph_->passes_[passIndex_];
+	pass.isColorCleared = true;
+	pass.clearColor = color;
+}
+
+void FrameGraphPassBuilder::SetIsDepthCleared(bool isDepthCleared) { frameGraph_->passes_[passIndex_].isDepthCleared = isDepthCleared; }
+
+void FrameGraphPassBuilder::SetRenderPass(RenderPass* renderPass) { SafeAssign(frameGraph_->passes_[passIndex_].renderPass, renderPass); }
+
+void FrameGraphPassBuilder::SetHasSideEffect() { frameGraph_->passes_[passIndex_].hasSideEffect = true; }
+
+Texture* FrameGraphPassContext::GetTexture(FrameGraphResource resource) const { return frameGraph_->GetTexture(resource); }
+
+Buffer* FrameGraphPassContext::GetBuffer(FrameGraphResource resource) const
+{
+	if (!frameGraph_->IsValidResource(resource))
+	{
+		return nullptr;
+	}
+
+	return frameGraph_->resources_[resource.Index].buffer;
+}
+
+FrameGraph::FrameGraph(Graphics* graphics, int32_t swapBufferCount) : swapBufferCount_(swapBufferCount)
+{
+	SafeAssign(graphics_, graphics);
+}
+
+FrameGraph::~FrameGraph()
+{
+	Reset();
+
+	for (auto& physicalTexture : physicalTextures_)
+	{
+		SafeRelease(physicalTexture.texture);
+	}
+	physicalTextures_.clear();
+
+	for (auto& renderPass : renderPasses_)
+	{
+		SafeRelease(renderPass.renderPass);
+	}
+	renderPasses_.clear();
+
+	SafeRelease(graphics_);
+}
+
+FrameGraphResource FrameGraph::AddResource(const Resource& resource)
+{
+	resources_.emplace_back(resource);
+
+	FrameGraphResource ret;
+	ret.Index = static_cast<int32_t>(resources_.size()) - 1;
+	return ret;
+}
+
+bool FrameGraph::IsValidResource(FrameGraphResource resource) const
+{
+	return resource.GetIsValid() && resource.Index < static_cast<int32_t>(resources_.size());
+}
+
+FrameGraphResource FrameGraph::ImportTexture(Texture* texture)
+{
+	if (texture == nullptr)
+	{
+		return FrameGraphResource();
+	}
+
+	Resource resource;
+	SafeAssign(resource.texture, texture);
+	return AddResource(resource);
+}
+
+FrameGraphResource FrameGraph::ImportBuffer(Buffer* buffer)
+{
+	if (buffer == nullptr)
+	{
+		return FrameGraphResource();
+	}
+
+	Resource resource;
+	SafeAssign(resource.buffer, buffer);
+	return AddResource(resource);
+}
+
+void FrameGraph::AddPass(const char* name,
+						 FrameGraphPassType type,
+						 const std::function<void(FrameGraphPassBuilder&)>& setup,
+						 const std::function<void(FrameGraphPassContext&)>& execute)
+{
+	Pass pass;
+	pass.name = name != nullptr ? name : "";
+	pass.type = type;
+	pass.execute = execute;
+	passes_.emplace_back(pass);
+
+	FrameGraphPassBuilder builder(this, static_cast<int32_t>(passes_.size()) - 1);
+	if (setup != nullptr)
+	{
+		setup(builder);
+	}
+
+	isCompiled_ = false;
+}
+
+void FrameGraph::MarkAsOutput(FrameGraphResource resource)
+{
+	if (!IsValidResource(resource))
+	{
+		return;
+	}
+
+	resources_[resource.Index].isOutput = true;
+}
+
+void FrameGraph::Cull()
+{
+	// results of imported resources and outputs remain after the graph
+	std::vector<bool> isNeeded(resources_.size());
+	for (size_t i = 0; i < resources_.size(); i++)
+	{
+		isNeeded[i] = !resources_[i].isTransient || resources_[i].isOutput;
+	}
+
+	for (int32_t i = static_cast<int32_t>(passes_.size()) - 1; i >= 0; i--)
+	{
+		auto& pass = passes_[i];
+
+		pass.isCulled = !pass.hasSideEffect && pass.renderPass == nullptr;
+		for (auto w : pass.writes)
+		{
+			if (isNeeded[w])
+			{
+				pass.isCulled = false;
+			}
+		}
+
+		if (pass.isCulled)
+		{
+			continue;
+		}
+
+		// previous contents are not needed if they are overwritten without reading
+		for (auto w : pass.writes)
+		{
+			isNeeded[w] = false;
+		}
+
+		for (auto r : pass.reads)
+		{
+			isNeeded[r] = true;
+		}
+	}
+}
+
+bool FrameGraph::AllocateTransientTextures()
+{
+	for (auto& physicalTexture : physicalTextures_)
+	{
+		physicalTexture.lastPass = -1;
+	}
+
+	const auto passCount = static_cast<int32_t>(passes_.size());
+
+	for (int32_t i = 0; i < passCount; i++)
+	{
+		for (auto& resource : resources_)
+		{
+			if (!resource.isTransient || resource.firstPass != i)
+			{
+				continue;
+			}
+
+			auto it = std::find_if(physicalTextures_.begin(), physicalTextures_.end(), [&](const PhysicalTexture& p) -> bool {
+				return p.lastPass < i && IsSameTextureParameter(p.parameter, resource.parameter);
+			});
+
+			if (it == physicalTextures_.end())
+			{
+				PhysicalTexture physicalTexture;
+				physicalTexture.texture = graphics_->CreateTexture(resource.parameter);
+				physicalTexture.parameter = resource.parameter;
+				if (physicalTexture.texture == nullptr)
+				{
+					Log(LogType::Error, "FrameGraph : Failed to create a transient texture.");
+					return false;
+				}
+
+				physicalTextures_.emplace_back(physicalTexture);
+				it = physicalTextures_.end() - 1;
+			}
+
+			// outputs are kept until the end of the graph
+			it->lastPass = resource.isOutput ? passCount : resource.lastPass;
+			it->unusedFrameCount = 0;
+			resource.texture = it->texture;
+		}
+	}
+
+	// textures which are not used are released after frames which may use them are completed
+	for (auto& physicalTexture : physicalTextures_)
+	{
+		if (physicalTexture.lastPass >= 0)
+		{
+			continue;
+		}
+
+		physicalTexture.unusedFrameCount++;
+		if (physicalTexture.unusedFrameCount > swapBufferCount_)
+		{
+			SafeRelease(physicalTexture.texture);
+		}
+	}
+
+	physicalTextures_.erase(std::remove_if(physicalTextures_.begin(),
+										   physicalTextures_.end(),
+										   [](const PhysicalTexture& p) -> bool { return p.texture == nullptr; }),
+							physicalTextures_.end());
+
+	return true;
+}
+
+bool FrameGraph::Compile()
+{
+	for (auto& resource : resources_)
+	{
+		resource.firstPass = -1;
+		resource.lastPass = -1;
+
+		if (resource.isTransient)
+		{
+			resource.texture = nullptr;
+		}
+	}
+
+	// render targets are loaded if they are not cleared
+	for (auto& pass : passes_)
+	{
+		if (!pass.isColorCleared)
+		{
+			for (auto rt : pass.renderTargets)
+			{
+				if (rt >= 0)
+				{
+					AddUniqueIndex(pass.reads, rt);
+				}
+			}
+		}
+
+		if (!pass.isDepthCleared && pass.depthTarget >= 0)
+		{
+			AddUniqueIndex(pass.reads, pass.depthTarget);
+		}
+	}
+
+	Cull();
+
+	stats_ = FrameGraphStats();
+	stats_.PassCount = static_cast<int32_t>(passes_.size());
+
+	std::vector<bool> isWritten(resources_.size());
+
+	for (int32_t i = 0; i < static_cast<int32_t>(passes_.size()); i++)
+	{
+		const auto& pass = passes_[i];
+		if (pass.isCulled)
+		{
+			stats_.CulledPassCount++;
+			continue;
+		}
+
+		if (pass.type == FrameGraphPassType::Render && pass.renderPass == nullptr)
+		{
+			const auto hasHole = std::find(pass.renderTargets.begin(), pass.renderTargets.end(), -1) != pass.renderTargets.end();
+			if (pass.renderTargets.empty() || hasHole)
+			{
+				Log(LogType::Error, "FrameGraph : Render targets of " + pass.name + " are not specified continuously from 0.");
+				return false;
+			}
+		}
+
+		for (auto r : pass.reads)
+		{
+			if (resources_[r].isTransient && !isWritten[r])
+			{
+				Log(LogType::Error, "FrameGraph : " + pass.name + " reads a transient texture before it is written.");
+				return false;
+			}
+		}
+
+		for (auto w : pass.writes)
+		{
+			isWritten[w] = true;
+		}
+
+		// lifetimes of transient textures
+		for (const auto* indexes : {&pass.reads, &pass.writes})
+		{
+			for (auto index : *indexes)
+			{
+				auto& resource = resources_[index];
+				if (resource.firstPass < 0)
+				{
+					resource.firstPass = i;
+				}
+				resource.lastPass = std::max(resource.lastPass, i);
+			}
+		}
+	}
+
+	for (const auto& resource : resources_)
+	{
+		if (resource.isTransient && resource.firstPass >= 0)
+		{
+			stats_.TransientTextureCount++;
+		}
+	}
+
+	if (!AllocateTransientTextures())
+	{
+		return false;
+	}
+
+	stats_.PhysicalTextureCount = static_cast<int32_t>(physicalTextures_.size());
+
+	isCompiled_ = true;
+	return true;
+}
+
+RenderPass* FrameGraph::GetRenderPass(const Pass& pass)
+{
+	std::vector<Texture*> renderTargets;
+	for (auto rt : pass.renderTargets)
+	{
+		renderTargets.emplace_back(resources_[rt].texture);
+	}
+
+	Texture* depthTarget = pass.depthTarget >= 0 ? resources_[pass.depthTarget].texture : nullptr;
+
+	for (auto& cached : renderPasses_)
+	{
+		if (cached.renderTargets == renderTargets && cached.depthTarget == depthTarget)
+		{
+			cached.isUsed = true;
+			return cached.renderPass;
+		}
+	}
+
+	CachedRenderPass cached;
+	cached.renderTargets = renderTargets;
+	cached.depthTarget = depthTarget;
+	cached.renderPass = graphics_->CreateRenderPass(renderTargets.data(), static_cast<int32_t>(renderTargets.size()), depthTarget);
+	cached.isUsed = true;
+	if (cached.renderPass == nullptr)
+	{
+		return nullptr;
+	}
+
+	renderPasses_.emplace_back(cached);
+	return cached.renderPass;
+}
+
+void FrameGraph::Execute(CommandList* commandList)
+{
+	if (!isCompiled_)
+	{
+		Log(LogType::Error, "FrameGraph::Execute : Compile must be called before Execute.");
+		return;
+	}
+
+	FrameGraphPassContext context(this, commandList);
+
+	for (auto& pass : passes_)
+	{
+		if (pass.isCulled)
+		{
+			continue;
+		}
+
+		if (pass.type == FrameGraphPassType::Render)
+		{
+			auto renderPass = pass.renderPass;
+			if (renderPass == nullptr)
+			{
+				renderPass = GetRenderPass(pass);
+				if (renderPass == nullptr)
+				{
+					Log(LogType::Error, "FrameGraph : Failed to create a render pass of " + pass.name);
+					continue;
+				}
+
+				renderPass->SetIsColorCleared(pass.isColorCleared);
+				renderPass->SetClearColor(pass.clearColor);
+				renderPass->SetIsDepthCleared(pass.isDepthCleared);
+			}
+
+			commandList->BeginRenderPass(renderPass);
+			if (pass.execute != nullptr)
+			{
+				pass.execute(context);
+			}
+			commandList->EndRenderPass();
+		}
+		else if (pass.type == FrameGraphPassType::Compute)
+		{
+			commandList->BeginComputePass();
+			if (pass.execute != nullptr)
+			{
+				pass.execute(context);
+			}
+			commandList->EndComputePass();
+		}
+		else
+		{
+			if (pass.execute != nullptr)
+			{
+				pass.execute(context);
+			}
+		}
+	}
+}
+
+void FrameGraph::Reset()
+{
+	for (auto& pass : passes_)
+	{
+		SafeRelease(pass.renderPass);
+	}
+	passes_.clear();
+
+	for (auto& resource : resources_)
+	{
+		if (!resource.isTransient)
+		{
+			SafeRelease(resource.texture);
+		}
+		SafeRelease(resource.buffer);
+	}
+	resources_.clear();
+
+	// render passes which are not used refer textures which may not be used anymore,
+	// but they are released after frames which may use them are completed
+	for (auto& renderPass : renderPasses_)
+	{
+		renderPass.unusedFrameCount = renderPass.isUsed ? 0 : renderPass.unusedFrameCount + 1;
+		if (renderPass.unusedFrameCount > swapBufferCount_)
+		{
+			SafeRelease(renderPass.renderPass);
+		}
+		renderPass.isUsed = false;
+	}
+
+	renderPasses_.erase(std::remove_if(renderPasses_.begin(),
+									   renderPasses_.end(),
+									   [](const CachedRenderPass& r) -> bool { return r.renderPass == nullptr; }),
+						renderPasses_.end());
+
+	isCompiled_ = false;
+}
+
+Texture* FrameGraph::GetTexture(FrameGraphResource resource) const
+{
+	if (!IsValidResource(resource))
+	{
+		return nullptr;
+	}
+
+	return resources_[resource.Index].texture;
+}
+
+} // namespace LLGI
@@ -0,0 +1,282 @@
+#pragma once
+
+#include "LLGI.Base.h"
+#include "LLGI.Graphics.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace LLGI
+{
+
+class FrameGraph;
+
+/**
+	@brief	a handle of a texture or a buffer in a frame graph
+	@note
+	It is valid until FrameGraph::Reset is called.
+*/
+struct FrameGraphResource
+{
+	int32_t Index = -1;
+
+	bool GetIsValid() const { return Index >= 0; }
+};
+
+enum class FrameGraphPassType
+{
+	//! a pass which draws into render targets in a render pass
+	Render,
+
+	//! a pass which dispatches compute shaders in a compute pass
+	Compute,
+
+	//! a pass which records copies outside of passes
+	Copy,
+};
+
+/**
+	@brief	an interface to declare resources which a pass reads and writes
+*/
+class FrameGraphPassBuilder
+{
+	friend class FrameGraph;
+
+private:
+	FrameGraph* frameGraph_ = nullptr;
+	int32_t passIndex_ = -1;
+
+	FrameGraphPassBuilder(FrameGraph* frameGraph, int32_t passIndex) : frameGraph_(frameGraph), passIndex_(passIndex) {}
+
+public:
+	/**
+		@brief	create a texture which is available only in the graph
+		@note
+		Its memory may be shared with other transient textures whose lifetimes don't overlap,
+		so contents are undefined until the texture is written in the graph.
+	*/
+	FrameGraphResource CreateTexture(const TextureParameter& parameter);
+
+	//! declare that the pass samples, copies or loads from the resource
+	FrameGraphResource Read(FrameGraphResource resource);
+
+	//! declare that the pass writes the resource as a storage or a copy destination
+	FrameGraphResource Write(FrameGraphResource resource);
+
+	/**
+		@brief	draw into a texture in a render pass
+		@note
+		Previous contents are loaded unless colors are cleared, so the texture is also read in that case.
+	*/
+	void SetRenderTarget(int32_t index, FrameGraphResource texture);
+
+	void SetDepthTarget(FrameGraphResource texture);
+
+	//! clear render targets with the color when the render pass begins
+	void SetClearColor(const Color8& color);
+
+	void SetIsDepthCleared(bool isDepthCleared);
+
+	/**
+		@brief	draw into a render pass which is created outside of the graph (ex. a screen)
+		@note
+		A pass with it is never culled.
+	*/
+	void SetRenderPass(RenderPass* renderPass);
+
+	//! keep the pass even if nothing reads resources which are written by it
+	void SetHasSideEffect();
+};
+
+/**
+	@brief	states which are available while a pass is executed
+*/
+class FrameGraphPassContext
+{
+	friend class FrameGraph;
+
+private:
+	FrameGraph* frameGraph_ = nullptr;
+	CommandList* commandList_ = nullptr;
+
+	FrameGraphPassContext(FrameGraph* frameGraph, CommandList* commandList) : frameGraph_(frameGraph), commandList_(commandList) {}
+
+public:
+	CommandList* GetCommandList() const { return commandList_; }
+
+	//! a texture which is imported or allocated for a transient texture
+	Texture* GetTexture(FrameGraphResource resource) const;
+
+	Buffer* GetBuffer(FrameGraphResource resource) const;
+};
+
+struct FrameGraphStats
+{
+	//! the number of passes which are added
+	int32_t PassCount = 0;
+
+	//! the number of passes which are culled because nothing reads their results
+	int32_t CulledPassCount = 0;
+
+	//! the number of transient textures which are used by passes which are not culled
+	int32_t TransientTextureCount = 0;
+
+	//! the number of textures which are allocated for transient textures
+	int32_t PhysicalTextureCount = 0;
+};
+
+/**
+	@brief	a graph of passes in a frame which are ordered and culled with resources they read and write
+	@note
+	Passes are declared with AddPass every frame and executed in the declared order after Compile.
+	A pass is culled if none of its results is read by a pass which is not culled or remains after the graph.
+	Transient textures whose lifetimes don't overlap share a texture if their parameters are same.
+	Allocated textures and render passes are kept over frames, so nothing is created in a frame which is same as a previous one.
+	Layout transitions between passes are recorded by each backend with states of textures.
+*/
+class FrameGraph
+{
+	friend class FrameGraphPassBuilder;
+	friend class FrameGraphPassContext;
+
+private:
+	struct Resource
+	{
+		//! an imported texture or a texture which is allocated for a transient texture
+		Texture* texture = nullptr;
+		Buffer* buffer = nullptr;
+
+		bool isTransient = false;
+		bool isOutput = false;
+
+		//! a parameter of a transient texture
+		TextureParameter parameter;
+
+		int32_t firstPass = -1;
+		int32_t lastPass = -1;
+	};
+
+	struct Pass
+	{
+		std::string name;
+		FrameGraphPassType type = FrameGraphPassType::Render;
+		std::function<void(FrameGraphPassContext&)> execute;
+
+		std::vector<int32_t> reads;
+		std::vector<int32_t> writes;
+
+		std::vector<int32_t> renderTargets;
+		int32_t depthTarget = -1;
+		bool isColorCleared = false;
+		Color8 clearColor;
+		bool isDepthCleared = false;
+		RenderPass* renderPass = nullptr;
+
+		bool hasSideEffect = false;
+		bool isCulled = false;
+	};
+
+	struct PhysicalTexture
+	{
+		Texture* texture = nullptr;
+		TextureParameter parameter;
+
+		//! the last pass which uses it in the current frame, or -1 if it is not used
+		int32_t lastPass = -1;
+
+		//! the number of frames in which it is not used
+		int32_t unusedFrameCount = 0;
+	};
+
+	struct CachedRenderPass
+	{
+		std::vector<Texture*> renderTargets;
+		Texture* depthTarget = nullptr;
+		RenderPass* renderPass = nullptr;
+		bool isUsed = false;
+
+		//! the number of frames in which it is not used
+		int32_t unusedFrameCount = 0;
+	};
+
+	Graphics* graphics_ = nullptr;
+
+	//! textures and render passes which are not used are kept while previous frames may use them
+	int32_t swapBufferCount_ = 3;
+
+	std::vector<Resource> resources_;
+	std::vector<Pass> passes_;
+	std::vector<PhysicalTexture> physicalTextures_;
+	std::vector<CachedRenderPass> renderPasses_;
+
+	bool isCompiled_ = false;
+	FrameGraphStats stats_;
+
+	FrameGraphResource AddResource(const Resource& resource);
+
+	bool IsValidResource(FrameGraphResource resource) const;
+
+	void Cull();
+
+	bool AllocateTransientTextures();
+
+	RenderPass* GetRenderPass(const Pass& pass);
+
+public:
+	/**
+		@param	swapBufferCount	the number of frames which gpu may execute at the same time
+	*/
+	FrameGraph(Graphics* graphics, int32_t swapBufferCount = 3);
+	~FrameGraph();
+
+	/**
+		@brief	use a texture which is created outside of the graph
+		@note
+		Results written into it remain after the graph, so passes which write it are not culled.
+	*/
+	FrameGraphResource ImportTexture(Texture* texture);
+
+	//! use a buffer which is created outside of the graph
+	FrameGraphResource ImportBuffer(Buffer* buffer);
+
+	/**
+		@brief	add a pass
+		@param	setup	a function which declares resources of the pass. It is called immediately.
+		@param	execute	a function which records commands of the pass. It is called in Execute if the pass is not culled.
+	*/
+	void AddPass(const char* name,
+				 FrameGraphPassType type,
+				 const std::function<void(FrameGraphPassBuilder&)>& setup,
+				 const std::function<void(FrameGraphPassContext&)>& execute);
+
+	//! keep a transient resource after the graph, so passes which write it are not culled
+	void MarkAsOutput(FrameGraphResource resource);
+
+	/**
+		@brief	cull passes and allocate transient textures
+		@return	false if resources are declared incorrectly or textures cannot be created
+	*/
+	bool Compile();
+
+	/**
+		@brief	record passes which are not culled into a command list
+		@note
+		It must be called between Begin and End of the command list and outside of render passes.
+	*/
+	void Execute(CommandList* commandList);
+
+	/**
+		@brief	remove passes and resources to declare a next frame
+		@note
+		Textures of transient textures are kept to be used in the next frame.
+		Textures and render passes which are not used are released after swapBufferCount frames, because previous frames may use them.
+	*/
+	void Reset();
+
+	const FrameGraphStats& GetStats() const { return stats_; }
+
+	//! get a transient texture after Compile. It is valid until a next Compile.
+	Texture* GetTexture(FrameGraphResource resource) const;
+};
+
+} // namespace LLGI
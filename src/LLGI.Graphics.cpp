@@ -1,6 +1,10 @@
 #include "LLGI.Graphics.h"
 #include "LLGI.Buffer.h"
 #include "LLGI.Texture.h"
+#include "Utils/LLGI.Hash.h"
+#include <fstream>
+#include <iterator>
+#include <mutex>
 
 namespace LLGI
 {
@@ -18,7 +22,24 @@ void Log(LogType logType, const std::string& message)
 	}
 }
 
-SingleFrameMemoryPool::SingleFrameMemoryPool(int32_t swapBufferCount) : swapBufferCount_(swapBufferCount)
+//! the minimum size of a page for transient vertices and indices
+static constexpr int32_t TransientPageSize = 1024 * 1024;
+
+//! offsets of transient vertices and indices are aligned with it
+static constexpr int32_t TransientAlignment = 16;
+
+int32_t SingleFrameMemoryPool::TransientPages::GetUsedSize() const
+{
+	int32_t usedSize = offset;
+	for (int32_t i = 0; i < currentPage && i < static_cast<int32_t>(pages.size()); i++)
+	{
+		usedSize += pages[i]->GetSize();
+	}
+	return usedSize;
+}
+
+SingleFrameMemoryPool::SingleFrameMemoryPool(int32_t swapBufferCount, Graphics* graphics)
+	: transientGraphics_(graphics), swapBufferCount_(swapBufferCount)
 {
 
 	for (int i = 0; i < swapBufferCount_; i++)
@@ -26,6 +47,8 @@ SingleFrameMemoryPool::SingleFrameMemoryPool(int32_t swapBufferCount) : swapBuff
 		offsets_.push_back(0);
 		buffers_.push_back(std::vector<Buffer*>());
 	}
+
+	transientPages_.resize(swapBufferCount_);
 }
 
 SingleFrameMemoryPool::~SingleFrameMemoryPool()
@@ -37,6 +60,17 @@ SingleFrameMemoryPool::~SingleFrameMemoryPool()
 			c->Release();
 		}
 	}
+
+	for (auto& transientPages : transientPages_)
+	{
+		for (auto& pages : transientPages)
+		{
+			for (auto page : pages.pages)
+			{
+				page->Release();
+			}
+		}
+	}
 }
 
 void SingleFrameMemoryPool::NewFrame()
@@ -44,6 +78,74 @@ void SingleFrameMemoryPool::NewFrame()
 	currentSwapBuffer_++;
 	currentSwapBuffer_ %= swapBufferCount_;
 	offsets_[currentSwapBuffer_] = 0;
+
+	for (auto& pages : transientPages_[currentSwapBuffer_])
+	{
+		pages.highWaterMark.Push(pages.GetUsedSize());
+
+		// release extra pages which are not needed for the high-water mark
+		const auto requiredPageCount = HighWaterMark::GetRequiredPageCount(pages.pages, pages.highWaterMark.Get(0));
+		for (size_t i = requiredPageCount; i < pages.pages.size(); i++)
+		{
+			pages.pages[i]->Release();
+		}
+		pages.pages.resize(std::min(pages.pages.size(), requiredPageCount));
+
+		pages.currentPage = 0;
+		pages.offset = 0;
+	}
+}
+
+Buffer* SingleFrameMemoryPool::CreateTransientBufferInternal(BufferUsageType usage, int32_t size)
+{
+	if (transientGraphics_ == nullptr)
+	{
+		return nullptr;
+	}
+
+	return transientGraphics_->CreateBuffer(usage | BufferUsageType::MapWrite, size);
+}
+
+bool SingleFrameMemoryPool::AllocateTransientBuffer(BufferUsageType usage, int32_t size, Buffer*& buffer, int32_t& offset)
+{
+	assert(currentSwapBuffer_ >= 0);
+
+	auto& pages = transientPages_[currentSwapBuffer_][usage == BufferUsageType::Vertex ? 0 : 1];
+	const auto alignedSize = (size + TransientAlignment - 1) / TransientAlignment * TransientAlignment;
+
+	// find a page which has a space
+	while (pages.currentPage < static_cast<int32_t>(pages.pages.size()) &&
+		   pages.offset + alignedSize > pages.pages[pages.currentPage]->GetSize())
+	{
+		pages.currentPage++;
+		pages.offset = 0;
+	}
+
+	if (pages.currentPage == static_cast<int32_t>(pages.pages.size()))
+	{
+		auto page = CreateTransientBufferInternal(usage, std::max(TransientPageSize, alignedSize));
+		if (page == nullptr)
+		{
+			return false;
+		}
+
+		pages.pages.push_back(page);
+	}
+
+	buffer = pages.pages[pages.currentPage];
+	offset = pages.offset;
+	pages.offset += alignedSize;
+	return true;
+}
+
+bool SingleFrameMemoryPool::AllocateVertexBuffer(int32_t size, Buffer*& buffer, int32_t& offset)
+{
+	return AllocateTransientBuffer(BufferUsageType::Vertex, size, buffer, offset);
+}
+
+bool SingleFrameMemoryPool::AllocateIndexBuffer(int32_t size, Buffer*& buffer, int32_t& offset)
+{
+	return AllocateTransientBuffer(BufferUsageType::Index, size, buffer, offset);
 }
 
 Buffer* SingleFrameMemoryPool::CreateConstantBuffer(int32_t size)
@@ -78,6 +180,87 @@ Buffer* SingleFrameMemoryPool::CreateConstantBuffer(int32_t size)
 	}
 }
 
+SingleFrameMemoryPoolStats SingleFrameMemoryPool::GetStats() const
+{
+	SingleFrameMemoryPoolStats stats;
+	if (currentSwapBuffer_ >= 0)
+	{
+		stats.ConstantBufferCount = offsets_[currentSwapBuffer_];
+	}
+	return stats;
+}
+
+uint64_t RenderPassPipelineStateKey::GetHash() const
+{
+	uint64_t hash = 0;
+	CombineHash(hash, IsPresent ? 1 : 0);
+	CombineHash(hash, static_cast<uint64_t>(DepthFormat));
+	CombineHash(hash, static_cast<uint64_t>(DepthLoadOp));
+	CombineHash(hash, static_cast<uint64_t>(DepthStoreOp));
+	CombineHash(hash, static_cast<uint64_t>(SamplingCount));
+	CombineHash(hash, HasResolvedRenderTarget ? 1 : 0);
+	CombineHash(hash, HasResolvedDepthTarget ? 1 : 0);
+	CombineHash(hash, TransientRenderTargets);
+	CombineHash(hash, RenderTargetFormats.size());
+
+	for (size_t i = 0; i < RenderTargetFormats.size(); i++)
+	{
+		CombineHash(hash, static_cast<uint64_t>(RenderTargetFormats.at(i)));
+		CombineHash(hash, static_cast<uint64_t>(ColorLoadOps.at(i)));
+		CombineHash(hash, static_cast<uint64_t>(ColorStoreOps.at(i)));
+	}
+
+	return hash;
+}
+
+struct RenderPassPipelineStateKeyTableData
+{
+	std::mutex mutex;
+	std::unordered_map<RenderPassPipelineStateKey, int32_t, RenderPassPipelineStateKey::Hash> ids;
+};
+
+//! it is constructed when it is used first, so keys can be interned while other static objects are constructed
+static RenderPassPipelineStateKeyTableData& GetRenderPassPipelineStateKeyTableData()
+{
+	static RenderPassPipelineStateKeyTableData data;
+	return data;
+}
+
+int32_t RenderPassPipelineStateKeyTable::Intern(const RenderPassPipelineStateKey& key)
+{
+	auto& data = GetRenderPassPipelineStateKeyTableData();
+	std::lock_guard<std::mutex> lock(data.mutex);
+
+	auto it = data.ids.find(key);
+	if (it != data.ids.end())
+	{
+		return it->second;
+	}
+
+	auto id = static_cast<int32_t>(data.ids.size());
+	data.ids[key] = id;
+	return id;
+}
+
+int32_t RenderPassPipelineStateKeyTable::GetCount()
+{
+	auto& data = GetRenderPassPipelineStateKeyTableData();
+	std::lock_guard<std::mutex> lock(data.mutex);
+	return static_cast<int32_t>(data.ids.size());
+}
+
+int32_t RenderPassPipelineState::GetKeyID() const
+{
+	// Key is set after construction, so it is interned lazily. Racing threads store the same id.
+	auto id = keyID_.load();
+	if (id < 0)
+	{
+		id = RenderPassPipelineStateKeyTable::Intern(Key);
+		keyID_.store(id);
+	}
+	return id;
+}
+
 bool RenderPass::assignRenderTextures(Texture** textures, int32_t count)
 {
 	for (int32_t i = 0; i < count; i++)
@@ -106,6 +289,7 @@ bool RenderPass::assignRenderTextures(Texture** textures, int32_t count)
 		renderTextures_.at(i) = textures[i];
 	}
 
+	keyID_ = -1;
 	return true;
 }
 
@@ -120,6 +304,7 @@ bool RenderPass::assignDepthTexture(Texture* depthTexture)
 	SafeAddRef(depthTexture);
 	SafeRelease(depthTexture_);
 	depthTexture_ = depthTexture;
+	keyID_ = -1;
 
 	return true;
 }
@@ -135,6 +320,7 @@ bool RenderPass::assignResolvedRenderTexture(Texture* texture)
 	SafeAddRef(texture);
 	SafeRelease(resolvedRenderTexture_);
 	resolvedRenderTexture_ = texture;
+	keyID_ = -1;
 
 	return true;
 }
@@ -150,6 +336,7 @@ bool RenderPass::assignResolvedDepthTexture(Texture* texture)
 	SafeAddRef(texture);
 	SafeRelease(resolvedDepthTexture_);
 	resolvedDepthTexture_ = texture;
+	keyID_ = -1;
 
 	return true;
 }
@@ -284,6 +471,13 @@ bool RenderPass::sanitize()
 	return true;
 }
 
+RenderPass::RenderPass() : keyID_(-1)
+{
+	colorLoadOps_.fill(AttachmentLoadOp::Load);
+	colorStoreOps_.fill(AttachmentStoreOp::Store);
+	clearColors_.fill(Color8());
+}
+
 RenderPass::~RenderPass()
 {
 	SafeRelease(depthTexture_);
@@ -296,11 +490,49 @@ RenderPass::~RenderPass()
 	}
 }
 
-void RenderPass::SetIsColorCleared(bool isColorCleared) { isColorCleared_ = isColorCleared; }
+void RenderPass::SetIsColorCleared(bool isColorCleared)
+{
+	colorLoadOps_.fill(isColorCleared ? AttachmentLoadOp::Clear : AttachmentLoadOp::Load);
+	keyID_ = -1;
+}
+
+void RenderPass::SetIsDepthCleared(bool isDepthCleared)
+{
+	depthLoadOp_ = isDepthCleared ? AttachmentLoadOp::Clear : AttachmentLoadOp::Load;
+	keyID_ = -1;
+}
+
+void RenderPass::SetClearColor(const Color8& color) { clearColors_.fill(color); }
 
-void RenderPass::SetIsDepthCleared(bool isDepthCleared) { isDepthCleared_ = isDepthCleared; }
+void RenderPass::SetColorLoadOp(int32_t index, AttachmentLoadOp loadOp)
+{
+	colorLoadOps_.at(index) = loadOp;
+	keyID_ = -1;
+}
+
+void RenderPass::SetColorStoreOp(int32_t index, AttachmentStoreOp storeOp)
+{
+	colorStoreOps_.at(index) = storeOp;
+	keyID_ = -1;
+}
+
+void RenderPass::SetClearColor(int32_t index, const Color8& color) { clearColors_.at(index) = color; }
+
+void RenderPass::SetDepthLoadOp(AttachmentLoadOp loadOp)
+{
+	depthLoadOp_ = loadOp;
+	keyID_ = -1;
+}
 
-void RenderPass::SetClearColor(const Color8& color) { color_ = color; }
+void RenderPass::SetDepthStoreOp(AttachmentStoreOp storeOp)
+{
+	depthStoreOp_ = storeOp;
+	keyID_ = -1;
+}
+
+void RenderPass::SetClearDepth(float depth) { clearDepth_ = depth; }
+
+void RenderPass::SetClearStencil(uint32_t stencil) { clearStencil_ = stencil; }
 
 bool RenderPass::GetIsSwapchainScreen() const { return GetRenderTexture(0)->GetType() == TextureType::Screen; }
 
@@ -309,9 +541,9 @@ RenderPassPipelineStateKey RenderPass::GetKey() const
 	RenderPassPipelineStateKey key;
 
 	key.IsPresent = GetIsSwapchainScreen();
-	key.IsColorCleared = GetIsColorCleared();
-	key.IsDepthCleared = GetIsDepthCleared();
 	key.RenderTargetFormats.resize(GetRenderTextureCount());
+	key.ColorLoadOps.resize(GetRenderTextureCount());
+	key.ColorStoreOps.resize(GetRenderTextureCount());
 	key.SamplingCount = renderTextures_.at(0)->GetSamplingCount();
 	key.HasResolvedRenderTarget = GetResolvedRenderTexture() != nullptr;
 	key.HasResolvedDepthTarget = GetResolvedDepthTexture() != nullptr;
@@ -319,11 +551,42 @@ RenderPassPipelineStateKey RenderPass::GetKey() const
 	for (size_t i = 0; i < key.RenderTargetFormats.size(); i++)
 	{
 		key.RenderTargetFormats.at(i) = GetRenderTexture(static_cast<int32_t>(i))->GetFormat();
+		key.ColorLoadOps.at(i) = colorLoadOps_.at(i);
+		key.ColorStoreOps.at(i) = colorStoreOps_.at(i);
+
+		// contents of a transient texture cannot be stored
+		if (BitwiseContains(GetRenderTexture(static_cast<int32_t>(i))->GetUsage(), TextureUsageType::Transient))
+		{
+			key.TransientRenderTargets |= 1u << i;
+
+			if (key.ColorStoreOps.at(i) == AttachmentStoreOp::Store)
+			{
+				key.ColorStoreOps.at(i) = AttachmentStoreOp::Discard;
+			}
+		}
+
+		// a resolved texture is written whenever it is assigned
+		if (key.ColorStoreOps.at(i) != AttachmentStoreOp::Store)
+		{
+			key.ColorStoreOps.at(i) = key.HasResolvedRenderTarget ? AttachmentStoreOp::Resolve : AttachmentStoreOp::Discard;
+		}
 	}
 
 	if (GetHasDepthTexture())
 	{
 		key.DepthFormat = GetDepthTexture()->GetFormat();
+		key.DepthLoadOp = depthLoadOp_;
+		key.DepthStoreOp = depthStoreOp_;
+
+		if (BitwiseContains(GetDepthTexture()->GetUsage(), TextureUsageType::Transient) && key.DepthStoreOp == AttachmentStoreOp::Store)
+		{
+			key.DepthStoreOp = AttachmentStoreOp::Discard;
+		}
+
+		if (key.DepthStoreOp != AttachmentStoreOp::Store)
+		{
+			key.DepthStoreOp = key.HasResolvedDepthTarget ? AttachmentStoreOp::Resolve : AttachmentStoreOp::Discard;
+		}
 	}
 	else
 	{
@@ -333,6 +596,17 @@ RenderPassPipelineStateKey RenderPass::GetKey() const
 	return key;
 }
 
+int32_t RenderPass::GetKeyID() const
+{
+	auto id = keyID_.load();
+	if (id < 0)
+	{
+		id = RenderPassPipelineStateKeyTable::Intern(GetKey());
+		keyID_.store(id);
+	}
+	return id;
+}
+
 Graphics::~Graphics()
 {
 	if (disposed_ != nullptr)
@@ -368,6 +642,42 @@ std::vector<uint8_t> Graphics::CaptureRenderTarget(Texture* renderTarget)
 	return std::vector<uint8_t>();
 }
 
+bool Graphics::SavePipelineCache(const char* path)
+{
+	const auto data = GetPipelineCacheData();
+	if (data.size() == 0)
+	{
+		return false;
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		Log(LogType::Error, std::string("Failed to open a file : ") + path);
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(data.data()), data.size());
+	return static_cast<bool>(file);
+}
+
+bool Graphics::LoadPipelineCache(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (data.size() == 0)
+	{
+		return false;
+	}
+
+	return LoadPipelineCacheData(data.data(), static_cast<int32_t>(data.size()));
+}
+
 void Graphics::SetDisposed(const std::function<void()>& disposed) { disposed_ = disposed; }
 
 } // namespace LLGI
@@ -3,6 +3,8 @@
 
 #include "LLGI.Base.h"
 #include "Utils/LLGI.FixedSizeVector.h"
+#include "Utils/LLGI.HighWaterMark.h"
+#include <atomic>
 #include <functional>
 #include <unordered_map>
 
@@ -32,6 +34,13 @@ struct RenderTextureInitializationParameter
 	Vec2I Size;
 	TextureFormatType Format = TextureFormatType::R8G8B8A8_UNORM;
 	int32_t SamplingCount = 1;
+
+	/**
+		@brief	use contents only in a render pass (ex. a multisampled texture which is resolved)
+		@note
+		Memory is allocated lazily if a device supports it. The texture cannot be sampled, copied or read back.
+	*/
+	bool IsTransient = false;
 };
 
 enum class DepthTextureMode
@@ -45,6 +54,27 @@ struct DepthTextureInitializationParameter
 	Vec2I Size;
 	int32_t SamplingCount = 1;
 	DepthTextureMode Mode = DepthTextureMode::Depth;
+
+	//! use contents only in a render pass. Memory is allocated lazily if a device supports it.
+	bool IsTransient = false;
+};
+
+struct SingleFrameMemoryPoolStats
+{
+	//! the number of constant buffers created in the current frame
+	int32_t ConstantBufferCount = 0;
+
+	//! the size used in the current frame
+	int32_t UsedSize = 0;
+
+	//! the size reserved for the current frame
+	int32_t CapacitySize = 0;
+
+	//! the number of pages reserved for the current frame
+	int32_t PageCount = 0;
+
+	//! the maximum size used in recent frames
+	int32_t HighWaterMark = 0;
 };
 
 /**
@@ -52,6 +82,27 @@ struct DepthTextureInitializationParameter
 */
 class SingleFrameMemoryPool : public ReferenceObject
 {
+private:
+	//! pages which transient vertices or indices are allocated from
+	struct TransientPages
+	{
+		std::vector<Buffer*> pages;
+		int32_t currentPage = 0;
+		int32_t offset = 0;
+		HighWaterMark highWaterMark;
+
+		//! the size used in the current frame, including spaces skipped at the end of pages
+		int32_t GetUsedSize() const;
+	};
+
+	//! a graphics which creates pages for transient vertices and indices
+	Graphics* transientGraphics_ = nullptr;
+
+	//! vertex and index pages for each swap buffer
+	std::vector<std::array<TransientPages, 2>> transientPages_;
+
+	bool AllocateTransientBuffer(BufferUsageType usage, int32_t size, Buffer*& buffer, int32_t& offset);
+
 protected:
 	int32_t currentSwapBuffer_ = -1;
 	int32_t swapBufferCount_ = 0;
@@ -68,8 +119,15 @@ protected:
 	*/
 	virtual Buffer* ReinitializeBuffer(Buffer* cb, int32_t size) { return nullptr; }
 
+	/**
+		@brief	create a page which transient vertices or indices are allocated from
+		@note
+		A page must be able to be locked.
+	*/
+	virtual Buffer* CreateTransientBufferInternal(BufferUsageType usage, int32_t size);
+
 public:
-	SingleFrameMemoryPool(int32_t swapBufferCount = 3);
+	SingleFrameMemoryPool(int32_t swapBufferCount = 3, Graphics* graphics = nullptr);
 	~SingleFrameMemoryPool() override;
 
 	/**
@@ -78,6 +136,29 @@ public:
 	virtual void NewFrame();
 
 	virtual Buffer* CreateConstantBuffer(int32_t size);
+
+	/**
+		@brief	allocate a memory for vertices which is available in the current frame
+		@note
+		Write vertices with Lock(offset, size) and specify buffer and offset with CommandList::SetVertexBuffer.
+		buffer is owned by this pool, so it must not be released.
+	*/
+	bool AllocateVertexBuffer(int32_t size, Buffer*& buffer, int32_t& offset);
+
+	/**
+		@brief	allocate a memory for indices which is available in the current frame
+		@note
+		Write indices with Lock(offset, size) and specify buffer and offset with CommandList::SetIndexBuffer.
+		buffer is owned by this pool, so it must not be released.
+	*/
+	bool AllocateIndexBuffer(int32_t size, Buffer*& buffer, int32_t& offset);
+
+	/**
+		@brief	get a usage of the current frame
+		@note
+		Only ConstantBufferCount is available in some platforms.
+	*/
+	virtual SingleFrameMemoryPoolStats GetStats() const;
 };
 
 struct RenderPassPipelineStateKey
@@ -85,12 +166,17 @@ struct RenderPassPipelineStateKey
 	bool IsPresent = false;
 	TextureFormatType DepthFormat = TextureFormatType::Unknown;
 	FixedSizeVector<TextureFormatType, RenderTargetMax> RenderTargetFormats;
-	bool IsColorCleared = true;
-	bool IsDepthCleared = true;
+	FixedSizeVector<AttachmentLoadOp, RenderTargetMax> ColorLoadOps;
+	FixedSizeVector<AttachmentStoreOp, RenderTargetMax> ColorStoreOps;
+	AttachmentLoadOp DepthLoadOp = AttachmentLoadOp::Clear;
+	AttachmentStoreOp DepthStoreOp = AttachmentStoreOp::Store;
 	bool HasResolvedRenderTarget = false;
 	bool HasResolvedDepthTarget = false;
 	int32_t SamplingCount = 1;
 
+	//! bits of render targets whose contents are discarded after a render pass
+	uint32_t TransientRenderTargets = 0;
+
 	bool operator==(const RenderPassPipelineStateKey& value) const
 	{
 		if (RenderTargetFormats.size() != value.RenderTargetFormats.size())
@@ -100,53 +186,70 @@ struct RenderPassPipelineStateKey
 		{
 			if (RenderTargetFormats.at(i) != value.RenderTargetFormats.at(i))
 				return false;
+
+			if (ColorLoadOps.at(i) != value.ColorLoadOps.at(i) || ColorStoreOps.at(i) != value.ColorStoreOps.at(i))
+				return false;
 		}
 
-		return (IsPresent == value.IsPresent && DepthFormat == value.DepthFormat && IsColorCleared == value.IsColorCleared &&
-				IsDepthCleared == value.IsDepthCleared && SamplingCount == value.SamplingCount &&
-				HasResolvedRenderTarget == value.HasResolvedRenderTarget && HasResolvedDepthTarget == value.HasResolvedDepthTarget);
+		return (IsPresent == value.IsPresent && DepthFormat == value.DepthFormat && DepthLoadOp == value.DepthLoadOp &&
+				DepthStoreOp == value.DepthStoreOp && SamplingCount == value.SamplingCount &&
+				HasResolvedRenderTarget == value.HasResolvedRenderTarget && HasResolvedDepthTarget == value.HasResolvedDepthTarget &&
+				TransientRenderTargets == value.TransientRenderTargets);
 	}
 
 	bool operator!=(const RenderPassPipelineStateKey& value) const { return !(*this == value); }
 
+	/**
+		@brief	a hash of all fields
+		@note
+		Fields are mixed in order, so keys whose formats are permuted have different hashes.
+	*/
+	uint64_t GetHash() const;
+
 	struct Hash
 	{
 		typedef std::size_t result_type;
 
-		std::size_t operator()(const RenderPassPipelineStateKey& key) const
-		{
-			auto ret = std::hash<bool>()(key.IsPresent);
-			ret += std::hash<TextureFormatType>()(key.DepthFormat);
-			ret += std::hash<bool>()(key.IsColorCleared);
-			ret += std::hash<bool>()(key.IsDepthCleared);
-			ret += std::hash<int32_t>()(key.SamplingCount);
-			ret += std::hash<bool>()(key.HasResolvedRenderTarget);
-			ret += std::hash<bool>()(key.HasResolvedDepthTarget);
-
-			for (size_t i = 0; i < key.RenderTargetFormats.size(); i++)
-			{
-				ret += std::hash<uint64_t>()(static_cast<uint64_t>(key.RenderTargetFormats.at(i)));
-			}
-
-			return ret;
-		}
+		std::size_t operator()(const RenderPassPipelineStateKey& key) const { return static_cast<std::size_t>(key.GetHash()); }
 	};
 };
 
+/**
+	@brief	a global table which assigns a small id to each different key
+	@note
+	An id is never reused while a process runs, so keys are same if and only if their ids are same.
+	It is thread safe.
+*/
+class RenderPassPipelineStateKeyTable
+{
+public:
+	//! get an id of the key, which is added to the table if it is not found
+	static int32_t Intern(const RenderPassPipelineStateKey& key);
+
+	//! get the number of keys in the table
+	static int32_t GetCount();
+};
+
 class RenderPass : public ReferenceObject
 {
 private:
-	bool isColorCleared_ = false;
+	std::array<AttachmentLoadOp, RenderTargetMax> colorLoadOps_;
+	std::array<AttachmentStoreOp, RenderTargetMax> colorStoreOps_;
+	std::array<Color8, RenderTargetMax> clearColors_;
 
-	bool isDepthCleared_ = false;
-
-	Color8 color_;
+	AttachmentLoadOp depthLoadOp_ = AttachmentLoadOp::Load;
+	AttachmentStoreOp depthStoreOp_ = AttachmentStoreOp::Store;
+	float clearDepth_ = 1.0f;
+	uint32_t clearStencil_ = 0;
 
 	FixedSizeVector<Texture*, RenderTargetMax> renderTextures_;
 	Texture* depthTexture_ = nullptr;
 	Texture* resolvedRenderTexture_ = nullptr;
 	Texture* resolvedDepthTexture_ = nullptr;
 
+	//! an interned id of GetKey, or -1 if it is not interned after attachments or operations are changed
+	mutable std::atomic<int32_t> keyID_;
+
 protected:
 	Vec2I screenSize_;
 
@@ -164,21 +267,71 @@ protected:
 	bool sanitize();
 
 public:
-	RenderPass() = default;
+	RenderPass();
 	~RenderPass() override;
 
-	virtual bool GetIsColorCleared() const { return isColorCleared_; }
+	//! whether is the first render target cleared
+	virtual bool GetIsColorCleared() const { return colorLoadOps_.at(0) == AttachmentLoadOp::Clear; }
 
-	virtual bool GetIsDepthCleared() const { return isDepthCleared_; }
+	virtual bool GetIsDepthCleared() const { return depthLoadOp_ == AttachmentLoadOp::Clear; }
 
-	virtual Color8 GetClearColor() const { return color_; }
+	//! get a clear color of the first render target
+	virtual Color8 GetClearColor() const { return clearColors_.at(0); }
 
+	//! clear all render targets, or load their previous contents
 	virtual void SetIsColorCleared(bool isColorCleared);
 
+	//! clear a depth and a stencil, or load their previous contents
 	virtual void SetIsDepthCleared(bool isDepthCleared);
 
+	//! set a clear color of all render targets
 	virtual void SetClearColor(const Color8& color);
 
+	AttachmentLoadOp GetColorLoadOp(int32_t index) const { return colorLoadOps_.at(index); }
+
+	AttachmentStoreOp GetColorStoreOp(int32_t index) const { return colorStoreOps_.at(index); }
+
+	Color8 GetClearColor(int32_t index) const { return clearColors_.at(index); }
+
+	//! an action for a depth and a stencil
+	AttachmentLoadOp GetDepthLoadOp() const { return depthLoadOp_; }
+
+	//! an action for a depth and a stencil
+	AttachmentStoreOp GetDepthStoreOp() const { return depthStoreOp_; }
+
+	float GetClearDepth() const { return clearDepth_; }
+
+	uint32_t GetClearStencil() const { return clearStencil_; }
+
+	/**
+		@brief	set how previous contents of a render target are treated when the render pass begins
+		@note
+		DontCare saves bandwidth if all pixels are overwritten in the render pass.
+	*/
+	virtual void SetColorLoadOp(int32_t index, AttachmentLoadOp loadOp);
+
+	/**
+		@brief	set how contents of a render target are treated when the render pass ends
+		@note
+		Discard saves bandwidth if nothing reads the render target after the render pass.
+	*/
+	virtual void SetColorStoreOp(int32_t index, AttachmentStoreOp storeOp);
+
+	void SetClearColor(int32_t index, const Color8& color);
+
+	virtual void SetDepthLoadOp(AttachmentLoadOp loadOp);
+
+	/**
+		@brief	set how a depth and a stencil are treated when the render pass ends
+		@note
+		Discard saves bandwidth if the depth is used only in the render pass.
+	*/
+	virtual void SetDepthStoreOp(AttachmentStoreOp storeOp);
+
+	void SetClearDepth(float depth);
+
+	void SetClearStencil(uint32_t stencil);
+
 	virtual Texture* GetRenderTexture(int index) const { return renderTextures_.at(index); }
 
 	virtual int GetRenderTextureCount() const { return static_cast<int32_t>(renderTextures_.size()); }
@@ -196,6 +349,13 @@ public:
 	virtual Vec2I GetScreenSize() const { return screenSize_; }
 
 	RenderPassPipelineStateKey GetKey() const;
+
+	/**
+		@brief	get an interned id of GetKey
+		@note
+		It is cached until attachments or operations are changed, so it is cheap to compare states in a draw.
+	*/
+	int32_t GetKeyID() const;
 };
 
 /**
@@ -204,10 +364,15 @@ public:
 class RenderPassPipelineState : public ReferenceObject
 {
 private:
+	mutable std::atomic<int32_t> keyID_;
+
 public:
-	RenderPassPipelineState() = default;
+	RenderPassPipelineState() : keyID_(-1) {}
 	~RenderPassPipelineState() override = default;
 	RenderPassPipelineStateKey Key;
+
+	//! get an interned id of Key, which is interned when it is called first
+	int32_t GetKeyID() const;
 };
 
 /**
@@ -255,6 +420,14 @@ public:
 	*/
 	virtual CommandList* CreateCommandList(SingleFrameMemoryPool* memoryPool);
 
+	/**
+		@brief	create a command list which records commands in a render pass of another command list on a worker thread
+		@param memoryPool a memory pool which is used only by this command list's thread
+		@note
+		It returns null if the platform doesn't support it. See CommandList::ExecuteSubCommandLists.
+	*/
+	virtual CommandList* CreateSubCommandList(SingleFrameMemoryPool* memoryPool) { return nullptr; }
+
 	virtual RenderPass* CreateRenderPass(Texture** textures, int32_t textureCount, Texture* depthTexture) { return nullptr; }
 
 	virtual RenderPass* CreateRenderPass(Texture* texture, Texture* resolvedTexture, Texture* depthTexture, Texture* resolvedDepthTexture)
@@ -307,6 +480,32 @@ public:
 	*/
 	virtual uint64_t TimestampToMicroseconds(uint64_t timestamp) const { return 0; }
 
+	/**
+		@brief	get data of a cache which pipeline states are compiled with
+		@note
+		The data can be loaded with LoadPipelineCacheData in next time to reduce a time to compile pipeline states.
+		It returns empty data if it is not supported.
+	*/
+	virtual std::vector<uint8_t> GetPipelineCacheData() { return std::vector<uint8_t>(); }
+
+	/**
+		@brief	merge data of a cache which is got with GetPipelineCacheData into a pipeline cache
+		@note
+		It returns false if the data is created with another device or driver.
+		Call it before compiling pipeline states.
+	*/
+	virtual bool LoadPipelineCacheData(const void* data, int32_t size) { return false; }
+
+	/**
+		@brief	save data of a pipeline cache into a file
+	*/
+	bool SavePipelineCache(const char* path);
+
+	/**
+		@brief	load data of a pipeline cache from a file which is saved with SavePipelineCache
+	*/
+	bool LoadPipelineCache(const char* path);
+
 	/**
 		@brief	specify a function which is called when this instance is disposed.
 		@param	disposed	called function
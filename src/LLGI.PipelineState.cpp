@@ -19,4 +19,25 @@ void PipelineState::SetRenderPassPipelineState(RenderPassPipelineState* renderPa
 
 bool PipelineState::Compile() { return false; }
 
+std::shared_future<bool> PipelineState::CompileAsync()
+{
+	std::promise<bool> promise;
+	promise.set_value(Compile());
+	compileTask_ = promise.get_future().share();
+	return compileTask_;
+}
+
+bool PipelineState::GetIsCompiling() const
+{
+	return compileTask_.valid() && compileTask_.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+void PipelineState::WaitUntilCompiled() const
+{
+	if (compileTask_.valid())
+	{
+		compileTask_.wait();
+	}
+}
+
 } // namespace LLGI
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "LLGI.Base.h"
+#include <future>
 
 namespace LLGI
 {
@@ -10,6 +11,7 @@ class PipelineState : public ReferenceObject
 {
 protected:
 	std::shared_ptr<RenderPassPipelineState> renderPassPipelineState_ = nullptr;
+	std::shared_future<bool> compileTask_;
 
 public:
 	PipelineState();
@@ -58,6 +60,24 @@ public:
 	virtual void SetRenderPassPipelineState(RenderPassPipelineState* renderPassPipelineState);
 
 	virtual bool Compile();
+
+	/**
+		@brief	compile this pipeline state on a worker thread
+		@note
+		Parameters and shaders must not be changed until the returned future is ready.
+		It is compiled on the calling thread if a platform doesn't support it.
+	*/
+	virtual std::shared_future<bool> CompileAsync();
+
+	/**
+		@brief	whether this pipeline state is being compiled with CompileAsync
+	*/
+	bool GetIsCompiling() const;
+
+	/**
+		@brief	wait until compiling with CompileAsync is completed
+	*/
+	void WaitUntilCompiled() const;
 };
 
 } // namespace LLGI
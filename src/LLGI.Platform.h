@@ -14,6 +14,24 @@ struct PlatformParameter
 {
 	DeviceType Device = DeviceType::Default;
 	bool WaitVSync = true;
+
+	/**
+		@brief	render into offscreen screens without a window, a surface and a swapchain
+		@note
+		Only Vulkan supports it now. A window passed into CreatePlatform is ignored.
+	*/
+	bool IsHeadless = false;
+
+	//! the size of offscreen screens when IsHeadless is true or a window is not specified with DeviceType::Null
+	Vec2I HeadlessScreenSize = Vec2I(1280, 720);
+
+	/**
+		@brief	the maximum number of frames which cpu records while gpu executes previous frames
+		@note
+		Only Vulkan uses it now.
+		It is clamped to the number of swap buffers because resources for each swap buffer are reused after them.
+	*/
+	int32_t MaxFramesInFlight = 2;
 };
 
 Window* CreateWindow(const char* title, Vec2I windowSize);
@@ -51,6 +69,7 @@ public:
 		@note
 		Don't release and addref it.
 		Don't use it for the many purposes, please input Clear or SetRenderPass immediately.
+		A depth of a screen is discarded when the render pass ends.
 	*/
 	virtual RenderPass* GetCurrentScreen(const Color8& clearColor = Color8(), bool isColorCleared = false, bool isDepthCleared = false);
 };
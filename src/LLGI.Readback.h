@@ -0,0 +1,47 @@
+#pragma once
+
+#include "LLGI.Base.h"
+
+namespace LLGI
+{
+
+/**
+	@brief	a ticket of a copy from gpu to cpu which is recorded into a command list
+	@note
+	It is created with CommandList::ReadbackTexture or CommandList::ReadbackBuffer.
+	The copy is completed after the command list is executed and its commands are completed.
+	So it can be polled while rendering continues instead of waiting for the whole queue.
+*/
+class Readback : public ReferenceObject
+{
+protected:
+	int32_t size_ = 0;
+
+public:
+	Readback() = default;
+	~Readback() override = default;
+
+	//! the size of copied data
+	int32_t GetSize() const { return size_; }
+
+	/**
+		@brief	whether the copy is completed
+	*/
+	virtual bool GetIsCompleted() { return false; }
+
+	/**
+		@brief	wait until the copy is completed
+		@note
+		A command list which records the copy must be executed before it.
+	*/
+	virtual bool Wait() { return false; }
+
+	/**
+		@brief	get copied data
+		@note
+		It waits until the copy is completed.
+	*/
+	virtual bool GetData(std::vector<uint8_t>& data) { return false; }
+};
+
+} // namespace LLGI
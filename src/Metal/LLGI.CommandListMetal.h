@@ -26,9 +26,6 @@ class CommandListMetal : public CommandList
 {
 	GraphicsMetal* graphics_ = nullptr;
 
-	MTLSamplerDescriptor* samplers_[3][2][3];
-	id<MTLSamplerState> samplerStates_[3][2][3];
-
 	id<MTLCommandBuffer> commandBuffer_ = nullptr;
 	id<MTLRenderCommandEncoder> renderEncoder_ = nullptr;
 	id<MTLComputeCommandEncoder> computeEncoder_ = nullptr;
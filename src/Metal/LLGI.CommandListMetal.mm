@@ -19,40 +19,6 @@ CommandListMetal::CommandListMetal(Graphics* graphics)
 	SafeAddRef(g);
 	graphics_ = g;
 
-	// Sampler
-	for (int w = 0; w < 3; w++)
-	{
-		for (int f = 0; f < 2; f++)
-		{
-			for (int m = 0; m < 3; m++)
-			{
-				MTLSamplerAddressMode ws[3];
-				ws[0] = MTLSamplerAddressModeClampToEdge;
-				ws[1] = MTLSamplerAddressModeRepeat;
-				ws[2] = MTLSamplerAddressModeMirrorRepeat;
-
-				MTLSamplerMinMagFilter fsmin[2];
-				fsmin[0] = MTLSamplerMinMagFilterNearest;
-				fsmin[1] = MTLSamplerMinMagFilterLinear;
-
-				MTLSamplerMipFilter msmip[3];
-				msmip[0] = MTLSamplerMipFilterNotMipmapped;
-				msmip[1] = MTLSamplerMipFilterLinear;
-				msmip[2] = MTLSamplerMipFilterNearest;
-
-				MTLSamplerDescriptor* samplerDescriptor = [MTLSamplerDescriptor new];
-				samplerDescriptor.minFilter = fsmin[f];
-				samplerDescriptor.magFilter = fsmin[f];
-				samplerDescriptor.mipFilter = msmip[m];
-				samplerDescriptor.sAddressMode = ws[w];
-				samplerDescriptor.tAddressMode = ws[w];
-
-				samplers_[w][f][m] = samplerDescriptor;
-				samplerStates_[w][f][m] = [g->GetDevice() newSamplerStateWithDescriptor:samplerDescriptor];
-			}
-		}
-	}
-
 	fence_ = [g->GetDevice() newFence];
 }
 
@@ -70,18 +36,6 @@ CommandListMetal::~CommandListMetal()
 
 	WaitUntilCompleted();
 
-	for (int w = 0; w < 3; w++)
-	{
-		for (int f = 0; f < 2; f++)
-		{
-			for (int m = 0; m < 3; m++)
-			{
-				[samplers_[w][f][m] release];
-				[samplerStates_[w][f][m] release];
-			}
-		}
-	}
-
 	if (commandBuffer_ != nullptr)
 	{
 		[commandBuffer_ release];
@@ -142,8 +96,6 @@ void CommandListMetal::Draw(int32_t primitiveCount, int32_t instanceCount)
 	BindingIndexBuffer bib;
 	PipelineState* bpip = nullptr;
 
-	const int mipmapFilter = 1;
-
 	bool isVBDirtied = false;
 	bool isIBDirtied = false;
 	bool isPipDirtied = false;
@@ -199,18 +151,17 @@ void CommandListMetal::Draw(int32_t primitiveCount, int32_t instanceCount)
             continue;
 
         auto texture = (TextureMetal*)currentTextures_[unit_ind].texture;
-        auto wm = (int32_t)currentTextures_[unit_ind].wrapMode;
-        auto mm = (int32_t)currentTextures_[unit_ind].minMagFilter;
-        auto pm = 0;
-        if (texture->GetTexture().mipmapLevelCount >= 2)
+        auto sampler = currentTextures_[unit_ind].sampler;
+        if (texture->GetTexture().mipmapLevelCount < 2)
         {
-            pm = mipmapFilter;
+            sampler.MipFilter = TextureMipFilter::None;
         }
+        auto samplerState = graphics_->GetSamplerState(sampler);
         
         [renderEncoder_ setVertexTexture:texture->GetTexture() atIndex:unit_ind];
-        [renderEncoder_ setVertexSamplerState:samplerStates_[wm][mm][pm] atIndex:unit_ind];
+        [renderEncoder_ setVertexSamplerState:samplerState atIndex:unit_ind];
         [renderEncoder_ setFragmentTexture:texture->GetTexture() atIndex:unit_ind];
-        [renderEncoder_ setFragmentSamplerState:samplerStates_[wm][mm][pm] atIndex:unit_ind];
+        [renderEncoder_ setFragmentSamplerState:samplerState atIndex:unit_ind];
     }
 	
     const int compute_offset = 10;
@@ -330,6 +281,30 @@ void CommandListMetal::GenerateMipMap(Texture* src)
 	[blitEncoder endEncoding];
 }
 
+static MTLLoadAction ConvertLoadAction(AttachmentLoadOp loadOp)
+{
+	switch (loadOp)
+	{
+	case AttachmentLoadOp::Load:
+		return MTLLoadActionLoad;
+	case AttachmentLoadOp::Clear:
+		return MTLLoadActionClear;
+	default:
+		return MTLLoadActionDontCare;
+	}
+}
+
+static MTLStoreAction ConvertStoreAction(AttachmentStoreOp storeOp, bool hasResolvedTexture)
+{
+	// multisampled contents are resolved whenever a resolved texture is assigned
+	if (storeOp == AttachmentStoreOp::Store)
+	{
+		return hasResolvedTexture ? MTLStoreActionStoreAndMultisampleResolve : MTLStoreActionStore;
+	}
+
+	return hasResolvedTexture ? MTLStoreActionMultisampleResolve : MTLStoreActionDontCare;
+}
+
 void CommandListMetal::BeginRenderPass(RenderPass* renderPass)
 {
 	@autoreleasepool
@@ -339,41 +314,26 @@ void CommandListMetal::BeginRenderPass(RenderPass* renderPass)
 
 		for (size_t i = 0; i < rp->pixelFormats.size(); i++)
 		{
-			if (rp->isColorCleared)
-			{
-				auto r_ = rp->clearColor.R / 255.0;
-				auto g_ = rp->clearColor.G / 255.0;
-				auto b_ = rp->clearColor.B / 255.0;
-				auto a_ = rp->clearColor.A / 255.0;
-
-				rpd.colorAttachments[i].loadAction = MTLLoadActionClear;
-				rpd.colorAttachments[i].clearColor = MTLClearColorMake(r_, g_, b_, a_);
-			}
-			else
-			{
-				rpd.colorAttachments[i].loadAction = MTLLoadActionDontCare;
-			}
+			const auto index = static_cast<int32_t>(i);
+			const auto color = rp->GetClearColor(index);
+			rpd.colorAttachments[i].loadAction = ConvertLoadAction(rp->GetColorLoadOp(index));
+			rpd.colorAttachments[i].clearColor = MTLClearColorMake(color.R / 255.0, color.G / 255.0, color.B / 255.0, color.A / 255.0);
+			rpd.colorAttachments[i].storeAction =
+				ConvertStoreAction(rp->GetColorStoreOp(index), rpd.colorAttachments[i].resolveTexture != nil);
 		}
 
-		if (rp->isDepthCleared)
+		if (rpd.depthAttachment.texture != nil)
 		{
-			rpd.depthAttachment.loadAction = MTLLoadActionClear;
-			rpd.depthAttachment.clearDepth = 1.0;
-
-			if (rp->depthStencilFormat != MTLPixelFormatDepth32Float_Stencil8
-#if !(TARGET_OS_IPHONE) && !(TARGET_OS_SIMULATOR)
-				&& rp->depthStencilFormat != MTLPixelFormatDepth24Unorm_Stencil8
-#endif
-			)
-			{
-				rpd.stencilAttachment.loadAction = MTLLoadActionClear;
-				rpd.stencilAttachment.clearStencil = 0;
-			}
+			rpd.depthAttachment.loadAction = ConvertLoadAction(rp->GetDepthLoadOp());
+			rpd.depthAttachment.clearDepth = rp->GetClearDepth();
+			rpd.depthAttachment.storeAction = ConvertStoreAction(rp->GetDepthStoreOp(), rpd.depthAttachment.resolveTexture != nil);
 		}
-		else
+
+		if (rpd.stencilAttachment.texture != nil)
 		{
-			rpd.depthAttachment.loadAction = MTLLoadActionDontCare;
-			rpd.stencilAttachment.loadAction = MTLLoadActionDontCare;
+			rpd.stencilAttachment.loadAction = ConvertLoadAction(rp->GetDepthLoadOp());
+			rpd.stencilAttachment.clearStencil = rp->GetClearStencil();
+			rpd.stencilAttachment.storeAction = ConvertStoreAction(rp->GetDepthStoreOp(), rpd.stencilAttachment.resolveTexture != nil);
 		}
 
 		renderEncoder_ = [commandBuffer_ renderCommandEncoderWithDescriptor:rpd];
@@ -487,8 +447,6 @@ bool CommandListMetal::EndComputePassWithPlatformPtr()
 
 void CommandListMetal::Dispatch(int32_t groupX, int32_t groupY, int32_t groupZ, int32_t threadX, int32_t threadY, int32_t threadZ)
 {
-    const int mipmapFilter = 1;
-
 	PipelineState* bpip = nullptr;
 
 	bool isPipDirtied = false;
@@ -519,16 +477,15 @@ void CommandListMetal::Dispatch(int32_t groupX, int32_t groupY, int32_t groupZ,
             continue;
 
         auto texture = (TextureMetal*)currentTextures_[unit_ind].texture;
-        auto wm = (int32_t)currentTextures_[unit_ind].wrapMode;
-        auto mm = (int32_t)currentTextures_[unit_ind].minMagFilter;
-        auto pm = 0;
-        if (texture->GetTexture().mipmapLevelCount >= 2)
+        auto sampler = currentTextures_[unit_ind].sampler;
+        if (texture->GetTexture().mipmapLevelCount < 2)
         {
-            pm = mipmapFilter;
+            sampler.MipFilter = TextureMipFilter::None;
         }
+        auto samplerState = graphics_->GetSamplerState(sampler);
         
         [computeEncoder_ setTexture:texture->GetTexture() atIndex:unit_ind];
-        [computeEncoder_ setSamplerState:samplerStates_[wm][mm][pm] atIndex:unit_ind];
+        [computeEncoder_ setSamplerState:samplerState atIndex:unit_ind];
     }
 
     for (int unit_ind = 0; unit_ind < NumComputeBuffer; unit_ind++)
@@ -4,6 +4,7 @@
 #include "../Utils/LLGI.FixedSizeVector.h"
 #import <MetalKit/MetalKit.h>
 #include <functional>
+#include <mutex>
 #include <unordered_map>
 
 namespace LLGI
@@ -33,6 +34,10 @@ class GraphicsMetal : public Graphics
 	id<MTLCommandQueue> commandQueue_ = nullptr;
 	int maxMultiSamplingCount_ = 0;
 
+	//! samplers which are shared among command lists
+	std::unordered_map<SamplerParameter, id<MTLSamplerState>, SamplerParameter::Hash> samplerStates_;
+	std::mutex samplerStatesMutex_;
+
 public:
 	GraphicsMetal();
 	~GraphicsMetal() override;
@@ -84,6 +89,9 @@ public:
 	id<MTLDevice>& GetDevice();
 
 	id<MTLCommandQueue>& GetCommandQueue();
+
+	//! get a sampler state of the description, which is created if it is not found. It is thread safe.
+	id<MTLSamplerState> GetSamplerState(const SamplerParameter& parameter);
 };
 
 } // namespace LLGI
@@ -11,6 +11,7 @@
 #import <MetalKit/MetalKit.h>
 
 #include <TargetConditionals.h>
+#include <algorithm>
 
 namespace LLGI
 {
@@ -27,6 +28,12 @@ GraphicsMetal::~GraphicsMetal()
 
 	renderPassPipelineStates_.clear();
 
+	for (auto& it : samplerStates_)
+	{
+		[it.second release];
+	}
+	samplerStates_.clear();
+
 	if (commandQueue_ != nullptr)
 	{
 		[commandQueue_ release];
@@ -357,4 +364,115 @@ id<MTLDevice>& GraphicsMetal::GetDevice() { return device_; }
 
 id<MTLCommandQueue>& GraphicsMetal::GetCommandQueue() { return commandQueue_; }
 
+static MTLSamplerAddressMode ConvertAddressMode(TextureWrapMode wrapMode)
+{
+	switch (wrapMode)
+	{
+	case TextureWrapMode::Repeat:
+		return MTLSamplerAddressModeRepeat;
+	case TextureWrapMode::Mirror:
+		return MTLSamplerAddressModeMirrorRepeat;
+	case TextureWrapMode::Border:
+#if !(TARGET_OS_IPHONE) && !(TARGET_OS_SIMULATOR)
+		return MTLSamplerAddressModeClampToBorderColor;
+#else
+		// a border color is not supported in old iOS, so it is always transparent black
+		return MTLSamplerAddressModeClampToZero;
+#endif
+	default:
+		return MTLSamplerAddressModeClampToEdge;
+	}
+}
+
+static MTLSamplerMinMagFilter ConvertMinMagFilter(TextureMinMagFilter filter)
+{
+	return filter == TextureMinMagFilter::Linear ? MTLSamplerMinMagFilterLinear : MTLSamplerMinMagFilterNearest;
+}
+
+static MTLSamplerMipFilter ConvertMipFilter(TextureMipFilter filter)
+{
+	switch (filter)
+	{
+	case TextureMipFilter::Nearest:
+		return MTLSamplerMipFilterNearest;
+	case TextureMipFilter::Linear:
+		return MTLSamplerMipFilterLinear;
+	default:
+		return MTLSamplerMipFilterNotMipmapped;
+	}
+}
+
+static MTLCompareFunction ConvertCompareFunction(CompareFuncType func)
+{
+	switch (func)
+	{
+	case CompareFuncType::Never:
+		return MTLCompareFunctionNever;
+	case CompareFuncType::Less:
+		return MTLCompareFunctionLess;
+	case CompareFuncType::Equal:
+		return MTLCompareFunctionEqual;
+	case CompareFuncType::LessEqual:
+		return MTLCompareFunctionLessEqual;
+	case CompareFuncType::Greater:
+		return MTLCompareFunctionGreater;
+	case CompareFuncType::NotEqual:
+		return MTLCompareFunctionNotEqual;
+	case CompareFuncType::GreaterEqual:
+		return MTLCompareFunctionGreaterEqual;
+	default:
+		return MTLCompareFunctionAlways;
+	}
+}
+
+id<MTLSamplerState> GraphicsMetal::GetSamplerState(const SamplerParameter& parameter)
+{
+	std::lock_guard<std::mutex> lock(samplerStatesMutex_);
+
+	auto it = samplerStates_.find(parameter);
+	if (it != samplerStates_.end())
+	{
+		return it->second;
+	}
+
+	MTLSamplerDescriptor* samplerDescriptor = [MTLSamplerDescriptor new];
+	samplerDescriptor.minFilter = ConvertMinMagFilter(parameter.MinFilter);
+	samplerDescriptor.magFilter = ConvertMinMagFilter(parameter.MagFilter);
+	samplerDescriptor.mipFilter = ConvertMipFilter(parameter.MipFilter);
+	samplerDescriptor.sAddressMode = ConvertAddressMode(parameter.WrapModeU);
+	samplerDescriptor.tAddressMode = ConvertAddressMode(parameter.WrapModeV);
+	samplerDescriptor.rAddressMode = ConvertAddressMode(parameter.WrapModeW);
+	samplerDescriptor.maxAnisotropy = static_cast<NSUInteger>(std::min(std::max(parameter.MaxAnisotropy, 1), 16));
+	samplerDescriptor.lodMinClamp = parameter.MinLod;
+	samplerDescriptor.lodMaxClamp = parameter.MaxLod;
+
+	// MipLodBias is ignored because a lod bias is specified in shaders in Metal
+
+	if (parameter.IsCompareEnabled)
+	{
+		samplerDescriptor.compareFunction = ConvertCompareFunction(parameter.CompareFunc);
+	}
+
+#if !(TARGET_OS_IPHONE) && !(TARGET_OS_SIMULATOR)
+	switch (parameter.BorderColor)
+	{
+	case TextureBorderColor::OpaqueBlack:
+		samplerDescriptor.borderColor = MTLSamplerBorderColorOpaqueBlack;
+		break;
+	case TextureBorderColor::OpaqueWhite:
+		samplerDescriptor.borderColor = MTLSamplerBorderColorOpaqueWhite;
+		break;
+	default:
+		samplerDescriptor.borderColor = MTLSamplerBorderColorTransparentBlack;
+		break;
+	}
+#endif
+
+	auto samplerState = [device_ newSamplerStateWithDescriptor:samplerDescriptor];
+	[samplerDescriptor release];
+
+	samplerStates_[parameter] = samplerState;
+	return samplerState;
+}
+
 }
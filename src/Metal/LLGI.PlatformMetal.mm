@@ -115,6 +115,9 @@ PlatformMetal::PlatformMetal(Window* window, bool waitVSync)
 	for (size_t i = 0; i < ringBuffers_.size(); i++)
 	{
 		ringBuffers_[i].renderPass = CreateSharedPtr(new RenderPassMetal());
+
+		// a depth of a screen is not used after the frame, so it is not written back
+		ringBuffers_[i].renderPass->SetDepthStoreOp(AttachmentStoreOp::Discard);
 		ringBuffers_[i].renderTexture = CreateSharedPtr(new TextureMetal());
 	}
 
@@ -37,17 +37,8 @@ public:
 	bool UpdateRenderTarget(
 		Texture** textures, int32_t textureCount, Texture* depthTexture, Texture* resolvedTexture, Texture* resolvedDepthTexture);
 
-	void SetIsColorCleared(bool isColorCleared) override;
-
-	void SetIsDepthCleared(bool isDepthCleared) override;
-
-	void SetClearColor(const Color8& color) override;
-
 	MTLRenderPassDescriptor* GetRenderPassDescriptor() { return renderPassDescriptor_; }
 
-	Color8 clearColor;
-	bool isColorCleared;
-	bool isDepthCleared;
 	FixedSizeVector<MTLPixelFormat, RenderTargetMax> pixelFormats;
 	MTLPixelFormat depthStencilFormat = MTLPixelFormatInvalid;
 };
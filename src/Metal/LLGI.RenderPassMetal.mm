@@ -29,7 +29,6 @@ void RenderPassMetal::UpdateTarget(TextureMetal** textures,
 		if (resolvedTexture != nullptr)
 		{
 			renderPassDescriptor_.colorAttachments[i].resolveTexture = resolvedTexture->GetTexture();
-			renderPassDescriptor_.colorAttachments[i].storeAction = MTLStoreActionMultisampleResolve;
 		}
 	}
 
@@ -40,7 +39,6 @@ void RenderPassMetal::UpdateTarget(TextureMetal** textures,
 		if (resolvedDepthTexture != nullptr)
 		{
 			renderPassDescriptor_.depthAttachment.resolveTexture = resolvedDepthTexture->GetTexture();
-			renderPassDescriptor_.depthAttachment.storeAction = MTLStoreActionMultisampleResolve;
 		}
 
 		if (HasStencil(ConvertFormat(depthTexture->GetTexture().pixelFormat)))
@@ -50,7 +48,6 @@ void RenderPassMetal::UpdateTarget(TextureMetal** textures,
 			if (resolvedDepthTexture != nullptr)
 			{
 				renderPassDescriptor_.stencilAttachment.resolveTexture = resolvedDepthTexture->GetTexture();
-				renderPassDescriptor_.stencilAttachment.storeAction = MTLStoreActionMultisampleResolve;
 			}
 		}
 
@@ -132,24 +129,6 @@ bool RenderPassMetal::UpdateRenderTarget(
 	return true;
 }
 
-void RenderPassMetal::SetIsColorCleared(bool isColorCleared)
-{
-	this->isColorCleared = isColorCleared;
-	RenderPass::SetIsColorCleared(isColorCleared);
-}
-
-void RenderPassMetal::SetIsDepthCleared(bool isDepthCleared)
-{
-	this->isDepthCleared = isDepthCleared;
-	RenderPass::SetIsDepthCleared(isDepthCleared);
-}
-
-void RenderPassMetal::SetClearColor(const Color8& color)
-{
-	this->clearColor = color;
-	RenderPass::SetClearColor(color);
-}
-
 RenderPassPipelineStateMetal::RenderPassPipelineStateMetal() {}
 
 void RenderPassPipelineStateMetal::SetKey(const RenderPassPipelineStateKey& key)
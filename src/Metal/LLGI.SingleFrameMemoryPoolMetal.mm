@@ -37,7 +37,7 @@ SingleFrameMemoryPoolMetal::SingleFrameMemoryPoolMetal(GraphicsMetal* graphics,
 													   bool isStrongRef,
 													   int32_t constantBufferPoolSize,
 													   int32_t drawingCount)
-	: SingleFrameMemoryPool(3), graphics_(graphics), isStrongRef_(isStrongRef)
+	: SingleFrameMemoryPool(3, graphics), graphics_(graphics), isStrongRef_(isStrongRef)
 {
 	if (isStrongRef)
 	{
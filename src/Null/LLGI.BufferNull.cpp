@@ -0,0 +1,34 @@
+#include "LLGI.BufferNull.h"
+
+namespace LLGI
+{
+
+bool BufferNull::Initialize(BufferUsageType usage, int32_t size)
+{
+	if (!VerifyUsage(usage))
+	{
+		return false;
+	}
+
+	usage_ = usage;
+	data_.resize(size);
+	return true;
+}
+
+void* BufferNull::Lock() { return data_.data(); }
+
+void* BufferNull::Lock(int32_t offset, int32_t size)
+{
+	if (offset < 0 || size < 0 || offset + size > GetSize())
+	{
+		return nullptr;
+	}
+
+	return data_.data() + offset;
+}
+
+void BufferNull::Unlock() {}
+
+int32_t BufferNull::GetSize() { return static_cast<int32_t>(data_.size()); }
+
+} // namespace LLGI
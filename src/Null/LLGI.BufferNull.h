@@ -0,0 +1,26 @@
+#pragma once
+
+#include "../LLGI.Buffer.h"
+
+namespace LLGI
+{
+
+class BufferNull : public Buffer
+{
+private:
+	std::vector<uint8_t> data_;
+
+public:
+	BufferNull() = default;
+	~BufferNull() override = default;
+
+	bool Initialize(BufferUsageType usage, int32_t size);
+
+	void* Lock() override;
+	void* Lock(int32_t offset, int32_t size) override;
+	void Unlock() override;
+
+	int32_t GetSize() override;
+};
+
+} // namespace LLGI
@@ -0,0 +1,226 @@
+#include "LLGI.CommandListNull.h"
+#include "../LLGI.Buffer.h"
+#include "../LLGI.Graphics.h"
+#include "../LLGI.PipelineState.h"
+#include "../LLGI.Texture.h"
+
+namespace LLGI
+{
+
+CommandListNull::CommandListNull(int32_t swapCount, bool isSubCommandList) : CommandList(swapCount), isSubCommandList_(isSubCommandList)
+{
+	commandStreams_.resize(swapCount);
+}
+
+void CommandListNull::Begin()
+{
+	currentSwapBufferIndex_++;
+	currentSwapBufferIndex_ %= commandStreams_.size();
+	GetCurrentStream().Clear();
+
+	CommandList::Begin();
+}
+
+void CommandListNull::End() { CommandList::End(); }
+
+void CommandListNull::SetScissor(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+	GetCurrentStream().Push(CommandTypeNull::SetScissor, CommandScissorNull{x, y, width, height});
+}
+
+void CommandListNull::Draw(int32_t primitiveCount, int32_t instanceCount)
+{
+	if (renderPass_ == nullptr)
+	{
+		Log(LogType::Warning, "Draw must be called in RenderPass.");
+		return;
+	}
+
+	BindingVertexBuffer vb_;
+	BindingIndexBuffer ib_;
+	PipelineState* pip_ = nullptr;
+
+	bool isVBDirtied = false;
+	bool isIBDirtied = false;
+	bool isPipDirtied = false;
+
+	GetCurrentVertexBuffer(vb_, isVBDirtied);
+	GetCurrentIndexBuffer(ib_, isIBDirtied);
+	GetCurrentPipelineState(pip_, isPipDirtied);
+
+	assert(vb_.vertexBuffer != nullptr);
+	assert(ib_.indexBuffer != nullptr);
+	assert(pip_ != nullptr);
+
+	if (pip_->GetRenderPassPipelineState()->GetKeyID() != renderPass_->GetKeyID())
+	{
+		Log(LogType::Warning, "Pipeline states between Pipeline state and render pass is different.");
+		return;
+	}
+
+	auto& stream = GetCurrentStream();
+
+	if (isVBDirtied)
+	{
+		stream.Push(CommandTypeNull::SetVertexBuffer, CommandBufferNull{vb_.vertexBuffer, vb_.stride, vb_.offset, 0});
+	}
+
+	if (isIBDirtied)
+	{
+		stream.Push(CommandTypeNull::SetIndexBuffer, CommandBufferNull{ib_.indexBuffer, ib_.stride, ib_.offset, 0});
+	}
+
+	// resources are bound for each draw like descriptor sets on other platforms
+	for (int32_t unit = 0; unit < NumConstantBuffer; unit++)
+	{
+		if (constantBuffers_[unit] == nullptr)
+			continue;
+
+		stream.Push(CommandTypeNull::SetConstantBuffer, CommandBufferNull{constantBuffers_[unit], 0, 0, unit});
+	}
+
+	for (int32_t unit = 0; unit < NumTexture; unit++)
+	{
+		const auto& texture = currentTextures_[unit];
+		if (texture.texture == nullptr)
+			continue;
+
+		stream.Push(CommandTypeNull::SetTexture, CommandTextureNull{texture.texture, texture.sampler, unit});
+	}
+
+	for (int32_t unit = 0; unit < NumComputeBuffer; unit++)
+	{
+		BindingComputeBuffer cb_;
+		GetCurrentComputeBuffer(unit, cb_);
+		if (cb_.computeBuffer == nullptr)
+			continue;
+
+		stream.Push(CommandTypeNull::SetComputeBuffer, CommandBufferNull{cb_.computeBuffer, cb_.stride, 0, unit});
+	}
+
+	if (isPipDirtied)
+	{
+		stream.Push(CommandTypeNull::SetPipelineState, CommandObjectNull{pip_});
+	}
+
+	stream.Push(CommandTypeNull::Draw, CommandDrawNull{primitiveCount, instanceCount});
+
+	CommandList::Draw(primitiveCount, instanceCount);
+}
+
+void CommandListNull::CopyTexture(Texture* src, Texture* dst)
+{
+	GetCurrentStream().Push(CommandTypeNull::CopyTexture, CommandCopyNull{src, dst});
+
+	RegisterReferencedObject(src);
+	RegisterReferencedObject(dst);
+}
+
+void CommandListNull::CopyTexture(
+	Texture* src, Texture* dst, const Vec3I& srcPos, const Vec3I& dstPos, const Vec3I& size, int srcLayer, int dstLayer)
+{
+	CopyTexture(src, dst);
+}
+
+void CommandListNull::GenerateMipMap(Texture* src)
+{
+	GetCurrentStream().Push(CommandTypeNull::GenerateMipMap, CommandObjectNull{src});
+
+	RegisterReferencedObject(src);
+}
+
+void CommandListNull::CopyBuffer(Buffer* src, Buffer* dst)
+{
+	GetCurrentStream().Push(CommandTypeNull::CopyBuffer, CommandCopyNull{src, dst});
+
+	RegisterReferencedObject(src);
+	RegisterReferencedObject(dst);
+}
+
+void CommandListNull::BeginRenderPass(RenderPass* renderPass)
+{
+	renderPass_ = renderPass;
+
+	// a sub command list continues a render pass of a main command list
+	if (!isSubCommandList_)
+	{
+		GetCurrentStream().Push(CommandTypeNull::BeginRenderPass, CommandObjectNull{renderPass});
+	}
+
+	RegisterReferencedObject(renderPass);
+
+	CommandList::BeginRenderPass(renderPass);
+}
+
+void CommandListNull::EndRenderPass()
+{
+	renderPass_ = nullptr;
+
+	if (!isSubCommandList_)
+	{
+		GetCurrentStream().Push(CommandTypeNull::EndRenderPass);
+	}
+
+	CommandList::EndRenderPass();
+}
+
+void CommandListNull::ExecuteSubCommandLists(CommandList** subCommandLists, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++)
+	{
+		auto subCommandList = static_cast<CommandListNull*>(subCommandLists[i]);
+		if (subCommandList == nullptr || !subCommandList->isSubCommandList_)
+		{
+			Log(LogType::Error, "ExecuteSubCommandLists : It is not a sub command list.");
+			continue;
+		}
+
+		GetCurrentStream().Append(subCommandList->GetCommandStream());
+
+		RegisterReferencedObject(subCommandList);
+	}
+}
+
+void CommandListNull::BeginComputePass() { GetCurrentStream().Push(CommandTypeNull::BeginComputePass); }
+
+void CommandListNull::EndComputePass() { GetCurrentStream().Push(CommandTypeNull::EndComputePass); }
+
+void CommandListNull::Dispatch(int32_t groupX, int32_t groupY, int32_t groupZ, int32_t threadX, int32_t threadY, int32_t threadZ)
+{
+	PipelineState* pip_ = nullptr;
+	bool isPipDirtied = false;
+	GetCurrentPipelineState(pip_, isPipDirtied);
+
+	assert(pip_ != nullptr);
+
+	auto& stream = GetCurrentStream();
+
+	for (int32_t unit = 0; unit < NumConstantBuffer; unit++)
+	{
+		if (constantBuffers_[unit] == nullptr)
+			continue;
+
+		stream.Push(CommandTypeNull::SetConstantBuffer, CommandBufferNull{constantBuffers_[unit], 0, 0, unit});
+	}
+
+	for (int32_t unit = 0; unit < NumComputeBuffer; unit++)
+	{
+		BindingComputeBuffer cb_;
+		GetCurrentComputeBuffer(unit, cb_);
+		if (cb_.computeBuffer == nullptr)
+			continue;
+
+		stream.Push(CommandTypeNull::SetComputeBuffer, CommandBufferNull{cb_.computeBuffer, cb_.stride, 0, unit});
+	}
+
+	if (isPipDirtied)
+	{
+		stream.Push(CommandTypeNull::SetPipelineState, CommandObjectNull{pip_});
+	}
+
+	stream.Push(CommandTypeNull::Dispatch, CommandDispatchNull{groupX, groupY, groupZ, threadX, threadY, threadZ});
+
+	CommandList::Dispatch(groupX, groupY, groupZ, threadX, threadY, threadZ);
+}
+
+} // namespace LLGI
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "../LLGI.CommandList.h"
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+namespace LLGI
+{
+
+enum class CommandTypeNull : uint8_t
+{
+	BeginRenderPass,
+	EndRenderPass,
+	BeginComputePass,
+	EndComputePass,
+	SetScissor,
+	SetVertexBuffer,
+	SetIndexBuffer,
+	SetPipelineState,
+	SetConstantBuffer,
+	SetTexture,
+	SetComputeBuffer,
+	Draw,
+	Dispatch,
+	CopyTexture,
+	CopyBuffer,
+	GenerateMipMap,
+	Max,
+};
+
+struct CommandObjectNull
+{
+	ReferenceObject* Object;
+};
+
+struct CommandScissorNull
+{
+	int32_t X;
+	int32_t Y;
+	int32_t Width;
+	int32_t Height;
+};
+
+struct CommandBufferNull
+{
+	Buffer* Target;
+	int32_t Stride;
+	int32_t Offset;
+	int32_t Unit;
+};
+
+struct CommandTextureNull
+{
+	Texture* Target;
+	SamplerParameter Sampler;
+	int32_t Unit;
+};
+
+struct CommandDrawNull
+{
+	int32_t PrimitiveCount;
+	int32_t InstanceCount;
+};
+
+struct CommandDispatchNull
+{
+	int32_t GroupX;
+	int32_t GroupY;
+	int32_t GroupZ;
+	int32_t ThreadX;
+	int32_t ThreadY;
+	int32_t ThreadZ;
+};
+
+struct CommandCopyNull
+{
+	ReferenceObject* Src;
+	ReferenceObject* Dst;
+};
+
+/**
+	@brief	a compact stream of commands on cpu
+	@note
+	A command is stored as a header and a trivially copyable payload.
+	A memory is reused after Clear, so no memory is allocated once a stream grows enough.
+*/
+class CommandStreamNull
+{
+public:
+	struct Header
+	{
+		CommandTypeNull Type;
+		uint8_t Size;
+	};
+
+private:
+	std::vector<uint8_t> data_;
+	std::array<int32_t, static_cast<int>(CommandTypeNull::Max)> counts_;
+	int32_t commandCount_ = 0;
+
+	void PushInternal(CommandTypeNull type, const void* payload, size_t size)
+	{
+		Header header;
+		header.Type = type;
+		header.Size = static_cast<uint8_t>(size);
+
+		const auto offset = data_.size();
+		data_.resize(offset + sizeof(Header) + size);
+		memcpy(data_.data() + offset, &header, sizeof(Header));
+
+		if (size > 0)
+		{
+			memcpy(data_.data() + offset + sizeof(Header), payload, size);
+		}
+
+		counts_[static_cast<int>(type)]++;
+		commandCount_++;
+	}
+
+public:
+	CommandStreamNull() { counts_.fill(0); }
+
+	template <typename T> void Push(CommandTypeNull type, const T& payload)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "A payload must be trivially copyable.");
+		static_assert(sizeof(T) <= UINT8_MAX, "A payload is too large.");
+		PushInternal(type, &payload, sizeof(T));
+	}
+
+	void Push(CommandTypeNull type) { PushInternal(type, nullptr, 0); }
+
+	void Append(const CommandStreamNull& stream)
+	{
+		data_.insert(data_.end(), stream.data_.begin(), stream.data_.end());
+
+		for (size_t i = 0; i < counts_.size(); i++)
+		{
+			counts_[i] += stream.counts_[i];
+		}
+
+		commandCount_ += stream.commandCount_;
+	}
+
+	void Clear()
+	{
+		data_.clear();
+		counts_.fill(0);
+		commandCount_ = 0;
+	}
+
+	/**
+		@brief	call a visitor with a type and a pointer to a payload for each command in recorded order
+	*/
+	void Visit(const std::function<void(CommandTypeNull, const void*)>& visitor) const
+	{
+		size_t offset = 0;
+		while (offset < data_.size())
+		{
+			Header header;
+			memcpy(&header, data_.data() + offset, sizeof(Header));
+			visitor(header.Type, data_.data() + offset + sizeof(Header));
+			offset += sizeof(Header) + header.Size;
+		}
+	}
+
+	int32_t GetCommandCount() const { return commandCount_; }
+
+	int32_t GetCommandCount(CommandTypeNull type) const { return counts_[static_cast<int>(type)]; }
+
+	//! a size of the stream in bytes
+	int32_t GetSize() const { return static_cast<int32_t>(data_.size()); }
+};
+
+class CommandListNull : public CommandList
+{
+private:
+	std::vector<CommandStreamNull> commandStreams_;
+	int32_t currentSwapBufferIndex_ = -1;
+	RenderPass* renderPass_ = nullptr;
+	bool isSubCommandList_ = false;
+
+	CommandStreamNull& GetCurrentStream() { return commandStreams_[currentSwapBufferIndex_]; }
+
+public:
+	CommandListNull(int32_t swapCount = 3, bool isSubCommandList = false);
+	~CommandListNull() override = default;
+
+	void Begin() override;
+	void End() override;
+
+	void SetScissor(int32_t x, int32_t y, int32_t width, int32_t height) override;
+	void Draw(int32_t primitiveCount, int32_t instanceCount) override;
+	void CopyTexture(Texture* src, Texture* dst) override;
+	void CopyTexture(
+		Texture* src, Texture* dst, const Vec3I& srcPos, const Vec3I& dstPos, const Vec3I& size, int srcLayer, int dstLayer) override;
+
+	void GenerateMipMap(Texture* src) override;
+
+	void CopyBuffer(Buffer* src, Buffer* dst) override;
+
+	void BeginRenderPass(RenderPass* renderPass) override;
+	void EndRenderPass() override;
+	void ExecuteSubCommandLists(CommandList** subCommandLists, int32_t count) override;
+
+	void BeginComputePass() override;
+	void EndComputePass() override;
+	void Dispatch(int32_t groupX, int32_t groupY, int32_t groupZ, int32_t threadX, int32_t threadY, int32_t threadZ) override;
+
+	void WaitUntilCompleted() override {}
+
+	/**
+		@brief	get commands which are recorded between Begin and End
+	*/
+	const CommandStreamNull& GetCommandStream() const { return commandStreams_[currentSwapBufferIndex_ < 0 ? 0 : currentSwapBufferIndex_]; }
+};
+
+} // namespace LLGI
@@ -0,0 +1,166 @@
+#include "LLGI.GraphicsNull.h"
+#include "LLGI.BufferNull.h"
+#include "LLGI.CommandListNull.h"
+#include "LLGI.PipelineStateNull.h"
+#include "LLGI.RenderPassNull.h"
+#include "LLGI.ShaderNull.h"
+#include "LLGI.SingleFrameMemoryPoolNull.h"
+#include "LLGI.TextureNull.h"
+
+namespace LLGI
+{
+
+GraphicsNull::GraphicsNull(int32_t swapBufferCount, ReferenceObject* owner) : swapBufferCount_(swapBufferCount), owner_(owner)
+{
+	SafeAddRef(owner_);
+}
+
+GraphicsNull::~GraphicsNull() { SafeRelease(owner_); }
+
+void GraphicsNull::Execute(CommandList* commandList) { executedCommandListCount_++; }
+
+Buffer* GraphicsNull::CreateBuffer(BufferUsageType usage, int32_t size)
+{
+	auto obj = new BufferNull();
+	if (!obj->Initialize(usage, size))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+
+	return obj;
+}
+
+Shader* GraphicsNull::CreateShader(DataStructure* data, int32_t count)
+{
+	auto obj = new ShaderNull();
+	if (!obj->Initialize(data, count))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+	return obj;
+}
+
+PipelineState* GraphicsNull::CreatePiplineState() { return new PipelineStateNull(); }
+
+SingleFrameMemoryPool* GraphicsNull::CreateSingleFrameMemoryPool(int32_t constantBufferPoolSize, int32_t drawingCount)
+{
+	return new SingleFrameMemoryPoolNull(this, swapBufferCount_);
+}
+
+CommandList* GraphicsNull::CreateCommandList(SingleFrameMemoryPool* memoryPool) { return new CommandListNull(swapBufferCount_); }
+
+CommandList* GraphicsNull::CreateSubCommandList(SingleFrameMemoryPool* memoryPool) { return new CommandListNull(swapBufferCount_, true); }
+
+RenderPass* GraphicsNull::CreateRenderPass(Texture** textures, int32_t textureCount, Texture* depthTexture)
+{
+	assert(textures != nullptr);
+	if (textures == nullptr)
+		return nullptr;
+
+	auto renderPass = new RenderPassNull();
+	if (!renderPass->Initialize(textures, textureCount, depthTexture, nullptr, nullptr))
+	{
+		SafeRelease(renderPass);
+	}
+
+	return renderPass;
+}
+
+RenderPass* GraphicsNull::CreateRenderPass(Texture* texture, Texture* resolvedTexture, Texture* depthTexture, Texture* resolvedDepthTexture)
+{
+	if (texture == nullptr)
+		return nullptr;
+
+	auto renderPass = new RenderPassNull();
+	if (!renderPass->Initialize(&texture, 1, depthTexture, resolvedTexture, resolvedDepthTexture))
+	{
+		SafeRelease(renderPass);
+	}
+
+	return renderPass;
+}
+
+Texture* GraphicsNull::CreateTexture(const TextureParameter& parameter)
+{
+	auto obj = new TextureNull();
+	if (!obj->Initialize(parameter))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+	return obj;
+}
+
+Texture* GraphicsNull::CreateTexture(const TextureInitializationParameter& parameter)
+{
+	TextureParameter param;
+	param.Dimension = 2;
+	param.Format = parameter.Format;
+	param.MipLevelCount = parameter.MipMapCount;
+	param.SampleCount = 1;
+	param.Size = {parameter.Size.X, parameter.Size.Y, 1};
+	return CreateTexture(param);
+}
+
+Texture* GraphicsNull::CreateRenderTexture(const RenderTextureInitializationParameter& parameter)
+{
+	TextureParameter param;
+	param.Dimension = 2;
+	param.Format = parameter.Format;
+	param.MipLevelCount = 1;
+	param.SampleCount = parameter.SamplingCount;
+	param.Size = {parameter.Size.X, parameter.Size.Y, 1};
+	param.Usage = TextureUsageType::RenderTarget;
+	if (parameter.IsTransient)
+	{
+		param.Usage = param.Usage | TextureUsageType::Transient;
+	}
+	return CreateTexture(param);
+}
+
+Texture* GraphicsNull::CreateDepthTexture(const DepthTextureInitializationParameter& parameter)
+{
+	auto format = TextureFormatType::D32;
+	if (parameter.Mode == DepthTextureMode::DepthStencil)
+	{
+		format = TextureFormatType::D24S8;
+	}
+
+	TextureParameter param;
+	param.Dimension = 2;
+	param.Format = format;
+	param.MipLevelCount = 1;
+	param.SampleCount = parameter.SamplingCount;
+	param.Size = {parameter.Size.X, parameter.Size.Y, 1};
+	if (parameter.IsTransient)
+	{
+		param.Usage = TextureUsageType::Transient;
+	}
+	return CreateTexture(param);
+}
+
+RenderPassPipelineState* GraphicsNull::CreateRenderPassPipelineState(RenderPass* renderPass)
+{
+	return CreateRenderPassPipelineState(renderPass->GetKey());
+}
+
+RenderPassPipelineState* GraphicsNull::CreateRenderPassPipelineState(const RenderPassPipelineStateKey& key)
+{
+	auto obj = new RenderPassPipelineState();
+	obj->Key = key;
+	return obj;
+}
+
+std::vector<uint8_t> GraphicsNull::CaptureRenderTarget(Texture* renderTarget)
+{
+	std::vector<uint8_t> result;
+	if (renderTarget != nullptr)
+	{
+		renderTarget->GetData(result);
+	}
+	return result;
+}
+
+} // namespace LLGI
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../LLGI.Graphics.h"
+
+namespace LLGI
+{
+
+class GraphicsNull : public Graphics
+{
+private:
+	int32_t swapBufferCount_ = 0;
+	int32_t executedCommandListCount_ = 0;
+	ReferenceObject* owner_ = nullptr;
+
+public:
+	GraphicsNull(int32_t swapBufferCount, ReferenceObject* owner);
+	~GraphicsNull() override;
+
+	void Execute(CommandList* commandList) override;
+
+	Buffer* CreateBuffer(BufferUsageType usage, int32_t size) override;
+
+	Shader* CreateShader(DataStructure* data, int32_t count) override;
+
+	PipelineState* CreatePiplineState() override;
+
+	SingleFrameMemoryPool* CreateSingleFrameMemoryPool(int32_t constantBufferPoolSize, int32_t drawingCount) override;
+
+	CommandList* CreateCommandList(SingleFrameMemoryPool* memoryPool) override;
+
+	CommandList* CreateSubCommandList(SingleFrameMemoryPool* memoryPool) override;
+
+	RenderPass* CreateRenderPass(Texture** textures, int32_t textureCount, Texture* depthTexture) override;
+
+	RenderPass* CreateRenderPass(Texture* texture, Texture* resolvedTexture, Texture* depthTexture, Texture* resolvedDepthTexture) override;
+
+	Texture* CreateTexture(const TextureParameter& parameter) override;
+
+	Texture* CreateTexture(const TextureInitializationParameter& parameter) override;
+
+	Texture* CreateRenderTexture(const RenderTextureInitializationParameter& parameter) override;
+
+	Texture* CreateDepthTexture(const DepthTextureInitializationParameter& parameter) override;
+
+	RenderPassPipelineState* CreateRenderPassPipelineState(RenderPass* renderPass) override;
+
+	RenderPassPipelineState* CreateRenderPassPipelineState(const RenderPassPipelineStateKey& key) override;
+
+	std::vector<uint8_t> CaptureRenderTarget(Texture* renderTarget) override;
+
+	bool IsResolvedDepthSupported() const override { return true; }
+
+	//! the number of command lists which are executed since this instance was created
+	int32_t GetExecutedCommandListCount() const { return executedCommandListCount_; }
+};
+
+} // namespace LLGI
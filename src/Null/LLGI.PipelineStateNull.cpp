@@ -0,0 +1,49 @@
+#include "LLGI.PipelineStateNull.h"
+#include "../LLGI.Graphics.h"
+#include "../LLGI.Shader.h"
+
+namespace LLGI
+{
+
+PipelineStateNull::PipelineStateNull() { shaders_.fill(nullptr); }
+
+PipelineStateNull::~PipelineStateNull()
+{
+	for (auto& shader : shaders_)
+	{
+		SafeRelease(shader);
+	}
+}
+
+void PipelineStateNull::SetShader(ShaderStageType stage, Shader* shader)
+{
+	SafeAddRef(shader);
+	SafeRelease(shaders_[static_cast<int>(stage)]);
+	shaders_[static_cast<int>(stage)] = shader;
+}
+
+bool PipelineStateNull::Compile()
+{
+	if (GetIsCompute())
+	{
+		isCompiled_ = true;
+		return true;
+	}
+
+	if (shaders_[static_cast<int>(ShaderStageType::Vertex)] == nullptr || shaders_[static_cast<int>(ShaderStageType::Pixel)] == nullptr)
+	{
+		Log(LogType::Error, "PipelineState : Shaders are not specified.");
+		return false;
+	}
+
+	if (GetRenderPassPipelineState() == nullptr)
+	{
+		Log(LogType::Error, "PipelineState : RenderPassPipelineState is not specified.");
+		return false;
+	}
+
+	isCompiled_ = true;
+	return true;
+}
+
+} // namespace LLGI
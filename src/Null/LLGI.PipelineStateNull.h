@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../LLGI.PipelineState.h"
+
+namespace LLGI
+{
+
+class PipelineStateNull : public PipelineState
+{
+private:
+	std::array<Shader*, static_cast<int>(ShaderStageType::Max)> shaders_;
+	bool isCompiled_ = false;
+
+public:
+	PipelineStateNull();
+	~PipelineStateNull() override;
+
+	void SetShader(ShaderStageType stage, Shader* shader) override;
+
+	bool Compile() override;
+
+	bool GetIsCompiled() const { return isCompiled_; }
+
+	bool GetIsCompute() const { return shaders_[static_cast<int>(ShaderStageType::Compute)] != nullptr; }
+};
+
+} // namespace LLGI
@@ -0,0 +1,96 @@
+#include "LLGI.PlatformNull.h"
+#include "LLGI.GraphicsNull.h"
+#include "LLGI.RenderPassNull.h"
+#include "LLGI.TextureNull.h"
+
+namespace LLGI
+{
+
+bool PlatformNull::CreateScreens(const Vec2I& windowSize)
+{
+	renderPasses_.clear();
+	screens_.clear();
+	depthTexture_.reset();
+
+	TextureParameter depthParam;
+	depthParam.Format = TextureFormatType::D32;
+	depthParam.Size = {windowSize.X, windowSize.Y, 1};
+
+	depthTexture_ = CreateSharedPtr(new TextureNull());
+	if (!depthTexture_->Initialize(depthParam))
+	{
+		return false;
+	}
+
+	for (int32_t i = 0; i < SwapBufferCount; i++)
+	{
+		auto screen = CreateSharedPtr(new TextureNull());
+		if (!screen->InitializeAsScreen(windowSize))
+		{
+			return false;
+		}
+
+		Texture* textures[] = {screen.get()};
+		auto renderPass = CreateSharedPtr(new RenderPassNull());
+		if (!renderPass->Initialize(textures, 1, depthTexture_.get(), nullptr, nullptr))
+		{
+			return false;
+		}
+
+		screens_.emplace_back(screen);
+		renderPasses_.emplace_back(renderPass);
+	}
+
+	windowSize_ = windowSize;
+	return true;
+}
+
+PlatformNull::~PlatformNull()
+{
+	renderPasses_.clear();
+	screens_.clear();
+	depthTexture_.reset();
+}
+
+bool PlatformNull::Initialize(Window* window, const Vec2I& windowSize)
+{
+	window_ = window;
+	return CreateScreens(window != nullptr ? window->GetWindowSize() : windowSize);
+}
+
+bool PlatformNull::NewFrame()
+{
+	if (window_ != nullptr && !window_->OnNewFrame())
+	{
+		return false;
+	}
+
+	frameIndex_ = (frameIndex_ + 1) % SwapBufferCount;
+	return true;
+}
+
+void PlatformNull::Present() {}
+
+Graphics* PlatformNull::CreateGraphics() { return new GraphicsNull(SwapBufferCount, this); }
+
+void PlatformNull::SetWindowSize(const Vec2I& windowSize)
+{
+	if (windowSize_ == windowSize)
+	{
+		return;
+	}
+
+	CreateScreens(windowSize);
+}
+
+RenderPass* PlatformNull::GetCurrentScreen(const Color8& clearColor, bool isColorCleared, bool isDepthCleared)
+{
+	auto currentRenderPass = renderPasses_[frameIndex_];
+
+	currentRenderPass->SetClearColor(clearColor);
+	currentRenderPass->SetIsColorCleared(isColorCleared);
+	currentRenderPass->SetIsDepthCleared(isDepthCleared);
+	return currentRenderPass.get();
+}
+
+} // namespace LLGI
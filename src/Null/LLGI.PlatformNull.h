@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../LLGI.Platform.h"
+
+namespace LLGI
+{
+
+class RenderPassNull;
+class TextureNull;
+
+/**
+	@brief	a platform which doesn't call any driver
+	@note
+	A window is optional. Screens are textures on cpu and nothing is shown.
+*/
+class PlatformNull : public Platform
+{
+private:
+	static constexpr int32_t SwapBufferCount = 3;
+
+	Window* window_ = nullptr;
+	Vec2I windowSize_;
+	int32_t frameIndex_ = 0;
+
+	std::vector<std::shared_ptr<TextureNull>> screens_;
+	std::shared_ptr<TextureNull> depthTexture_;
+	std::vector<std::shared_ptr<RenderPassNull>> renderPasses_;
+
+	bool CreateScreens(const Vec2I& windowSize);
+
+public:
+	PlatformNull() = default;
+	~PlatformNull() override;
+
+	bool Initialize(Window* window, const Vec2I& windowSize);
+
+	bool NewFrame() override;
+	void Present() override;
+	Graphics* CreateGraphics() override;
+	DeviceType GetDeviceType() const override { return DeviceType::Null; }
+	int GetCurrentFrameIndex() const override { return frameIndex_; }
+	int GetMaxFrameCount() const override { return SwapBufferCount; }
+
+	void SetWindowSize(const Vec2I& windowSize) override;
+
+	RenderPass* GetCurrentScreen(const Color8& clearColor, bool isColorCleared, bool isDepthCleared) override;
+};
+
+} // namespace LLGI
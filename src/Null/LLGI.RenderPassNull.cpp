@@ -0,0 +1,41 @@
+#include "LLGI.RenderPassNull.h"
+#include "../LLGI.Texture.h"
+
+namespace LLGI
+{
+
+bool RenderPassNull::Initialize(
+	Texture** textures, int32_t textureCount, Texture* depthTexture, Texture* resolvedTexture, Texture* resolvedDepthTexture)
+{
+	if (textureCount == 0)
+		return false;
+
+	if (!assignRenderTextures(textures, textureCount))
+	{
+		return false;
+	}
+
+	if (!assignDepthTexture(depthTexture))
+	{
+		return false;
+	}
+
+	if (!assignResolvedRenderTexture(resolvedTexture))
+	{
+		return false;
+	}
+
+	if (!assignResolvedDepthTexture(resolvedDepthTexture))
+	{
+		return false;
+	}
+
+	if (!getSize(screenSize_, const_cast<const Texture**>(textures), textureCount, depthTexture, resolvedTexture, resolvedDepthTexture))
+	{
+		return false;
+	}
+
+	return sanitize();
+}
+
+} // namespace LLGI
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "../LLGI.Graphics.h"
+
+namespace LLGI
+{
+
+class RenderPassNull : public RenderPass
+{
+public:
+	RenderPassNull() = default;
+	~RenderPassNull() override = default;
+
+	bool Initialize(Texture** textures, int32_t textureCount, Texture* depthTexture, Texture* resolvedTexture, Texture* resolvedDepthTexture);
+};
+
+} // namespace LLGI
@@ -0,0 +1,19 @@
+#include "LLGI.ShaderNull.h"
+
+namespace LLGI
+{
+
+bool ShaderNull::Initialize(DataStructure* data, int32_t count)
+{
+	code_.clear();
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		auto p = static_cast<const uint8_t*>(data[i].Data);
+		code_.insert(code_.end(), p, p + data[i].Size);
+	}
+
+	return true;
+}
+
+} // namespace LLGI
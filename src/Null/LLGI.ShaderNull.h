@@ -0,0 +1,22 @@
+#pragma once
+
+#include "../LLGI.Shader.h"
+
+namespace LLGI
+{
+
+class ShaderNull : public Shader
+{
+private:
+	std::vector<uint8_t> code_;
+
+public:
+	ShaderNull() = default;
+	~ShaderNull() override = default;
+
+	bool Initialize(DataStructure* data, int32_t count);
+
+	const std::vector<uint8_t>& GetCode() const { return code_; }
+};
+
+} // namespace LLGI
@@ -0,0 +1,35 @@
+#include "LLGI.SingleFrameMemoryPoolNull.h"
+#include "LLGI.BufferNull.h"
+
+namespace LLGI
+{
+
+Buffer* SingleFrameMemoryPoolNull::CreateBufferInternal(int32_t size)
+{
+	auto obj = new BufferNull();
+	if (!obj->Initialize(BufferUsageType::Constant | BufferUsageType::MapWrite, size))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+
+	return obj;
+}
+
+Buffer* SingleFrameMemoryPoolNull::ReinitializeBuffer(Buffer* cb, int32_t size)
+{
+	auto obj = static_cast<BufferNull*>(cb);
+	if (!obj->Initialize(BufferUsageType::Constant | BufferUsageType::MapWrite, size))
+	{
+		return nullptr;
+	}
+
+	return obj;
+}
+
+SingleFrameMemoryPoolNull::SingleFrameMemoryPoolNull(Graphics* graphics, int32_t swapBufferCount)
+	: SingleFrameMemoryPool(swapBufferCount, graphics)
+{
+}
+
+} // namespace LLGI
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../LLGI.Graphics.h"
+
+namespace LLGI
+{
+
+class SingleFrameMemoryPoolNull : public SingleFrameMemoryPool
+{
+protected:
+	Buffer* CreateBufferInternal(int32_t size) override;
+
+	Buffer* ReinitializeBuffer(Buffer* cb, int32_t size) override;
+
+public:
+	SingleFrameMemoryPoolNull(Graphics* graphics, int32_t swapBufferCount);
+	~SingleFrameMemoryPoolNull() override = default;
+};
+
+} // namespace LLGI
@@ -0,0 +1,64 @@
+#include "LLGI.TextureNull.h"
+
+namespace LLGI
+{
+
+bool TextureNull::Initialize(const TextureParameter& parameter)
+{
+	if (parameter.Dimension < 2)
+	{
+		return false;
+	}
+
+	parameter_ = parameter;
+	format_ = parameter.Format;
+	usage_ = parameter.Usage;
+	samplingCount_ = parameter.SampleCount;
+	mipmapCount_ = parameter.MipLevelCount;
+
+	if (IsDepthFormat(format_))
+	{
+		type_ = TextureType::Depth;
+	}
+	else if (BitwiseContains(usage_, TextureUsageType::RenderTarget))
+	{
+		type_ = TextureType::Render;
+	}
+	else
+	{
+		type_ = TextureType::Color;
+	}
+
+	data_.resize(GetTextureMemorySize(format_, parameter.Size));
+	return true;
+}
+
+bool TextureNull::InitializeAsScreen(const Vec2I& size)
+{
+	TextureParameter param;
+	param.Usage = TextureUsageType::RenderTarget;
+	param.Format = TextureFormatType::R8G8B8A8_UNORM;
+	param.Size = {size.X, size.Y, 1};
+
+	if (!Initialize(param))
+	{
+		return false;
+	}
+
+	type_ = TextureType::Screen;
+	return true;
+}
+
+void* TextureNull::Lock() { return data_.data(); }
+
+void TextureNull::Unlock() {}
+
+bool TextureNull::GetData(std::vector<uint8_t>& data)
+{
+	data = data_;
+	return true;
+}
+
+Vec2I TextureNull::GetSizeAs2D() const { return {parameter_.Size.X, parameter_.Size.Y}; }
+
+} // namespace LLGI
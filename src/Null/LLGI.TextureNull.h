@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../LLGI.Graphics.h"
+#include "../LLGI.Texture.h"
+
+namespace LLGI
+{
+
+class TextureNull : public Texture
+{
+private:
+	TextureParameter parameter_;
+	std::vector<uint8_t> data_;
+
+public:
+	TextureNull() = default;
+	~TextureNull() override = default;
+
+	bool Initialize(const TextureParameter& parameter);
+
+	/**
+		@brief	initialize as screen
+	*/
+	bool InitializeAsScreen(const Vec2I& size);
+
+	void* Lock() override;
+	void Unlock() override;
+
+	bool GetData(std::vector<uint8_t>& data) override;
+
+	Vec2I GetSizeAs2D() const override;
+
+	const TextureParameter& GetParameter() const { return parameter_; }
+};
+
+} // namespace LLGI
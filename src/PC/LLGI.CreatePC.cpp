@@ -1,6 +1,7 @@
 
 #include "../LLGI.Compiler.h"
 #include "../LLGI.Platform.h"
+#include "../Null/LLGI.PlatformNull.h"
 
 #ifdef ENABLE_VULKAN
 #include "../Vulkan/LLGI.PlatformVulkan.h"
@@ -65,6 +66,17 @@ Platform* CreatePlatform(const PlatformParameter& parameter, Window* window)
 	windowSize.X = 1280;
 	windowSize.Y = 720;
 
+	if (parameter.Device == DeviceType::Null)
+	{
+		auto platform = new PlatformNull();
+		if (!platform->Initialize(window, parameter.HeadlessScreenSize))
+		{
+			SafeRelease(platform);
+			return nullptr;
+		}
+		return platform;
+	}
+
 #ifdef ENABLE_VULKAN
 #if defined(__linux__)
 	if (parameter.Device == DeviceType::Vulkan || parameter.Device == DeviceType::Default)
@@ -73,7 +85,10 @@ Platform* CreatePlatform(const PlatformParameter& parameter, Window* window)
 #endif
 	{
 		auto platform = new PlatformVulkan();
-		if (!platform->Initialize(window, parameter.WaitVSync))
+		platform->SetMaxFramesInFlight(parameter.MaxFramesInFlight);
+		const auto initialized = parameter.IsHeadless ? platform->InitializeAsHeadless(parameter.HeadlessScreenSize)
+													  : platform->Initialize(window, parameter.WaitVSync);
+		if (!initialized)
 		{
 			SafeRelease(platform);
 			return nullptr;
@@ -82,6 +97,12 @@ Platform* CreatePlatform(const PlatformParameter& parameter, Window* window)
 	}
 #endif
 
+	if (parameter.IsHeadless)
+	{
+		Log(LogType::Error, "Headless mode is supported only with Vulkan.");
+		return nullptr;
+	}
+
 #ifdef _WIN32
 
 	if (parameter.Device == DeviceType::Default || parameter.Device == DeviceType::DirectX12)
@@ -0,0 +1,143 @@
+
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <map>
+#include <stdint.h>
+
+namespace LLGI
+{
+
+/**
+	@brief	an allocator which hands out ranges of a fixed size region
+	@note
+	Free ranges are searched with best fit and adjacent free ranges are merged when a range is freed.
+	It manages only offsets, so the region itself is owned by a user.
+*/
+class FreeListAllocator
+{
+private:
+	uint64_t capacity_ = 0;
+	uint64_t usedSize_ = 0;
+	int32_t allocationCount_ = 0;
+
+	//! offset to size
+	std::map<uint64_t, uint64_t> freeRangesByOffset_;
+
+	//! size to offset
+	std::multimap<uint64_t, uint64_t> freeRangesBySize_;
+
+	void AddFreeRange(uint64_t offset, uint64_t size)
+	{
+		if (size == 0)
+		{
+			return;
+		}
+
+		freeRangesByOffset_.emplace(offset, size);
+		freeRangesBySize_.emplace(size, offset);
+	}
+
+	void RemoveFreeRange(std::map<uint64_t, uint64_t>::iterator it)
+	{
+		auto range = freeRangesBySize_.equal_range(it->second);
+		for (auto sizeIt = range.first; sizeIt != range.second; sizeIt++)
+		{
+			if (sizeIt->second == it->first)
+			{
+				freeRangesBySize_.erase(sizeIt);
+				break;
+			}
+		}
+
+		freeRangesByOffset_.erase(it);
+	}
+
+public:
+	FreeListAllocator(uint64_t capacity) : capacity_(capacity) { AddFreeRange(0, capacity); }
+
+	/**
+		@brief	allocate a range
+		@param	alignment	it must be a power of two
+	*/
+	bool Allocate(uint64_t size, uint64_t alignment, uint64_t& offset)
+	{
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+		if (size == 0)
+		{
+			return false;
+		}
+
+		for (auto sizeIt = freeRangesBySize_.lower_bound(size); sizeIt != freeRangesBySize_.end(); sizeIt++)
+		{
+			const auto rangeOffset = sizeIt->second;
+			const auto rangeSize = sizeIt->first;
+			const auto alignedOffset = (rangeOffset + alignment - 1) & ~(alignment - 1);
+
+			if (alignedOffset + size > rangeOffset + rangeSize)
+			{
+				continue;
+			}
+
+			RemoveFreeRange(freeRangesByOffset_.find(rangeOffset));
+
+			// a padding for the alignment and a remainder are returned
+			AddFreeRange(rangeOffset, alignedOffset - rangeOffset);
+			AddFreeRange(alignedOffset + size, rangeOffset + rangeSize - (alignedOffset + size));
+
+			offset = alignedOffset;
+			usedSize_ += size;
+			allocationCount_++;
+			return true;
+		}
+
+		return false;
+	}
+
+	void Free(uint64_t offset, uint64_t size)
+	{
+		assert(offset + size <= capacity_);
+		assert(allocationCount_ > 0);
+
+		usedSize_ -= size;
+		allocationCount_--;
+
+		// merge with neighbors
+		auto next = freeRangesByOffset_.lower_bound(offset);
+		if (next != freeRangesByOffset_.end() && next->first == offset + size)
+		{
+			size += next->second;
+			RemoveFreeRange(next);
+		}
+
+		auto prev = freeRangesByOffset_.lower_bound(offset);
+		if (prev != freeRangesByOffset_.begin())
+		{
+			prev--;
+			if (prev->first + prev->second == offset)
+			{
+				offset = prev->first;
+				size += prev->second;
+				RemoveFreeRange(prev);
+			}
+		}
+
+		AddFreeRange(offset, size);
+	}
+
+	uint64_t GetCapacity() const { return capacity_; }
+
+	uint64_t GetUsedSize() const { return usedSize_; }
+
+	int32_t GetAllocationCount() const { return allocationCount_; }
+
+	int32_t GetFreeRangeCount() const { return static_cast<int32_t>(freeRangesByOffset_.size()); }
+
+	uint64_t GetLargestFreeRange() const { return freeRangesBySize_.empty() ? 0 : freeRangesBySize_.rbegin()->first; }
+
+	bool IsEmpty() const { return allocationCount_ == 0; }
+};
+
+} // namespace LLGI
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace LLGI
+{
+
+//! mix bits of a value so that close values have distant hashes (a finalizer of splitmix64)
+inline uint64_t MixHash(uint64_t value)
+{
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+	return value ^ (value >> 31);
+}
+
+//! combine a value into a hash. A result depends on the order of values.
+inline void CombineHash(uint64_t& hash, uint64_t value)
+{
+	hash = MixHash(hash ^ (value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2)));
+}
+
+} // namespace LLGI
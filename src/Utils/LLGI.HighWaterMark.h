@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <stdint.h>
+
+namespace LLGI
+{
+
+/**
+	@brief	the maximum size used in recent frames
+	@note
+	Pages which exceed it are released so that a pool does not keep a peak forever.
+*/
+class HighWaterMark
+{
+private:
+	//! the number of frames whose usages decide the high-water mark
+	static constexpr size_t FrameCount = 60;
+
+	//! sizes used in recent frames
+	std::deque<int32_t> usedSizes_;
+
+public:
+	//! record a size used in a frame which is finished
+	void Push(int32_t usedSize)
+	{
+		usedSizes_.push_back(usedSize);
+		if (usedSizes_.size() > FrameCount)
+		{
+			usedSizes_.pop_front();
+		}
+	}
+
+	//! get the high-water mark including a size used in the current frame
+	int32_t Get(int32_t currentUsedSize) const
+	{
+		int32_t highWaterMark = currentUsedSize;
+		for (auto usedSize : usedSizes_)
+		{
+			highWaterMark = std::max(highWaterMark, usedSize);
+		}
+		return highWaterMark;
+	}
+
+	//! get the number of leading pages whose capacity covers the high-water mark
+	template <typename Pages> static size_t GetRequiredPageCount(const Pages& pages, int32_t highWaterMark)
+	{
+		size_t requiredPageCount = 0;
+		int32_t capacity = 0;
+		while (requiredPageCount < pages.size() && capacity < highWaterMark)
+		{
+			capacity += pages[requiredPageCount]->GetSize();
+			requiredPageCount++;
+		}
+		return requiredPageCount;
+	}
+};
+
+} // namespace LLGI
@@ -0,0 +1,105 @@
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace LLGI
+{
+
+/**
+	@brief	threads which execute pushed tasks in order
+	@note
+	Tasks which have been pushed are executed before threads exit.
+	It can be destroyed in a task because a state shared with threads is kept until they exit.
+*/
+class WorkerThreadPool
+{
+private:
+	struct State
+	{
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<std::function<void()>> tasks;
+		bool isTerminated = false;
+	};
+
+	std::shared_ptr<State> state_;
+	std::vector<std::thread> threads_;
+
+	static void Run(std::shared_ptr<State> state)
+	{
+		while (true)
+		{
+			std::function<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock(state->mutex);
+				state->condition.wait(lock, [&state]() -> bool { return state->isTerminated || !state->tasks.empty(); });
+
+				if (state->tasks.empty())
+				{
+					return;
+				}
+
+				task = std::move(state->tasks.front());
+				state->tasks.pop_front();
+			}
+
+			task();
+		}
+	}
+
+public:
+	WorkerThreadPool(int32_t threadCount) : state_(std::make_shared<State>())
+	{
+		for (int32_t i = 0; i < threadCount; i++)
+		{
+			auto state = state_;
+			threads_.emplace_back([state]() -> void { Run(state); });
+		}
+	}
+
+	~WorkerThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(state_->mutex);
+			state_->isTerminated = true;
+		}
+		state_->condition.notify_all();
+
+		for (auto& thread : threads_)
+		{
+			if (thread.get_id() == std::this_thread::get_id())
+			{
+				thread.detach();
+			}
+			else
+			{
+				thread.join();
+			}
+		}
+	}
+
+	void Push(const std::function<void()>& task)
+	{
+		// a task may destroy this instance before notifying
+		auto state = state_;
+
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->tasks.push_back(task);
+		}
+		state->condition.notify_one();
+	}
+
+	int32_t GetThreadCount() const { return static_cast<int32_t>(threads_.size()); }
+};
+
+} // namespace LLGI
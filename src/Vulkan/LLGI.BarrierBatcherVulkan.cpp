@@ -0,0 +1,247 @@
+#include "LLGI.BarrierBatcherVulkan.h"
+
+namespace LLGI
+{
+
+void BarrierBatcherVulkan::AddImageBarrier(vk::Image image,
+										   vk::ImageAspectFlags aspectMask,
+										   uint32_t mipLevel,
+										   uint32_t baseArrayLayer,
+										   uint32_t layerCount,
+										   vk::ImageLayout oldLayout,
+										   vk::ImageLayout newLayout)
+{
+	for (auto it = imageTransitions_.begin(); it != imageTransitions_.end(); it++)
+	{
+		if (it->Image != image || it->AspectMask != aspectMask || it->MipLevel != mipLevel || it->BaseArrayLayer != baseArrayLayer ||
+			it->LayerCount != layerCount)
+		{
+			continue;
+		}
+
+		// no command uses the intermediate layout, so it is skipped
+		it->NewLayout = newLayout;
+		if (it->OldLayout == it->NewLayout)
+		{
+			imageTransitions_.erase(it);
+		}
+		return;
+	}
+
+	ImageTransition transition;
+	transition.Image = image;
+	transition.AspectMask = aspectMask;
+	transition.MipLevel = mipLevel;
+	transition.BaseArrayLayer = baseArrayLayer;
+	transition.LayerCount = layerCount;
+	transition.OldLayout = oldLayout;
+	transition.NewLayout = newLayout;
+	imageTransitions_.emplace_back(transition);
+}
+
+void BarrierBatcherVulkan::AddBufferBarrier(
+	vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size, vk::AccessFlags srcAccess, vk::AccessFlags dstAccess)
+{
+	for (auto& transition : bufferTransitions_)
+	{
+		if (transition.Buffer == buffer && transition.Offset == offset && transition.Size == size)
+		{
+			transition.DstAccess = dstAccess;
+			return;
+		}
+	}
+
+	BufferTransition transition;
+	transition.Buffer = buffer;
+	transition.Offset = offset;
+	transition.Size = size;
+	transition.SrcAccess = srcAccess;
+	transition.DstAccess = dstAccess;
+	bufferTransitions_.emplace_back(transition);
+}
+
+void BarrierBatcherVulkan::Flush(vk::CommandBuffer commandBuffer)
+{
+	if (GetIsEmpty())
+	{
+		return;
+	}
+
+	vk::PipelineStageFlags srcStages;
+	vk::PipelineStageFlags dstStages;
+
+	imageBarriers_.clear();
+	for (const auto& transition : imageTransitions_)
+	{
+		srcStages |= GetStageFlags(transition.OldLayout, true);
+		dstStages |= GetStageFlags(transition.NewLayout, false);
+
+		// merge a next mip level into the previous range
+		if (!imageBarriers_.empty())
+		{
+			auto& last = imageBarriers_.back();
+			if (last.image == transition.Image && last.subresourceRange.aspectMask == transition.AspectMask &&
+				last.subresourceRange.baseArrayLayer == transition.BaseArrayLayer &&
+				last.subresourceRange.layerCount == transition.LayerCount && last.oldLayout == transition.OldLayout &&
+				last.newLayout == transition.NewLayout &&
+				last.subresourceRange.baseMipLevel + last.subresourceRange.levelCount == transition.MipLevel)
+			{
+				last.subresourceRange.levelCount++;
+				continue;
+			}
+		}
+
+		vk::ImageMemoryBarrier barrier;
+		barrier.srcAccessMask = GetAccessFlags(transition.OldLayout);
+		barrier.dstAccessMask = GetAccessFlags(transition.NewLayout);
+		barrier.oldLayout = transition.OldLayout;
+		barrier.newLayout = transition.NewLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = transition.Image;
+		barrier.subresourceRange.aspectMask = transition.AspectMask;
+		barrier.subresourceRange.baseMipLevel = transition.MipLevel;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = transition.BaseArrayLayer;
+		barrier.subresourceRange.layerCount = transition.LayerCount;
+		imageBarriers_.emplace_back(barrier);
+	}
+
+	bufferBarriers_.clear();
+	for (const auto& transition : bufferTransitions_)
+	{
+		srcStages |= GetStageFlags(transition.SrcAccess, true);
+		dstStages |= GetStageFlags(transition.DstAccess, false);
+
+		vk::BufferMemoryBarrier barrier(transition.SrcAccess,
+										transition.DstAccess,
+										VK_QUEUE_FAMILY_IGNORED,
+										VK_QUEUE_FAMILY_IGNORED,
+										transition.Buffer,
+										transition.Offset,
+										transition.Size);
+		bufferBarriers_.emplace_back(barrier);
+	}
+
+	commandBuffer.pipelineBarrier(srcStages,
+								  dstStages,
+								  vk::DependencyFlags(),
+								  0,
+								  nullptr,
+								  static_cast<uint32_t>(bufferBarriers_.size()),
+								  bufferBarriers_.data(),
+								  static_cast<uint32_t>(imageBarriers_.size()),
+								  imageBarriers_.data());
+
+	Reset();
+}
+
+void BarrierBatcherVulkan::Reset()
+{
+	imageTransitions_.clear();
+	bufferTransitions_.clear();
+}
+
+vk::AccessFlags BarrierBatcherVulkan::GetAccessFlags(vk::ImageLayout layout)
+{
+	switch (layout)
+	{
+	case vk::ImageLayout::ePreinitialized:
+		return vk::AccessFlagBits::eHostWrite;
+	case vk::ImageLayout::eTransferDstOptimal:
+		return vk::AccessFlagBits::eTransferWrite;
+	case vk::ImageLayout::eTransferSrcOptimal:
+		return vk::AccessFlagBits::eTransferRead;
+	case vk::ImageLayout::eColorAttachmentOptimal:
+		return vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite;
+	case vk::ImageLayout::eDepthStencilAttachmentOptimal:
+		return vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+	case vk::ImageLayout::eDepthStencilReadOnlyOptimal:
+		return vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eShaderRead;
+	case vk::ImageLayout::eShaderReadOnlyOptimal:
+		return vk::AccessFlagBits::eShaderRead;
+	case vk::ImageLayout::eGeneral:
+		// it is used for storage images
+		return vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+	case vk::ImageLayout::ePresentSrcKHR:
+		return vk::AccessFlagBits::eMemoryRead;
+	default:
+		return vk::AccessFlags();
+	}
+}
+
+vk::PipelineStageFlags BarrierBatcherVulkan::GetStageFlags(vk::ImageLayout layout, bool isSource)
+{
+	switch (layout)
+	{
+	case vk::ImageLayout::eUndefined:
+		return vk::PipelineStageFlagBits::eTopOfPipe;
+	case vk::ImageLayout::ePreinitialized:
+		return vk::PipelineStageFlagBits::eHost;
+	case vk::ImageLayout::eTransferDstOptimal:
+	case vk::ImageLayout::eTransferSrcOptimal:
+		return vk::PipelineStageFlagBits::eTransfer;
+	case vk::ImageLayout::eColorAttachmentOptimal:
+		return vk::PipelineStageFlagBits::eColorAttachmentOutput;
+	case vk::ImageLayout::eDepthStencilAttachmentOptimal:
+		return vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
+	case vk::ImageLayout::eDepthStencilReadOnlyOptimal:
+		return vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests |
+			   vk::PipelineStageFlagBits::eFragmentShader;
+	case vk::ImageLayout::eShaderReadOnlyOptimal:
+		return vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader |
+			   vk::PipelineStageFlagBits::eComputeShader;
+	case vk::ImageLayout::eGeneral:
+		return vk::PipelineStageFlagBits::eComputeShader;
+	case vk::ImageLayout::ePresentSrcKHR:
+		// the presentation engine is synchronized with semaphores
+		return isSource ? vk::PipelineStageFlagBits::eTopOfPipe : vk::PipelineStageFlagBits::eBottomOfPipe;
+	default:
+		return vk::PipelineStageFlagBits::eAllCommands;
+	}
+}
+
+vk::PipelineStageFlags BarrierBatcherVulkan::GetStageFlags(vk::AccessFlags access, bool isSource)
+{
+	if (!access)
+	{
+		return isSource ? vk::PipelineStageFlagBits::eTopOfPipe : vk::PipelineStageFlagBits::eBottomOfPipe;
+	}
+
+	vk::PipelineStageFlags stages;
+
+	if (access & (vk::AccessFlagBits::eHostRead | vk::AccessFlagBits::eHostWrite))
+	{
+		stages |= vk::PipelineStageFlagBits::eHost;
+	}
+
+	if (access & (vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite))
+	{
+		stages |= vk::PipelineStageFlagBits::eTransfer;
+	}
+
+	if (access & (vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead))
+	{
+		stages |= vk::PipelineStageFlagBits::eVertexInput;
+	}
+
+	if (access & vk::AccessFlagBits::eIndirectCommandRead)
+	{
+		stages |= vk::PipelineStageFlagBits::eDrawIndirect;
+	}
+
+	if (access & (vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite))
+	{
+		stages |= vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader |
+				  vk::PipelineStageFlagBits::eComputeShader;
+	}
+
+	if (!stages)
+	{
+		stages = vk::PipelineStageFlagBits::eAllCommands;
+	}
+
+	return stages;
+}
+
+} // namespace LLGI
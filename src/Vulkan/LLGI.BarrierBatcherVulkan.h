@@ -0,0 +1,81 @@
+#pragma once
+
+#include "LLGI.BaseVulkan.h"
+#include <vector>
+
+namespace LLGI
+{
+
+/**
+	@brief	a batcher which records pending layout transitions and buffer barriers into one pipelineBarrier
+	@note
+	Transitions are added per mip level and contiguous mip levels with the same layouts are merged into one range when flushing.
+	A transition of a subresource which is already pending is folded into the pending one, because no command runs between them.
+	Stage masks are derived from layouts and access flags instead of TopOfPipe or AllCommands.
+	A caller must flush it before a command which uses resources in it.
+*/
+class BarrierBatcherVulkan
+{
+private:
+	struct ImageTransition
+	{
+		vk::Image Image;
+		vk::ImageAspectFlags AspectMask;
+		uint32_t MipLevel = 0;
+		uint32_t BaseArrayLayer = 0;
+		uint32_t LayerCount = 1;
+		vk::ImageLayout OldLayout = vk::ImageLayout::eUndefined;
+		vk::ImageLayout NewLayout = vk::ImageLayout::eUndefined;
+	};
+
+	struct BufferTransition
+	{
+		vk::Buffer Buffer;
+		vk::DeviceSize Offset = 0;
+		vk::DeviceSize Size = 0;
+		vk::AccessFlags SrcAccess;
+		vk::AccessFlags DstAccess;
+	};
+
+	std::vector<ImageTransition> imageTransitions_;
+	std::vector<BufferTransition> bufferTransitions_;
+	std::vector<vk::ImageMemoryBarrier> imageBarriers_;
+	std::vector<vk::BufferMemoryBarrier> bufferBarriers_;
+
+public:
+	/**
+		@brief	add a transition of layers in a mip level
+	*/
+	void AddImageBarrier(vk::Image image,
+						 vk::ImageAspectFlags aspectMask,
+						 uint32_t mipLevel,
+						 uint32_t baseArrayLayer,
+						 uint32_t layerCount,
+						 vk::ImageLayout oldLayout,
+						 vk::ImageLayout newLayout);
+
+	/**
+		@brief	add a dependency between accesses to a range of a buffer
+	*/
+	void AddBufferBarrier(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size, vk::AccessFlags srcAccess, vk::AccessFlags dstAccess);
+
+	bool GetIsEmpty() const { return imageTransitions_.empty() && bufferTransitions_.empty(); }
+
+	/**
+		@brief	record pending barriers with one pipelineBarrier
+		@note
+		Nothing is recorded if there is no pending barrier.
+	*/
+	void Flush(vk::CommandBuffer commandBuffer);
+
+	//! drop pending barriers without recording them
+	void Reset();
+
+	static vk::AccessFlags GetAccessFlags(vk::ImageLayout layout);
+
+	static vk::PipelineStageFlags GetStageFlags(vk::ImageLayout layout, bool isSource);
+
+	static vk::PipelineStageFlags GetStageFlags(vk::AccessFlags access, bool isSource);
+};
+
+} // namespace LLGI
@@ -1,4 +1,5 @@
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.BarrierBatcherVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
 
 namespace LLGI
@@ -122,20 +123,50 @@ InternalBuffer::~InternalBuffer()
 		if (!isExternalResource_)
 		{
 			graphics_->GetDevice().destroyBuffer(buffer_);
-			graphics_->GetDevice().freeMemory(devMem_);
+			graphics_->GetMemoryAllocator()->Free(allocation_);
 		}
 		buffer_ = nullptr;
 	}
 }
 
-void InternalBuffer::Attach(vk::Buffer buffer, vk::DeviceMemory devMem, bool isExternalResource)
+bool InternalBuffer::Initialize(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties)
+{
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.size = size;
+	bufferInfo.usage = usage;
+	vk::Buffer buffer = graphics_->GetDevice().createBuffer(bufferInfo);
+
+	vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(buffer);
+	MemoryAllocationVulkan allocation;
+	if (!graphics_->GetMemoryAllocator()->Allocate(memReqs, properties, true, allocation))
+	{
+		graphics_->GetDevice().destroyBuffer(buffer);
+		return false;
+	}
+
+	graphics_->GetDevice().bindBufferMemory(buffer, allocation.Memory, allocation.Offset);
+
+	Attach(buffer, allocation);
+	return true;
+}
+
+void InternalBuffer::Attach(vk::Buffer buffer, const MemoryAllocationVulkan& allocation, bool isExternalResource)
 {
 	buffer_ = buffer;
-	devMem_ = devMem;
+	allocation_ = allocation;
 	isExternalResource_ = isExternalResource;
 }
 
-VulkanBuffer::VulkanBuffer() : graphics_(nullptr), nativeBuffer_(VK_NULL_HANDLE), nativeBufferMemory_(VK_NULL_HANDLE), size_(0) {}
+void* InternalBuffer::GetMappedPointer() const { return graphics_->GetMemoryAllocator()->GetMappedPointer(allocation_); }
+
+void InternalBuffer::Flush(vk::DeviceSize offset, vk::DeviceSize size) { graphics_->GetMemoryAllocator()->Flush(allocation_, offset, size); }
+
+void InternalBuffer::Invalidate(vk::DeviceSize offset, vk::DeviceSize size)
+{
+	graphics_->GetMemoryAllocator()->Invalidate(allocation_, offset, size);
+}
+
+VulkanBuffer::VulkanBuffer() : graphics_(nullptr), nativeBuffer_(VK_NULL_HANDLE), size_(0) {}
 
 bool VulkanBuffer::Initialize(GraphicsVulkan* graphics, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
 {
@@ -157,13 +188,13 @@ bool VulkanBuffer::Initialize(GraphicsVulkan* graphics, VkDeviceSize size, VkBuf
 	VkMemoryRequirements memRequirements;
 	vkGetBufferMemoryRequirements(device, nativeBuffer_, &memRequirements);
 
-	VkMemoryAllocateInfo allocInfo = {};
-	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memRequirements.memoryTypeBits, (vk::MemoryPropertyFlags)properties);
+	if (!graphics_->GetMemoryAllocator()->Allocate(
+			static_cast<vk::MemoryRequirements>(memRequirements), (vk::MemoryPropertyFlags)properties, true, allocation_))
+	{
+		return false;
+	}
 
-	LLGI_VK_CHECK(vkAllocateMemory(device, &allocInfo, nullptr, &nativeBufferMemory_));
-	LLGI_VK_CHECK(vkBindBufferMemory(device, nativeBuffer_, nativeBufferMemory_, 0));
+	LLGI_VK_CHECK(vkBindBufferMemory(device, nativeBuffer_, static_cast<VkDeviceMemory>(allocation_.Memory), allocation_.Offset));
 
 	return true;
 }
@@ -172,11 +203,7 @@ void VulkanBuffer::Dispose()
 {
 	auto device = static_cast<VkDevice>(graphics_->GetDevice());
 
-	if (nativeBufferMemory_)
-	{
-		vkFreeMemory(device, nativeBufferMemory_, nullptr);
-		nativeBufferMemory_ = VK_NULL_HANDLE;
-	}
+	graphics_->GetMemoryAllocator()->Free(allocation_);
 
 	if (nativeBuffer_)
 	{
@@ -187,133 +214,24 @@ void VulkanBuffer::Dispose()
 	graphics_ = nullptr;
 }
 
-static vk::PipelineStageFlags GetStageFlag(vk::ImageLayout layout)
-{
-
-	if (layout == vk::ImageLayout::ePreinitialized)
-	{
-		return vk::PipelineStageFlagBits::eHost;
-	}
-	else if (layout == vk::ImageLayout::eTransferDstOptimal || layout == vk::ImageLayout::eTransferSrcOptimal)
-	{
-		return vk::PipelineStageFlagBits::eTransfer;
-	}
-	else if (layout == vk::ImageLayout::eColorAttachmentOptimal)
-	{
-		return vk::PipelineStageFlagBits::eColorAttachmentOutput;
-	}
-	else if (layout == vk::ImageLayout::eShaderReadOnlyOptimal)
-	{
-		return vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader;
-	}
-
-	return vk::PipelineStageFlagBits::eTopOfPipe;
-}
-
 void SetImageLayout(vk::CommandBuffer cmdbuffer,
 					vk::Image image,
 					vk::ImageLayout oldImageLayout,
 					vk::ImageLayout newImageLayout,
 					vk::ImageSubresourceRange subresourceRange)
 {
-	vk::ImageMemoryBarrier imageMemoryBarrier;
-	imageMemoryBarrier.oldLayout = oldImageLayout;
-	imageMemoryBarrier.newLayout = newImageLayout;
-	imageMemoryBarrier.image = image;
-	imageMemoryBarrier.subresourceRange = subresourceRange;
-
-	// current layout
-	if (oldImageLayout == vk::ImageLayout::ePreinitialized)
-	{
-		imageMemoryBarrier.srcAccessMask = vk::AccessFlagBits::eHostWrite;
-	}
-	else if (oldImageLayout == vk::ImageLayout::eTransferDstOptimal)
-	{
-		imageMemoryBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-	}
-	else if (oldImageLayout == vk::ImageLayout::eColorAttachmentOptimal)
-	{
-		imageMemoryBarrier.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-	}
-	else if (oldImageLayout == vk::ImageLayout::eDepthStencilAttachmentOptimal)
-	{
-		imageMemoryBarrier.srcAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite;
-	}
-	else if (oldImageLayout == vk::ImageLayout::eTransferSrcOptimal)
-	{
-		imageMemoryBarrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
-	}
-	else if (oldImageLayout == vk::ImageLayout::eShaderReadOnlyOptimal)
-	{
-		imageMemoryBarrier.srcAccessMask = vk::AccessFlagBits::eShaderRead;
-	}
-	else if (oldImageLayout == vk::ImageLayout::ePresentSrcKHR)
-	{
-		imageMemoryBarrier.srcAccessMask = vk::AccessFlagBits::eMemoryRead;
-	}
-
-	// next layout
-
-	if (newImageLayout == vk::ImageLayout::eTransferDstOptimal)
-	{
-		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-	}
-	else if (newImageLayout == vk::ImageLayout::eTransferSrcOptimal)
-	{
-		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eTransferRead; // | imageMemoryBarrier.srcAccessMask;
-	}
-	else if (newImageLayout == vk::ImageLayout::eColorAttachmentOptimal)
-	{
-		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-	}
-	else if (newImageLayout == vk::ImageLayout::eDepthStencilAttachmentOptimal)
-	{
-		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite;
-	}
-	else if (newImageLayout == vk::ImageLayout::eShaderReadOnlyOptimal)
-	{
-		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-	}
-	else if (newImageLayout == vk::ImageLayout::ePresentSrcKHR)
-	{
-		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eMemoryRead;
-	}
-	else if (newImageLayout == vk::ImageLayout::eGeneral)
-	{
-		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite;
-	}
-
-	if (imageMemoryBarrier.dstAccessMask == vk::AccessFlagBits::eTransferWrite ||
-		imageMemoryBarrier.dstAccessMask == vk::AccessFlagBits::eTransferWrite ||
-		imageMemoryBarrier.dstAccessMask == vk::AccessFlagBits::eTransferRead ||
-		imageMemoryBarrier.dstAccessMask == vk::AccessFlagBits::eColorAttachmentWrite ||
-		imageMemoryBarrier.dstAccessMask == vk::AccessFlagBits::eShaderRead ||
-		imageMemoryBarrier.srcAccessMask == vk::AccessFlagBits::eColorAttachmentWrite ||
-		imageMemoryBarrier.srcAccessMask == vk::AccessFlagBits::eTransferRead ||
-		imageMemoryBarrier.dstAccessMask == (vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite))
-	{
-		cmdbuffer.pipelineBarrier(
-			GetStageFlag(oldImageLayout), GetStageFlag(newImageLayout), vk::DependencyFlags(), nullptr, nullptr, imageMemoryBarrier);
-	}
-	else if (imageMemoryBarrier.dstAccessMask == vk::AccessFlagBits::eDepthStencilAttachmentWrite)
-	{
-		cmdbuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
-								  vk::PipelineStageFlagBits::eEarlyFragmentTests,
-								  vk::DependencyFlags(),
-								  nullptr,
-								  nullptr,
-								  imageMemoryBarrier);
-	}
-	else
+	BarrierBatcherVulkan batcher;
+	for (uint32_t i = 0; i < subresourceRange.levelCount; i++)
 	{
-		// Put barrier inside setup command buffer
-		cmdbuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
-								  vk::PipelineStageFlagBits::eTopOfPipe,
-								  vk::DependencyFlags(),
-								  nullptr,
-								  nullptr,
-								  imageMemoryBarrier);
+		batcher.AddImageBarrier(image,
+								subresourceRange.aspectMask,
+								subresourceRange.baseMipLevel + i,
+								subresourceRange.baseArrayLayer,
+								subresourceRange.layerCount,
+								oldImageLayout,
+								newImageLayout);
 	}
+	batcher.Flush(cmdbuffer);
 }
 
 uint32_t GetMemoryTypeIndex(vk::PhysicalDevice& phDevice, uint32_t bits, const vk::MemoryPropertyFlags& properties)
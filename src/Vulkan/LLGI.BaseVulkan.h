@@ -49,6 +49,7 @@ class TextureVulkan;
 class RenderPassVulkan;
 class RenderPassPipelineStateCacheVulkan;
 class QueryVulkan;
+class MemoryBlockVulkan;
 
 struct VulkanImageInfo
 {
@@ -57,6 +58,17 @@ struct VulkanImageInfo
 	VkFormat format;
 };
 
+/**
+	@brief	a range of device memory allocated with MemoryAllocatorVulkan
+*/
+struct MemoryAllocationVulkan
+{
+	vk::DeviceMemory Memory = nullptr;
+	vk::DeviceSize Offset = 0;
+	vk::DeviceSize Size = 0;
+	MemoryBlockVulkan* Block = nullptr;
+};
+
 class VulkanHelper
 {
 public:
@@ -69,15 +81,28 @@ class InternalBuffer
 {
 	std::shared_ptr<GraphicsVulkan> graphics_;
 	vk::Buffer buffer_;
-	vk::DeviceMemory devMem_;
+	MemoryAllocationVulkan allocation_;
 	bool isExternalResource_ = false;
 
 public:
 	InternalBuffer(GraphicsVulkan* graphics);
 	virtual ~InternalBuffer();
-	void Attach(vk::Buffer buffer, vk::DeviceMemory devMem, bool isExternalResource = false);
+
+	/**
+		@brief	create a buffer with memory from the allocator of graphics
+	*/
+	bool Initialize(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties);
+
+	void Attach(vk::Buffer buffer, const MemoryAllocationVulkan& allocation, bool isExternalResource = false);
 	vk::Buffer buffer() const { return buffer_; }
-	vk::DeviceMemory devMem() const { return devMem_; }
+	vk::DeviceMemory devMem() const { return allocation_.Memory; }
+	const MemoryAllocationVulkan& allocation() const { return allocation_; }
+
+	//! a pointer in a persistent mapping of host visible memory
+	void* GetMappedPointer() const;
+
+	void Flush(vk::DeviceSize offset, vk::DeviceSize size);
+	void Invalidate(vk::DeviceSize offset, vk::DeviceSize size);
 };
 
 class VulkanBuffer
@@ -87,13 +112,14 @@ public:
 	bool Initialize(GraphicsVulkan* graphics, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
 	void Dispose();
 	VkBuffer GetNativeBuffer() const { return nativeBuffer_; }
-	VkDeviceMemory GetNativeBufferMemory() const { return nativeBufferMemory_; }
+	VkDeviceMemory GetNativeBufferMemory() const { return static_cast<VkDeviceMemory>(allocation_.Memory); }
+	const MemoryAllocationVulkan& GetAllocation() const { return allocation_; }
 	VkDeviceSize GetSize() const { return size_; }
 
 private:
 	GraphicsVulkan* graphics_;
 	VkBuffer nativeBuffer_;
-	VkDeviceMemory nativeBufferMemory_;
+	MemoryAllocationVulkan allocation_;
 	VkDeviceSize size_;
 };
 
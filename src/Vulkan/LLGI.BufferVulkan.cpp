@@ -6,7 +6,20 @@ namespace LLGI
 
 BufferVulkan::BufferVulkan() {}
 
-BufferVulkan::~BufferVulkan() {}
+BufferVulkan::~BufferVulkan()
+{
+	if (graphics_ == nullptr)
+	{
+		return;
+	}
+
+	if (uploadTicket_ != 0)
+	{
+		graphics_->GetUploadManager()->Wait(uploadTicket_);
+	}
+
+	graphics_->GetUploadManager()->FreeStagingBuffer(stagingBuffer_);
+}
 
 bool BufferVulkan::Initialize(GraphicsVulkan* graphics, BufferUsageType usage, int32_t size)
 {
@@ -37,6 +50,12 @@ bool BufferVulkan::Initialize(GraphicsVulkan* graphics, BufferUsageType usage, i
 		memoryProperty = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
 	}
 
+	// a buffer on gpu is written with a copy from a staging buffer
+	if (memoryProperty == vk::MemoryPropertyFlagBits::eDeviceLocal)
+	{
+		vkUsage |= vk::BufferUsageFlagBits::eTransferDst;
+	}
+
 	if (BitwiseContains(usage, BufferUsageType::CopyDst))
 	{
 		vkUsage |= vk::BufferUsageFlagBits::eTransferDst;
@@ -68,20 +87,9 @@ bool BufferVulkan::Initialize(GraphicsVulkan* graphics, BufferUsageType usage, i
 		actualSize_ = static_cast<int32_t>(GetAlignedSize(size, 256)); // buffer size should be multiple of 256
 	}
 
+	if (!buffer_->Initialize(actualSize_, vkUsage, memoryProperty))
 	{
-		vk::BufferCreateInfo ComputeBufferInfo;
-		ComputeBufferInfo.size = actualSize_;
-		ComputeBufferInfo.usage = vkUsage;
-		vk::Buffer buffer = graphics_->GetDevice().createBuffer(ComputeBufferInfo);
-
-		vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(buffer);
-		vk::MemoryAllocateInfo memAlloc;
-		memAlloc.allocationSize = memReqs.size;
-		memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memReqs.memoryTypeBits, memoryProperty);
-		vk::DeviceMemory devMem = graphics_->GetDevice().allocateMemory(memAlloc);
-		graphics_->GetDevice().bindBufferMemory(buffer, devMem, 0);
-
-		buffer_->Attach(buffer, devMem);
+		return false;
 	}
 
 	return true;
@@ -102,7 +110,7 @@ bool BufferVulkan::InitializeAsShortTime(GraphicsVulkan* graphics, SingleFrameMe
 	BufferVulkan* poolBuffer;
 	if (memoryPool->GetConstantBuffer(alignedSize, poolBuffer, offset_))
 	{
-		buffer_->Attach(poolBuffer->buffer_->buffer(), poolBuffer->buffer_->devMem(), true);
+		buffer_->Attach(poolBuffer->buffer_->buffer(), poolBuffer->buffer_->allocation(), true);
 		size_ = size;
 		actualSize_ = alignedSize;
 
@@ -114,34 +122,116 @@ bool BufferVulkan::InitializeAsShortTime(GraphicsVulkan* graphics, SingleFrameMe
 	}
 }
 
-void* BufferVulkan::Lock()
-{
-	data = graphics_->GetDevice().mapMemory(buffer_->devMem(), offset_, actualSize_, vk::MemoryMapFlags());
-	return data;
-}
+void* BufferVulkan::Lock() { return Lock(0, actualSize_); }
 
 void* BufferVulkan::Lock(int32_t offset, int32_t size)
 {
-	data = graphics_->GetDevice().mapMemory(buffer_->devMem(), offset_ + offset, size, vk::MemoryMapFlags());
+	auto mapped = static_cast<uint8_t*>(buffer_->GetMappedPointer());
+	if (mapped == nullptr)
+	{
+		if (graphics_ == nullptr)
+		{
+			return nullptr;
+		}
+
+		auto uploadManager = graphics_->GetUploadManager();
+		uploadManager->FreeStagingBuffer(stagingBuffer_);
+		if (!uploadManager->AllocateStagingBuffer(size, stagingBuffer_))
+		{
+			return nullptr;
+		}
+
+		lockedOffset_ = offset_ + offset;
+		lockedSize_ = size;
+		data = stagingBuffer_.Pointer;
+		return data;
+	}
+
+	lockedOffset_ = offset_ + offset;
+	lockedSize_ = size;
+
+	// only a buffer which is read back contains data written by gpu
+	if (BitwiseContains(usage_, BufferUsageType::MapRead))
+	{
+		buffer_->Invalidate(lockedOffset_, lockedSize_);
+	}
+
+	data = mapped + lockedOffset_;
 	return data;
 }
 
-void BufferVulkan::Unlock() { graphics_->GetDevice().unmapMemory(buffer_->devMem()); }
+void BufferVulkan::Unlock()
+{
+	if (stagingBuffer_.Buffer)
+	{
+		const auto dstBuffer = buffer_->buffer();
+		const vk::DeviceSize dstOffset = lockedOffset_;
+		const vk::DeviceSize size = lockedSize_;
+
+		// a copy is submitted with other uploads before a command list which uses the buffer
+		uploadTicket_ = graphics_->GetUploadManager()->Record(
+			stagingBuffer_, [&](vk::CommandBuffer& commandBuffer, const StagingBufferVulkan& staging) -> void {
+				// commands which use the buffer before are completed
+				commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands,
+											  vk::PipelineStageFlagBits::eTransfer,
+											  vk::DependencyFlags(),
+											  0,
+											  nullptr,
+											  0,
+											  nullptr,
+											  0,
+											  nullptr);
+
+				vk::BufferCopy copyRegion;
+				copyRegion.srcOffset = staging.Offset;
+				copyRegion.dstOffset = dstOffset;
+				copyRegion.size = size;
+				commandBuffer.copyBuffer(staging.Buffer, dstBuffer, copyRegion);
+
+				vk::BufferMemoryBarrier bufferBarrier(vk::AccessFlagBits::eTransferWrite,
+													  vk::AccessFlagBits::eMemoryRead,
+													  VK_QUEUE_FAMILY_IGNORED,
+													  VK_QUEUE_FAMILY_IGNORED,
+													  dstBuffer,
+													  dstOffset,
+													  size);
+				commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+											  vk::PipelineStageFlagBits::eAllCommands,
+											  vk::DependencyFlags(),
+											  0,
+											  nullptr,
+											  1,
+											  &bufferBarrier,
+											  0,
+											  nullptr);
+			});
+
+		data = nullptr;
+		return;
+	}
+
+	buffer_->Flush(lockedOffset_, lockedSize_);
+	data = nullptr;
+}
 
 int32_t BufferVulkan::GetSize() { return size_; }
 
 void BufferVulkan::ResourceBarrier(vk::CommandBuffer& commandBuffer, const vk::AccessFlagBits& accessFlag)
+{
+	BarrierBatcherVulkan batcher;
+	ResourceBarrier(batcher, accessFlag);
+	batcher.Flush(commandBuffer);
+}
+
+void BufferVulkan::ResourceBarrier(BarrierBatcherVulkan& batcher, const vk::AccessFlagBits& accessFlag)
 {
 	if (accessFlag_ == accessFlag)
 	{
 		return;
 	}
 
-	vk::BufferMemoryBarrier bufferBarrier(
-		accessFlag, accessFlag_, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, buffer_->buffer(), 0, VK_WHOLE_SIZE);
-
-	vk::PipelineStageFlags stageFlags = vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eVertexShader;
-	commandBuffer.pipelineBarrier(stageFlags, stageFlags, vk::DependencyFlags(), 0, nullptr, 0, &bufferBarrier, 0, nullptr);
+	// a short time buffer shares a buffer with others, so only its range is synchronized
+	batcher.AddBufferBarrier(buffer_->buffer(), offset_, size_, accessFlag_, accessFlag);
 
 	accessFlag_ = accessFlag;
 }
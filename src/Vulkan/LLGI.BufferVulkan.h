@@ -2,6 +2,7 @@
 #pragma once
 
 #include "../LLGI.Buffer.h"
+#include "LLGI.BarrierBatcherVulkan.h"
 #include "LLGI.BaseVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
 
@@ -19,6 +20,16 @@ private:
 	int32_t actualSize_ = 0;
 	int32_t offset_ = 0;
 
+	//! a range which is flushed when it is unlocked
+	int32_t lockedOffset_ = 0;
+	int32_t lockedSize_ = 0;
+
+	//! a buffer on gpu is written through it while the buffer is locked
+	StagingBufferVulkan stagingBuffer_;
+
+	//! a ticket of the last upload which must be completed before the buffer is destroyed
+	uint64_t uploadTicket_ = 0;
+
 	// Should specify None for the first time.
 	vk::AccessFlagBits accessFlag_ = vk::AccessFlagBits::eHostRead;
 
@@ -40,6 +51,9 @@ public:
 	vk::Buffer GetBuffer() { return buffer_->buffer(); }
 
 	void ResourceBarrier(vk::CommandBuffer& commandBuffer, const vk::AccessFlagBits& accessFlag);
+
+	//! add a dependency from the last access into a batcher
+	void ResourceBarrier(BarrierBatcherVulkan& batcher, const vk::AccessFlagBits& accessFlag);
 };
 
 } // namespace LLGI
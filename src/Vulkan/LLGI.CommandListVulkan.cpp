@@ -4,6 +4,7 @@
 #include "LLGI.PipelineStateVulkan.h"
 #include "LLGI.TextureVulkan.h"
 #include "LLGI.QueryVulkan.h"
+#include <algorithm>
 
 namespace LLGI
 {
@@ -64,71 +65,72 @@ DescriptorPoolVulkan ::~DescriptorPoolVulkan()
 	}
 }
 
-const std::vector<vk::DescriptorSet>& DescriptorPoolVulkan::Get(PipelineStateVulkan* pip)
+vk::DescriptorSet DescriptorPoolVulkan::Find(const DescriptorSetKeyVulkan& key, bool isCompute) const
 {
-	if (cache.size() > static_cast<size_t>(offset))
+	const auto& keyToSet = isCompute ? computeKeyToSet_ : keyToSet_;
+	auto it = keyToSet.find(key);
+	if (it != keyToSet.end())
 	{
-		offset++;
-		return cache[offset - 1];
+		return it->second;
 	}
 
-	if (offset >= slotSizeMax_)
-	{
-		Log(LogType::Warning, "Lack of allocated memory.");
-		return dummySet_;
-	}
-
-	// TODO : improve it
-	auto& layout = pip->GetDescriptorSetLayout();
-	vk::DescriptorSetAllocateInfo allocateInfo;
-	allocateInfo.descriptorPool = descriptorPool_;
-	allocateInfo.descriptorSetCount = static_cast<int>(layout.size());
-	allocateInfo.pSetLayouts = layout.data();
-
-	std::vector<vk::DescriptorSet> descriptorSets = graphics_->GetDevice().allocateDescriptorSets(allocateInfo);
-	cache.push_back(descriptorSets);
-	offset++;
-	return cache[offset - 1];
+	return nullptr;
 }
 
-const std::vector<vk::DescriptorSet>& DescriptorPoolVulkan::GetCompute(PipelineStateVulkan* pip)
+vk::DescriptorSet DescriptorPoolVulkan::Allocate(const DescriptorSetKeyVulkan& key, vk::DescriptorSetLayout layout, bool isCompute)
 {
-	if (computeCache.size() > static_cast<size_t>(computeOffset))
+	assert(0 <= key.SetIndex && key.SetIndex < SetCountMax);
+
+	auto& cache = isCompute ? computeCaches_[key.SetIndex] : caches_[key.SetIndex];
+
+	if (cache.offset >= slotSizeMax_)
 	{
-		computeOffset++;
-		return computeCache[computeOffset - 1];
+		Log(LogType::Warning, "Lack of allocated memory.");
+		return nullptr;
 	}
 
-	if (computeOffset >= slotSizeMax_)
+	// descriptor sets allocated in previous frames are reused
+	if (cache.sets.size() <= static_cast<size_t>(cache.offset))
 	{
-		Log(LogType::Warning, "Lack of allocated memory.");
-		return dummySet_;
+		vk::DescriptorSetAllocateInfo allocateInfo;
+		allocateInfo.descriptorPool = isCompute ? computeDescriptorPool_ : descriptorPool_;
+		allocateInfo.descriptorSetCount = 1;
+		allocateInfo.pSetLayouts = &layout;
+
+		auto descriptorSets = graphics_->GetDevice().allocateDescriptorSets(allocateInfo);
+		cache.sets.push_back(descriptorSets[0]);
 	}
 
-	// TODO : improve it
-	auto& layout = pip->GetComputeDescriptorSetLayout();
-	vk::DescriptorSetAllocateInfo allocateInfo;
-	allocateInfo.descriptorPool = computeDescriptorPool_;
-	allocateInfo.descriptorSetCount = static_cast<int>(layout.size());
-	allocateInfo.pSetLayouts = layout.data();
+	auto descriptorSet = cache.sets[cache.offset];
+	cache.offset++;
 
-	std::vector<vk::DescriptorSet> descriptorSets = graphics_->GetDevice().allocateDescriptorSets(allocateInfo);
-	computeCache.push_back(descriptorSets);
-	computeOffset++;
-	return computeCache[computeOffset - 1];
+	auto& keyToSet = isCompute ? computeKeyToSet_ : keyToSet_;
+	keyToSet[key] = descriptorSet;
+	return descriptorSet;
 }
 
 void DescriptorPoolVulkan::Reset()
 {
-	offset = 0;
-	computeOffset = 0;
+	for (auto& cache : caches_)
+	{
+		cache.offset = 0;
+	}
+
+	for (auto& cache : computeCaches_)
+	{
+		cache.offset = 0;
+	}
+
+	keyToSet_.clear();
+	computeKeyToSet_.clear();
 }
 
-void CommandListVulkan::AssignConstantBuffersToCommandList(const vk::DescriptorSet& descriptorSet,
+void CommandListVulkan::AssignConstantBuffersToCommandList(DescriptorSetKeyVulkan& key,
 														   vk::WriteDescriptorSet* descriptorSets,
 														   int& descriptorSetOffset,
 														   vk::DescriptorBufferInfo* descBuffers,
-														   int& descBufferOffset)
+														   int& descBufferOffset,
+														   uint32_t* dynamicOffsets)
 {
 	for (size_t unit_ind = 0; unit_ind < constantBuffers_.size(); unit_ind++)
 	{
@@ -138,13 +140,18 @@ void CommandListVulkan::AssignConstantBuffersToCommandList(const vk::DescriptorS
 			continue;
 		}
 
+		// buffers in SingleFrameMemoryPool share VkBuffer, so a descriptor is shared and only a dynamic offset is changed
 		descBuffers[descBufferOffset].buffer = cb->GetBuffer();
-		descBuffers[descBufferOffset].offset = cb->GetOffset();
+		descBuffers[descBufferOffset].offset = 0;
 		descBuffers[descBufferOffset].range = cb->GetSize();
+		dynamicOffsets[unit_ind] = static_cast<uint32_t>(cb->GetOffset());
+
+		key.Add(unit_ind);
+		key.Add((uint64_t)(static_cast<VkBuffer>(cb->GetBuffer())));
+		key.Add(cb->GetSize());
 
 		vk::WriteDescriptorSet desc;
 		desc.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
-		desc.dstSet = descriptorSet;
 		desc.dstBinding = static_cast<int>(unit_ind);
 		desc.dstArrayElement = 0;
 		desc.pBufferInfo = &(descBuffers[descBufferOffset]);
@@ -157,11 +164,12 @@ void CommandListVulkan::AssignConstantBuffersToCommandList(const vk::DescriptorS
 	}
 }
 
-void CommandListVulkan::AssignComputeBuffersToCommandList(const vk::DescriptorSet& descriptorSet,
+void CommandListVulkan::AssignComputeBuffersToCommandList(DescriptorSetKeyVulkan& key,
 														  vk::WriteDescriptorSet* descriptorSets,
 														  int& descriptorSetOffset,
 														  vk::DescriptorBufferInfo* descBuffers,
-														  int& descBufferOffset)
+														  int& descBufferOffset,
+														  uint32_t* dynamicOffsets)
 {
 	for (int unit_ind = 0; unit_ind < NumComputeBuffer; unit_ind++)
 	{
@@ -174,12 +182,16 @@ void CommandListVulkan::AssignComputeBuffersToCommandList(const vk::DescriptorSe
 		auto cb = static_cast<BufferVulkan*>(cb_.computeBuffer);
 
 		descBuffers[descBufferOffset].buffer = cb->GetBuffer();
-		descBuffers[descBufferOffset].offset = cb->GetOffset();
+		descBuffers[descBufferOffset].offset = 0;
 		descBuffers[descBufferOffset].range = cb->GetSize();
+		dynamicOffsets[unit_ind] = static_cast<uint32_t>(cb->GetOffset());
+
+		key.Add(unit_ind);
+		key.Add((uint64_t)(static_cast<VkBuffer>(cb->GetBuffer())));
+		key.Add(cb->GetSize());
 
 		vk::WriteDescriptorSet desc;
 		desc.descriptorType = vk::DescriptorType::eStorageBufferDynamic;
-		desc.dstSet = descriptorSet;
 		desc.dstBinding = static_cast<int>(unit_ind);
 		desc.dstArrayElement = 0;
 		desc.pBufferInfo = &(descBuffers[descBufferOffset]);
@@ -192,7 +204,7 @@ void CommandListVulkan::AssignComputeBuffersToCommandList(const vk::DescriptorSe
 	}
 }
 
-void CommandListVulkan::AssignTexturesToCommandList(const vk::DescriptorSet& descriptorSet,
+void CommandListVulkan::AssignTexturesToCommandList(DescriptorSetKeyVulkan& key,
 													vk::WriteDescriptorSet* writeDescriptorSets,
 													int& writeDescriptorSetOffset,
 													vk::DescriptorImageInfo* descImages,
@@ -207,8 +219,6 @@ void CommandListVulkan::AssignTexturesToCommandList(const vk::DescriptorSet& des
 		}
 
 		auto texture = (TextureVulkan*)currentTextures_[unit_ind].texture;
-		auto wm = (int32_t)currentTextures_[unit_ind].wrapMode;
-		auto mm = (int32_t)currentTextures_[unit_ind].minMagFilter;
 		vk::DescriptorImageInfo imageInfo;
 
 		if (texture->GetType() == TextureType::Depth)
@@ -223,11 +233,15 @@ void CommandListVulkan::AssignTexturesToCommandList(const vk::DescriptorSet& des
 		}
 
 		imageInfo.imageView = texture->GetView();
-		imageInfo.sampler = samplers_[wm][mm];
+		imageInfo.sampler = graphics_->GetSamplerCache()->Get(currentTextures_[unit_ind].sampler);
 		descImages[descImageOffset] = imageInfo;
 
+		key.Add(unit_ind);
+		key.Add((uint64_t)(static_cast<VkImageView>(imageInfo.imageView)));
+		key.Add((uint64_t)(static_cast<VkSampler>(imageInfo.sampler)));
+		key.Add(static_cast<uint64_t>(imageInfo.imageLayout));
+
 		vk::WriteDescriptorSet desc;
-		desc.dstSet = descriptorSet;
 		desc.dstBinding = unit_ind;
 		desc.dstArrayElement = 0;
 		desc.pImageInfo = &descImages[descImageOffset];
@@ -243,88 +257,74 @@ void CommandListVulkan::AssignTexturesToCommandList(const vk::DescriptorSet& des
 
 CommandListVulkan::~CommandListVulkan()
 {
+	// command buffers and staging buffers must not be used by gpu anymore
+	if (!submittedValues_.empty())
+	{
+		graphics_->GetTimeline()->Wait(*std::max_element(submittedValues_.begin(), submittedValues_.end()));
+	}
+
 	if (commandBuffers_.size() > 0)
 	{
-		graphics_->GetDevice().freeCommandBuffers(graphics_->GetCommandPool(), commandBuffers_);
+		graphics_->GetDevice().freeCommandBuffers(isSubCommandList_ ? commandPool_ : graphics_->GetCommandPool(), commandBuffers_);
 	}
 	commandBuffers_.clear();
 
+	if (commandPool_)
+	{
+		graphics_->GetDevice().destroyCommandPool(commandPool_);
+		commandPool_ = nullptr;
+	}
+
 	descriptorPools.clear();
 
-	for (size_t i = 0; i < fences_.size(); i++)
+	for (size_t i = 0; i < stagingBuffers_.size(); i++)
 	{
-		if (fences_[i])
-		{
-			graphics_->GetDevice().destroyFence(fences_[i]);
-		}
+		ReleaseStagingBuffers(static_cast<int32_t>(i));
 	}
-	fences_.clear();
+	stagingBuffers_.clear();
 
-	for (int w = 0; w < 3; w++)
+	for (size_t i = 0; i < readbacks_.size(); i++)
 	{
-		for (int f = 0; f < 2; f++)
-		{
-			if (samplers_[w][f])
-			{
-				graphics_->GetDevice().destroySampler(samplers_[w][f]);
-			}
-		}
+		ReleaseReadbacks(static_cast<int32_t>(i));
 	}
+	readbacks_.clear();
 }
 
-bool CommandListVulkan::Initialize(GraphicsVulkan* graphics, int32_t drawingCount)
+bool CommandListVulkan::Initialize(GraphicsVulkan* graphics, int32_t drawingCount, bool isSubCommandList)
 {
 	SafeAddRef(graphics);
 	graphics_ = CreateSharedPtr(graphics);
+	isSubCommandList_ = isSubCommandList;
 
 	vk::CommandBufferAllocateInfo allocInfo;
 	allocInfo.commandPool = graphics->GetCommandPool();
 	allocInfo.level = vk::CommandBufferLevel::ePrimary;
 	allocInfo.commandBufferCount = graphics->GetSwapBufferCount();
+
+	if (isSubCommandList_)
+	{
+		// a command pool can't be used on multiple threads at the same time
+		vk::CommandPoolCreateInfo cmdPoolInfo;
+		cmdPoolInfo.queueFamilyIndex = graphics->GetQueueFamilyIndex();
+		cmdPoolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+		commandPool_ = graphics->GetDevice().createCommandPool(cmdPoolInfo);
+
+		allocInfo.commandPool = commandPool_;
+		allocInfo.level = vk::CommandBufferLevel::eSecondary;
+	}
+
 	commandBuffers_ = graphics->GetDevice().allocateCommandBuffers(allocInfo);
 
 	for (size_t i = 0; i < static_cast<size_t>(graphics_->GetSwapBufferCount()); i++)
 	{
 		auto dp = std::make_shared<DescriptorPoolVulkan>(graphics_, drawingCount, 4, 8, 8);
 		descriptorPools.push_back(dp);
-
-		fences_.emplace_back(vk::Fence{});
 	}
 
-	// Sampler
-	for (int w = 0; w < 3; w++)
-	{
-		for (int f = 0; f < 2; f++)
-		{
-			vk::Filter filters[2];
-			filters[0] = vk::Filter::eNearest;
-			filters[1] = vk::Filter::eLinear;
-
-			vk::SamplerAddressMode am[3];
-			am[0] = vk::SamplerAddressMode::eClampToEdge;
-			am[1] = vk::SamplerAddressMode::eRepeat;
-			am[2] = vk::SamplerAddressMode::eMirroredRepeat;
-
-			vk::SamplerCreateInfo samplerInfo;
-			samplerInfo.magFilter = filters[f];
-			samplerInfo.minFilter = filters[f];
-			samplerInfo.anisotropyEnable = false;
-			samplerInfo.maxAnisotropy = 1;
-			samplerInfo.addressModeU = am[w];
-			samplerInfo.addressModeV = am[w];
-			samplerInfo.addressModeW = am[w];
-			samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
-			samplerInfo.unnormalizedCoordinates = false;
-			samplerInfo.compareEnable = false;
-			samplerInfo.compareOp = vk::CompareOp::eAlways;
-			samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
-			samplerInfo.mipLodBias = 0.0f;
-			samplerInfo.minLod = 0.0f;
-			samplerInfo.maxLod = 8.0f;
-
-			samplers_[w][f] = graphics_->GetDevice().createSampler(samplerInfo);
-		}
-	}
+	submittedValues_.resize(graphics_->GetSwapBufferCount(), 0);
+
+	stagingBuffers_.resize(graphics_->GetSwapBufferCount());
+	readbacks_.resize(graphics_->GetSwapBufferCount());
 
 	currentSwapBufferIndex_ = -1;
 	return true;
@@ -335,36 +335,49 @@ void CommandListVulkan::Begin()
 	currentSwapBufferIndex_++;
 	currentSwapBufferIndex_ %= commandBuffers_.size();
 
-	if (fences_[currentSwapBufferIndex_])
+	// a sub command list is not submitted by itself and begins in BeginRenderPass
+	if (isSubCommandList_)
 	{
+		// the command buffer and descriptor sets may be still used by a main command list which executed them
 		WaitUntilCompleted();
-	}
-	else
-	{
-		fences_[currentSwapBufferIndex_] = graphics_->GetDevice().createFence(vk::FenceCreateFlags());
-	}
+		submittedValues_[currentSwapBufferIndex_] = 0;
 
-	const auto recetFencesResult = graphics_->GetDevice().resetFences(1, &(fences_[currentSwapBufferIndex_]));
-	if (recetFencesResult != vk::Result::eSuccess)
-	{
-		LLGI::Log(LogType::Error, "Failed to resetFences");
+		currentCommandBuffer_ = commandBuffers_[currentSwapBufferIndex_];
+		descriptorPools[currentSwapBufferIndex_]->Reset();
+		ResetBoundDescriptorSets();
+		CommandList::Begin();
 		return;
 	}
 
+	WaitUntilCompleted();
+
+	ReleaseReadbacks(currentSwapBufferIndex_);
+
+	// staging buffers are not read anymore
+	ReleaseStagingBuffers(currentSwapBufferIndex_);
+	submittedValues_[currentSwapBufferIndex_] = 0;
+	executedSubCommandLists_.clear();
+
 	currentCommandBuffer_ = commandBuffers_[currentSwapBufferIndex_];
 	currentCommandBuffer_.reset(vk::CommandBufferResetFlagBits::eReleaseResources);
 	vk::CommandBufferBeginInfo cmdBufInfo;
 	currentCommandBuffer_.begin(cmdBufInfo);
+	barrierBatcher_.Reset();
 
 	auto& dp = descriptorPools[currentSwapBufferIndex_];
 	dp->Reset();
+	ResetBoundDescriptorSets();
 
 	CommandList::Begin();
 }
 
 void CommandListVulkan::End()
 {
-	currentCommandBuffer_.end();
+	if (!isSubCommandList_)
+	{
+		FlushBarriers();
+		currentCommandBuffer_.end();
+	}
 	CommandList::End();
 }
 
@@ -375,16 +388,29 @@ bool CommandListVulkan::BeginWithPlatform(void* platformContextPtr)
 	currentSwapBufferIndex_++;
 	currentSwapBufferIndex_ %= commandBuffers_.size();
 
+	// a caller guarantees that commands in the swap buffer are completed, as the descriptor pool is reset below
+	ReleaseStagingBuffers(currentSwapBufferIndex_);
+
 	currentCommandBuffer_ = vk::CommandBuffer(ptr->commandBuffer);
+	barrierBatcher_.Reset();
+	executedSubCommandLists_.clear();
+	isBarrierDeferred_ = false;
 
 	auto& dp = descriptorPools[currentSwapBufferIndex_];
 	dp->Reset();
+	ResetBoundDescriptorSets();
 
 	return CommandList::BeginWithPlatform(platformContextPtr);
 }
 
 void CommandListVulkan::EndWithPlatform()
 {
+	FlushBarriers();
+
+	// the command buffer is submitted by a caller without Graphics::Execute, so uploads are submitted ahead of it here
+	graphics_->GetUploadManager()->Submit();
+
+	isBarrierDeferred_ = true;
 	currentCommandBuffer_ = vk::CommandBuffer();
 	CommandList::EndWithPlatform();
 }
@@ -415,6 +441,101 @@ void CommandListVulkan::SetScissor(int32_t x, int32_t y, int32_t width, int32_t
 	currentCommandBuffer_.setScissor(0, scissor);
 }
 
+bool CommandListVulkan::BindDescriptorSets(vk::PipelineBindPoint bindPoint,
+										   vk::PipelineLayout pipelineLayout,
+										   const vk::DescriptorSetLayout* setLayouts,
+										   const DescriptorSetKeyVulkan* keys,
+										   const uint32_t* dynamicOffsets,
+										   const uint32_t* dynamicOffsetCounts,
+										   int32_t setCount,
+										   vk::WriteDescriptorSet* writeDescriptorSets,
+										   const int* writeOffsets)
+{
+	const auto isCompute = bindPoint == vk::PipelineBindPoint::eCompute;
+	auto& bound = isCompute ? boundComputeDescriptorSets_ : boundDescriptorSets_;
+	auto& dp = descriptorPools[currentSwapBufferIndex_];
+
+	int32_t dirtiedFirst = setCount;
+	int32_t dirtiedLast = -1;
+	uint32_t dirtiedDynamicOffsetFirst = 0;
+	int writeCount = 0;
+
+	uint32_t dynamicOffsetFirst = 0;
+	for (int32_t i = 0; i < setCount; i++)
+	{
+		const auto dynamicOffsetBegin = dynamicOffsets + dynamicOffsetFirst;
+		const auto dynamicOffsetEnd = dynamicOffsetBegin + dynamicOffsetCounts[i];
+		dynamicOffsetFirst += dynamicOffsetCounts[i];
+
+		// descriptor set layouts are shared among pipelines by GraphicsVulkan, so bound sets are kept even if a pipeline is changed
+		if (bound.sets[i] && bound.keys[i] == keys[i] &&
+			std::equal(dynamicOffsetBegin, dynamicOffsetEnd, bound.dynamicOffsets.begin() + (dynamicOffsetBegin - dynamicOffsets)))
+		{
+			continue;
+		}
+
+		auto descriptorSet = dp->Find(keys[i], isCompute);
+
+		if (!descriptorSet)
+		{
+			descriptorSet = dp->Allocate(keys[i], setLayouts[i], isCompute);
+			if (!descriptorSet)
+			{
+				return false;
+			}
+
+			// pack writes of descriptor sets which are not cached
+			for (int w = writeOffsets[i]; w < writeOffsets[i + 1]; w++)
+			{
+				writeDescriptorSets[writeCount] = writeDescriptorSets[w];
+				writeDescriptorSets[writeCount].dstSet = descriptorSet;
+				writeCount++;
+			}
+		}
+
+		bound.sets[i] = descriptorSet;
+		bound.keys[i] = keys[i];
+		std::copy(dynamicOffsetBegin, dynamicOffsetEnd, bound.dynamicOffsets.begin() + (dynamicOffsetBegin - dynamicOffsets));
+
+		if (dirtiedLast < 0)
+		{
+			dirtiedFirst = i;
+			dirtiedDynamicOffsetFirst = static_cast<uint32_t>(dynamicOffsetBegin - dynamicOffsets);
+		}
+		dirtiedLast = i;
+	}
+
+	if (writeCount > 0)
+	{
+		graphics_->GetDevice().updateDescriptorSets(writeCount, writeDescriptorSets, 0, nullptr);
+	}
+
+	if (dirtiedFirst <= dirtiedLast)
+	{
+		uint32_t dynamicOffsetCount = 0;
+		for (int32_t i = dirtiedFirst; i <= dirtiedLast; i++)
+		{
+			dynamicOffsetCount += dynamicOffsetCounts[i];
+		}
+
+		currentCommandBuffer_.bindDescriptorSets(bindPoint,
+												 pipelineLayout,
+												 dirtiedFirst,
+												 dirtiedLast - dirtiedFirst + 1,
+												 &(bound.sets[dirtiedFirst]),
+												 dynamicOffsetCount,
+												 bound.dynamicOffsets.data() + dirtiedDynamicOffsetFirst);
+	}
+
+	return true;
+}
+
+void CommandListVulkan::ResetBoundDescriptorSets()
+{
+	boundDescriptorSets_.Reset();
+	boundComputeDescriptorSets_.Reset();
+}
+
 void CommandListVulkan::Draw(int32_t primitiveCount, int32_t instanceCount)
 {
 	if (!isInValidRenderPass_)
@@ -423,6 +544,18 @@ void CommandListVulkan::Draw(int32_t primitiveCount, int32_t instanceCount)
 		return;
 	}
 
+	if (isSubCommandListsExecuted_)
+	{
+		Log(LogType::Warning, "Draw must be called with sub command lists in this RenderPass.");
+		return;
+	}
+
+	// a pipeline state is being compiled
+	if (isPipelineStateSkipped_)
+	{
+		return;
+	}
+
 	BindingVertexBuffer vb_;
 	BindingIndexBuffer ib_;
 	PipelineState* pip_ = nullptr;
@@ -443,7 +576,7 @@ void CommandListVulkan::Draw(int32_t primitiveCount, int32_t instanceCount)
 	auto ib = static_cast<BufferVulkan*>(ib_.indexBuffer);
 	auto pip = static_cast<PipelineStateVulkan*>(pip_);
 
-	if (renderPass_ != nullptr && pip->GetRenderPassPipelineState()->Key != renderPass_->GetKey())
+	if (renderPass_ != nullptr && pip->GetRenderPassPipelineState()->GetKeyID() != renderPass_->GetKeyID())
 	{
 		Log(LogType::Warning, "Pipeline states between Pipeline state and render pass is different.");
 		return;
@@ -476,14 +609,6 @@ void CommandListVulkan::Draw(int32_t primitiveCount, int32_t instanceCount)
 		currentCommandBuffer_.bindIndexBuffer(ib->GetBuffer(), indexOffset, indexType);
 	}
 
-	auto& dp = descriptorPools[currentSwapBufferIndex_];
-
-	const auto& descriptorSets = dp->Get(pip);
-	if (descriptorSets.size() == 0)
-	{
-		return;
-	}
-
 	std::array<vk::WriteDescriptorSet, NumComputeBuffer + NumTexture + NumConstantBuffer> writeDescriptorSets;
 	int writeDescriptorIndex = 0;
 
@@ -493,18 +618,41 @@ void CommandListVulkan::Draw(int32_t primitiveCount, int32_t instanceCount)
 	std::array<vk::DescriptorImageInfo, NumTexture> descriptorImageInfos;
 	int descriptorImageIndex = 0;
 
-	AssignConstantBuffersToCommandList(
-		descriptorSets[0], writeDescriptorSets.data(), writeDescriptorIndex, descriptorBufferInfos.data(), descriptorBufferIndex);
-
-	AssignTexturesToCommandList(descriptorSets[1],
+	std::array<DescriptorSetKeyVulkan, 3> keys;
+	std::array<int, 4> writeOffsets;
+
+	// dynamic offsets of constant buffers and compute buffers
+	std::array<uint32_t, DynamicOffsetMax> dynamicOffsets;
+	dynamicOffsets.fill(0);
+
+	writeOffsets[0] = writeDescriptorIndex;
+	keys[0].Reset(0);
+	AssignConstantBuffersToCommandList(keys[0],
+									   writeDescriptorSets.data(),
+									   writeDescriptorIndex,
+									   descriptorBufferInfos.data(),
+									   descriptorBufferIndex,
+									   dynamicOffsets.data());
+
+	writeOffsets[1] = writeDescriptorIndex;
+	keys[1].Reset(1);
+	AssignTexturesToCommandList(keys[1],
 								writeDescriptorSets.data(),
 								writeDescriptorIndex,
 								descriptorImageInfos.data(),
 								descriptorImageIndex,
 								[](TextureUsageType t) -> bool { return true; });
 
-	AssignComputeBuffersToCommandList(
-		descriptorSets[2], writeDescriptorSets.data(), writeDescriptorIndex, descriptorBufferInfos.data(), descriptorBufferIndex);
+	writeOffsets[2] = writeDescriptorIndex;
+	keys[2].Reset(2);
+	AssignComputeBuffersToCommandList(keys[2],
+									  writeDescriptorSets.data(),
+									  writeDescriptorIndex,
+									  descriptorBufferInfos.data(),
+									  descriptorBufferIndex,
+									  dynamicOffsets.data() + NumConstantBuffer);
+
+	writeOffsets[3] = writeDescriptorIndex;
 
 	// Assign compute buffers
 	for (int unit_ind = 0; unit_ind < NumComputeBuffer; unit_ind++)
@@ -520,17 +668,21 @@ void CommandListVulkan::Draw(int32_t primitiveCount, int32_t instanceCount)
 		// cb->ResourceBarrier(currentCommandBuffer_, vk::AccessFlagBits::eTransferRead);
 	}
 
-	if (writeDescriptorIndex > 0)
+	const std::array<uint32_t, 3> dynamicOffsetCounts = {NumConstantBuffer, 0, NumComputeBuffer};
+
+	if (!BindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+							pip->GetPipelineLayout(),
+							pip->GetDescriptorSetLayout().data(),
+							keys.data(),
+							dynamicOffsets.data(),
+							dynamicOffsetCounts.data(),
+							static_cast<int32_t>(keys.size()),
+							writeDescriptorSets.data(),
+							writeOffsets.data()))
 	{
-		graphics_->GetDevice().updateDescriptorSets(writeDescriptorIndex, writeDescriptorSets.data(), 0, nullptr);
+		return;
 	}
 
-	std::array<uint32_t, 12> offsets;
-	offsets.fill(0);
-
-	currentCommandBuffer_.bindDescriptorSets(
-		vk::PipelineBindPoint::eGraphics, pip->GetPipelineLayout(), 0, 3, descriptorSets.data(), 12, offsets.data());
-
 	// assign a pipeline
 	if (isPipDirtied)
 	{
@@ -604,12 +756,14 @@ void CommandListVulkan::CopyTexture(
 	imageCopy[0].dstSubresource.layerCount = 1;
 	imageCopy[0].dstSubresource.baseArrayLayer = dstLayer;
 
-	srcTex->ResourceBarrier(currentCommandBuffer_, vk::ImageLayout::eTransferSrcOptimal);
-	dstTex->ResourceBarrier(currentCommandBuffer_, vk::ImageLayout::eTransferDstOptimal);
+	srcTex->ResourceBarrier(barrierBatcher_, vk::ImageLayout::eTransferSrcOptimal);
+	dstTex->ResourceBarrier(barrierBatcher_, vk::ImageLayout::eTransferDstOptimal);
+	FlushBarriers();
 	currentCommandBuffer_.copyImage(
 		srcTex->GetImage(), srcTex->GetImageLayouts()[0], dstTex->GetImage(), dstTex->GetImageLayouts()[0], imageCopy);
-	dstTex->ResourceBarrier(currentCommandBuffer_, vk::ImageLayout::eShaderReadOnlyOptimal);
-	srcTex->ResourceBarrier(currentCommandBuffer_, vk::ImageLayout::eShaderReadOnlyOptimal);
+	dstTex->ResourceBarrier(barrierBatcher_, vk::ImageLayout::eShaderReadOnlyOptimal);
+	srcTex->ResourceBarrier(barrierBatcher_, vk::ImageLayout::eShaderReadOnlyOptimal);
+	FlushLeftBarriers();
 
 	RegisterReferencedObject(src);
 	RegisterReferencedObject(dst);
@@ -624,8 +778,10 @@ void CommandListVulkan::GenerateMipMap(Texture* src)
 
 	for (int32_t i = 1; i < src->GetMipmapCount(); i++)
 	{
-		srcTex->ResourceBarrier(i - 1, currentCommandBuffer_, vk::ImageLayout::eTransferSrcOptimal);
-		srcTex->ResourceBarrier(i, currentCommandBuffer_, vk::ImageLayout::eTransferDstOptimal);
+		// a transition of the previous mip into eTransferSrcOptimal and one of this mip are recorded together
+		srcTex->ResourceBarrier(i - 1, barrierBatcher_, vk::ImageLayout::eTransferSrcOptimal);
+		srcTex->ResourceBarrier(i, barrierBatcher_, vk::ImageLayout::eTransferDstOptimal);
+		FlushBarriers();
 
 		vk::ImageBlit blit{};
 		blit.srcOffsets[0] = vk::Offset3D(0, 0, 0);
@@ -653,7 +809,8 @@ void CommandListVulkan::GenerateMipMap(Texture* src)
 		mipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
 	}
 
-	srcTex->ResourceBarrier(currentCommandBuffer_, vk::ImageLayout::eShaderReadOnlyOptimal);
+	srcTex->ResourceBarrier(barrierBatcher_, vk::ImageLayout::eShaderReadOnlyOptimal);
+	FlushLeftBarriers();
 }
 
 void CommandListVulkan::CopyBuffer(Buffer* src, Buffer* dst)
@@ -669,12 +826,225 @@ void CommandListVulkan::CopyBuffer(Buffer* src, Buffer* dst)
 	copyRegion.dstOffset = dstBuf->GetOffset();
 	copyRegion.size = srcBuf->GetSize();
 
-	dstBuf->ResourceBarrier(currentCommandBuffer_, vk::AccessFlagBits::eTransferWrite);
+	srcBuf->ResourceBarrier(barrierBatcher_, vk::AccessFlagBits::eTransferRead);
+	dstBuf->ResourceBarrier(barrierBatcher_, vk::AccessFlagBits::eTransferWrite);
+	FlushBarriers();
 	currentCommandBuffer_.copyBuffer(srcGpuBuf, dstGpuBuf, copyRegion);
-	dstBuf->ResourceBarrier(currentCommandBuffer_, vk::AccessFlagBits::eTransferRead);
+	dstBuf->ResourceBarrier(barrierBatcher_, vk::AccessFlagBits::eTransferRead);
+	FlushLeftBarriers();
+}
+
+void CommandListVulkan::SetImageData2D(Texture* texture, int32_t x, int32_t y, int32_t width, int32_t height, const void* data)
+{
+	if (isInRenderPass_)
+	{
+		Log(LogType::Error, "Please call SetImageData2D outside of RenderPass");
+		return;
+	}
+
+	if (isSubCommandList_)
+	{
+		Log(LogType::Error, "SetImageData2D can't be called with a sub command list.");
+		return;
+	}
+
+	const auto size = GetTextureMemorySize(texture->GetFormat(), Vec3I(width, height, 1));
+
+	// a staging buffer is kept until commands of this swap buffer are completed
+	StagingBufferVulkan stagingBuffer;
+	if (!graphics_->GetUploadManager()->AllocateStagingBuffer(size, stagingBuffer))
+	{
+		Log(LogType::Error, "SetImageData2D : Failed to allocate a staging buffer.");
+		return;
+	}
+
+	memcpy(stagingBuffer.Pointer, data, size);
+
+	// the texture may be in pending transitions
+	FlushBarriers();
+
+	auto tex = static_cast<TextureVulkan*>(texture);
+	tex->CopyFromBuffer(currentCommandBuffer_, stagingBuffer.Buffer, stagingBuffer.Offset, Vec3I(x, y, 0), Vec3I(width, height, 1), 0, 1);
+
+	stagingBuffers_[currentSwapBufferIndex_].emplace_back(stagingBuffer);
+
+	RegisterReferencedObject(texture);
+}
+
+void CommandListVulkan::ReleaseReadbacks(int32_t swapIndex)
+{
+	for (auto readback : readbacks_[swapIndex])
+	{
+		SafeRelease(readback);
+	}
+	readbacks_[swapIndex].clear();
+}
+
+void CommandListVulkan::ReleaseStagingBuffers(int32_t swapIndex)
+{
+	for (auto& stagingBuffer : stagingBuffers_[swapIndex])
+	{
+		graphics_->GetUploadManager()->FreeStagingBuffer(stagingBuffer);
+	}
+	stagingBuffers_[swapIndex].clear();
+}
+
+Readback* CommandListVulkan::ReadbackTexture(Texture* texture)
+{
+	if (isInRenderPass_ || isSubCommandList_)
+	{
+		Log(LogType::Error, "Please call ReadbackTexture outside of RenderPass with a command list which is not a sub command list");
+		return nullptr;
+	}
+
+	// a completion of the readback is not known without a value submitted in Graphics::Execute
+	if (GetDoesBeginWithPlatform())
+	{
+		Log(LogType::Error, "ReadbackTexture : A command list which begins with a platform is not supported.");
+		return nullptr;
+	}
+
+	auto tex = static_cast<TextureVulkan*>(texture);
+	if (IsDepthFormat(tex->GetFormat()))
+	{
+		Log(LogType::Error, "ReadbackTexture : A depth texture is not supported.");
+		return nullptr;
+	}
+
+	const auto size = tex->GetSizeAs2D();
+	auto readback = new ReadbackVulkan();
+	if (!readback->Initialize(graphics_.get(), GetTextureMemorySize(tex->GetFormat(), Vec3I(size.X, size.Y, 1))))
+	{
+		SafeRelease(readback);
+		return nullptr;
+	}
+
+	const auto& readbackBuffer = readback->GetReadbackBuffer();
+
+	vk::BufferImageCopy imageRegion;
+	imageRegion.bufferOffset = readbackBuffer.Offset;
+	imageRegion.bufferRowLength = 0;
+	imageRegion.bufferImageHeight = 0;
+	imageRegion.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+	imageRegion.imageSubresource.mipLevel = 0;
+	imageRegion.imageSubresource.baseArrayLayer = 0;
+	imageRegion.imageSubresource.layerCount = 1;
+	imageRegion.imageOffset = vk::Offset3D(0, 0, 0);
+	imageRegion.imageExtent = vk::Extent3D(static_cast<uint32_t>(size.X), static_cast<uint32_t>(size.Y), 1);
+
+	const auto oldLayout = tex->GetImageLayouts()[0];
+	tex->ResourceBarrier(0, barrierBatcher_, vk::ImageLayout::eTransferSrcOptimal);
+	FlushBarriers();
+	currentCommandBuffer_.copyImageToBuffer(tex->GetImage(), vk::ImageLayout::eTransferSrcOptimal, readbackBuffer.Buffer, imageRegion);
+	if (oldLayout != vk::ImageLayout::eUndefined)
+	{
+		tex->ResourceBarrier(0, barrierBatcher_, oldLayout);
+	}
+
+	// cpu reads it after the commands are completed
+	barrierBatcher_.AddBufferBarrier(readbackBuffer.Buffer,
+									 readbackBuffer.Offset,
+									 readbackBuffer.Size,
+									 vk::AccessFlagBits::eTransferWrite,
+									 vk::AccessFlagBits::eHostRead);
+	FlushLeftBarriers();
+
+	SafeAddRef(readback);
+	readbacks_[currentSwapBufferIndex_].emplace_back(readback);
+
+	RegisterReferencedObject(texture);
+	return readback;
+}
+
+Readback* CommandListVulkan::ReadbackBuffer(Buffer* buffer)
+{
+	if (isInRenderPass_ || isSubCommandList_)
+	{
+		Log(LogType::Error, "Please call ReadbackBuffer outside of RenderPass with a command list which is not a sub command list");
+		return nullptr;
+	}
+
+	if (GetDoesBeginWithPlatform())
+	{
+		Log(LogType::Error, "ReadbackBuffer : A command list which begins with a platform is not supported.");
+		return nullptr;
+	}
+
+	if (!BitwiseContains(buffer->GetBufferUsage(), BufferUsageType::CopySrc))
+	{
+		Log(LogType::Error, "ReadbackBuffer : A buffer must be created with BufferUsageType::CopySrc.");
+		return nullptr;
+	}
+
+	auto buf = static_cast<BufferVulkan*>(buffer);
+	auto readback = new ReadbackVulkan();
+	if (!readback->Initialize(graphics_.get(), buf->GetSize()))
+	{
+		SafeRelease(readback);
+		return nullptr;
+	}
+
+	const auto& readbackBuffer = readback->GetReadbackBuffer();
+
+	FlushBarriers();
+
+	// writes by previous commands are completed before copying
+	vk::MemoryBarrier memoryBarrier(vk::AccessFlagBits::eMemoryWrite, vk::AccessFlagBits::eTransferRead);
+	currentCommandBuffer_.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands,
+										  vk::PipelineStageFlagBits::eTransfer,
+										  vk::DependencyFlags(),
+										  1,
+										  &memoryBarrier,
+										  0,
+										  nullptr,
+										  0,
+										  nullptr);
+
+	vk::BufferCopy copyRegion;
+	copyRegion.srcOffset = buf->GetOffset();
+	copyRegion.dstOffset = readbackBuffer.Offset;
+	copyRegion.size = buf->GetSize();
+	currentCommandBuffer_.copyBuffer(buf->GetBuffer(), readbackBuffer.Buffer, copyRegion);
+
+	// cpu reads it after the commands are completed
+	barrierBatcher_.AddBufferBarrier(readbackBuffer.Buffer,
+									 readbackBuffer.Offset,
+									 readbackBuffer.Size,
+									 vk::AccessFlagBits::eTransferWrite,
+									 vk::AccessFlagBits::eHostRead);
+	FlushLeftBarriers();
+
+	SafeAddRef(readback);
+	readbacks_[currentSwapBufferIndex_].emplace_back(readback);
+
+	RegisterReferencedObject(buffer);
+	return readback;
 }
 
 void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
+{
+	if (isSubCommandList_)
+	{
+		BeginRenderPassAsSubCommandList(renderPass);
+		return;
+	}
+
+	BeginRenderPassInternal(renderPass, vk::SubpassContents::eInline);
+}
+
+void CommandListVulkan::BeginRenderPassWithSubCommandLists(RenderPass* renderPass)
+{
+	if (isSubCommandList_)
+	{
+		Log(LogType::Error, "A sub command list can't execute sub command lists.");
+		return;
+	}
+
+	BeginRenderPassInternal(renderPass, vk::SubpassContents::eSecondaryCommandBuffers);
+	isSubCommandListsExecuted_ = isInValidRenderPass_;
+}
+
+void CommandListVulkan::BeginRenderPassAsSubCommandList(RenderPass* renderPass)
 {
 	renderPass_ = static_cast<RenderPassVulkan*>(renderPass);
 	if (!renderPass_->GetIsValid())
@@ -683,69 +1053,108 @@ void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 		return;
 	}
 
-	vk::ClearColorValue clearColor(std::array<float, 4>{renderPass_->GetClearColor().R / 255.0f,
-														renderPass_->GetClearColor().G / 255.0f,
-														renderPass_->GetClearColor().B / 255.0f,
-														renderPass_->GetClearColor().A / 255.0f});
-	vk::ClearDepthStencilValue clearDepth(1.0f, 0);
+	// commands are continued from a render pass of a main command list
+	vk::CommandBufferInheritanceInfo inheritanceInfo;
+	inheritanceInfo.renderPass = renderPass_->GetRenderPassPipelineState()->GetRenderPass();
+	inheritanceInfo.subpass = 0;
+	inheritanceInfo.framebuffer = renderPass_->frameBuffer_;
+
+	vk::CommandBufferBeginInfo cmdBufInfo;
+	cmdBufInfo.flags = vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+	cmdBufInfo.pInheritanceInfo = &inheritanceInfo;
 
-	vk::ImageSubresourceRange colorSubRange;
-	colorSubRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-	colorSubRange.levelCount = 1;
-	colorSubRange.layerCount = 1;
+	currentCommandBuffer_.reset(vk::CommandBufferResetFlagBits::eReleaseResources);
+	currentCommandBuffer_.begin(cmdBufInfo);
+	ResetBoundDescriptorSets();
 
-	vk::ImageSubresourceRange depthSubRange;
-	depthSubRange.aspectMask = vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
-	depthSubRange.levelCount = 1;
-	depthSubRange.layerCount = 1;
+	// dynamic states are not inherited
+	vk::Viewport viewport = vk::Viewport(
+		0.0f, 0.0f, static_cast<float>(renderPass_->GetImageSize().X), static_cast<float>(renderPass_->GetImageSize().Y), 0.0f, 1.0f);
+	currentCommandBuffer_.setViewport(0, viewport);
 
+	vk::Rect2D scissor = vk::Rect2D(vk::Offset2D(), vk::Extent2D(renderPass_->GetImageSize().X, renderPass_->GetImageSize().Y));
+	currentCommandBuffer_.setScissor(0, scissor);
+
+	isInValidRenderPass_ = true;
+	CommandList::BeginRenderPass(renderPass);
+}
+
+void CommandListVulkan::BeginRenderPassInternal(RenderPass* renderPass, vk::SubpassContents contents)
+{
+	renderPass_ = static_cast<RenderPassVulkan*>(renderPass);
+	if (!renderPass_->GetIsValid())
+	{
+		CommandList::BeginRenderPass(renderPass);
+		return;
+	}
+
+	// values are ignored except for attachments which are cleared
 	vk::ClearValue clear_values[RenderTargetMax + 1];
-	int clearValueCount = 0;
+	int clearValueCount = renderPass_->GetRenderTextureCount();
 
-	if (renderPass->GetIsColorCleared())
+	for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
 	{
-		for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
-		{
-			clear_values[i].color = clearColor;
-			clearValueCount++;
-		}
+		const auto color = renderPass_->GetClearColor(i);
+		clear_values[i].color =
+			vk::ClearColorValue(std::array<float, 4>{color.R / 255.0f, color.G / 255.0f, color.B / 255.0f, color.A / 255.0f});
 	}
 
-	if (renderPass_->GetHasDepthTexture() && renderPass->GetIsDepthCleared())
+	if (renderPass_->GetHasDepthTexture())
 	{
-		clear_values[renderPass_->GetRenderTextureCount()].depthStencil = clearDepth;
+		clear_values[clearValueCount].depthStencil =
+			vk::ClearDepthStencilValue(renderPass_->GetClearDepth(), renderPass_->GetClearStencil());
 		clearValueCount++;
 	}
 
-	clear_values[renderPass_->GetRenderTextureCount()].depthStencil = clearDepth;
+	// loaded attachments must be in the layouts which the render pass expects
+	const auto& initialLayouts = renderPass_->GetRenderPassPipelineState()->initialLayouts_;
+	for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
+	{
+		if (initialLayouts.at(i) != vk::ImageLayout::eUndefined)
+		{
+			auto t = static_cast<TextureVulkan*>(renderPass_->GetRenderTexture(i));
+			t->ResourceBarrier(barrierBatcher_, initialLayouts.at(i));
+		}
+	}
 
 	if (renderPass_->GetHasDepthTexture())
 	{
 		auto t = static_cast<TextureVulkan*>(renderPass_->GetDepthTexture());
-		t->ResourceBarrier(currentCommandBuffer_, vk::ImageLayout::eDepthStencilAttachmentOptimal);
+		t->ResourceBarrier(barrierBatcher_, vk::ImageLayout::eDepthStencilAttachmentOptimal);
 	}
 
+	// barriers cannot be recorded in the render pass
+	FlushBarriers();
+
 	// begin renderpass
 	vk::RenderPassBeginInfo renderPassBeginInfo;
 	renderPassBeginInfo.framebuffer = renderPass_->frameBuffer_;
-	renderPassBeginInfo.renderPass = renderPass_->renderPassPipelineState->GetRenderPass();
+	renderPassBeginInfo.renderPass = renderPass_->GetRenderPassPipelineState()->GetRenderPass();
 	renderPassBeginInfo.renderArea.extent = vk::Extent2D(renderPass_->GetImageSize().X, renderPass_->GetImageSize().Y);
 	renderPassBeginInfo.clearValueCount = clearValueCount;
 	renderPassBeginInfo.pClearValues = clear_values;
-	currentCommandBuffer_.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
+	currentCommandBuffer_.beginRenderPass(renderPassBeginInfo, contents);
 
-	vk::Viewport viewport = vk::Viewport(
-		0.0f, 0.0f, static_cast<float>(renderPass_->GetImageSize().X), static_cast<float>(renderPass_->GetImageSize().Y), 0.0f, 1.0f);
-	currentCommandBuffer_.setViewport(0, viewport);
-
-	vk::Rect2D scissor = vk::Rect2D(vk::Offset2D(), vk::Extent2D(renderPass_->GetImageSize().X, renderPass_->GetImageSize().Y));
-	currentCommandBuffer_.setScissor(0, scissor);
+	// only executeCommands is allowed in a render pass with secondary command buffers
+	if (contents == vk::SubpassContents::eInline)
+	{
+		vk::Viewport viewport = vk::Viewport(0.0f,
+											 0.0f,
+											 static_cast<float>(renderPass_->GetImageSize().X),
+											 static_cast<float>(renderPass_->GetImageSize().Y),
+											 0.0f,
+											 1.0f);
+		currentCommandBuffer_.setViewport(0, viewport);
+
+		vk::Rect2D scissor = vk::Rect2D(vk::Offset2D(), vk::Extent2D(renderPass_->GetImageSize().X, renderPass_->GetImageSize().Y));
+		currentCommandBuffer_.setScissor(0, scissor);
+	}
 
 	auto layoutOffset = 0;
 	for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
 	{
 		auto t = static_cast<TextureVulkan*>(renderPass_->GetRenderTexture(i));
-		t->ChangeImageLayout(renderPass_->renderPassPipelineState->finalLayouts_.at(i));
+		t->ChangeImageLayout(renderPass_->GetRenderPassPipelineState()->finalLayouts_.at(i));
 	}
 
 	layoutOffset += renderPass_->GetRenderTextureCount();
@@ -753,7 +1162,7 @@ void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 	if (renderPass_->GetHasDepthTexture())
 	{
 		auto t = static_cast<TextureVulkan*>(renderPass_->GetDepthTexture());
-		t->ChangeImageLayout(renderPass_->renderPassPipelineState->finalLayouts_.at(layoutOffset));
+		t->ChangeImageLayout(renderPass_->GetRenderPassPipelineState()->finalLayouts_.at(layoutOffset));
 	}
 
 	if (renderPass_->GetHasDepthTexture())
@@ -763,7 +1172,7 @@ void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 
 	if (auto t = static_cast<TextureVulkan*>(renderPass_->GetResolvedRenderTexture()))
 	{
-		t->ChangeImageLayout(renderPass_->renderPassPipelineState->finalLayouts_.at(layoutOffset));
+		t->ChangeImageLayout(renderPass_->GetRenderPassPipelineState()->finalLayouts_.at(layoutOffset));
 	}
 
 	isInValidRenderPass_ = true;
@@ -775,16 +1184,90 @@ void CommandListVulkan::EndRenderPass()
 	// end renderpass
 	if (isInValidRenderPass_)
 	{
-		currentCommandBuffer_.endRenderPass();
+		if (isSubCommandList_)
+		{
+			currentCommandBuffer_.end();
+		}
+		else
+		{
+			currentCommandBuffer_.endRenderPass();
+		}
 	}
 	isInValidRenderPass_ = false;
+	isSubCommandListsExecuted_ = false;
 	renderPass_ = nullptr;
 	CommandList::EndRenderPass();
 }
 
+void CommandListVulkan::ExecuteSubCommandLists(CommandList** subCommandLists, int32_t count)
+{
+	if (!isInValidRenderPass_)
+	{
+		return;
+	}
+
+	if (!isSubCommandListsExecuted_)
+	{
+		Log(LogType::Error, "ExecuteSubCommandLists must be called in a RenderPass which begins with BeginRenderPassWithSubCommandLists.");
+		return;
+	}
+
+	std::vector<vk::CommandBuffer> commandBuffers;
+	commandBuffers.reserve(count);
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		auto subCommandList = static_cast<CommandListVulkan*>(subCommandLists[i]);
+		if (subCommandList == nullptr || !subCommandList->isSubCommandList_)
+		{
+			Log(LogType::Error, "ExecuteSubCommandLists : It is not a sub command list.");
+			continue;
+		}
+
+		commandBuffers.emplace_back(subCommandList->GetCommandBuffer());
+		executedSubCommandLists_.emplace_back(subCommandList);
+
+		// referenced objects in sub command lists are kept until this command list is completed
+		RegisterReferencedObject(subCommandList);
+	}
+
+	if (commandBuffers.size() > 0)
+	{
+		currentCommandBuffer_.executeCommands(commandBuffers);
+
+		// states bound to this command buffer become undefined after executeCommands
+		ResetBoundDescriptorSets();
+		SetBoundStatesDirtied();
+	}
+}
+
 vk::CommandBuffer CommandListVulkan::GetCommandBuffer() const { return currentCommandBuffer_; }
 
-vk::Fence CommandListVulkan::GetFence() const { return fences_[currentSwapBufferIndex_]; }
+void CommandListVulkan::FlushBarriers() { barrierBatcher_.Flush(currentCommandBuffer_); }
+
+void CommandListVulkan::FlushLeftBarriers()
+{
+	if (!isBarrierDeferred_)
+	{
+		FlushBarriers();
+	}
+}
+
+void CommandListVulkan::SetSubmittedValue(uint64_t value)
+{
+	// a sub command list may be executed by multiple main command lists
+	submittedValues_[currentSwapBufferIndex_] = std::max(submittedValues_[currentSwapBufferIndex_], value);
+
+	for (auto subCommandList : executedSubCommandLists_)
+	{
+		subCommandList->SetSubmittedValue(value);
+	}
+
+	for (auto readback : readbacks_[currentSwapBufferIndex_])
+	{
+		readback->SetSubmittedValue(value);
+	}
+}
 
 bool CommandListVulkan::ResetQuery(Query* query)
 {
@@ -845,6 +1328,12 @@ void CommandListVulkan::EndComputePass() {}
 
 void CommandListVulkan::Dispatch(int32_t groupX, int32_t groupY, int32_t groupZ, int32_t threadX, int32_t threadY, int32_t threadZ)
 {
+	// a pipeline state is being compiled
+	if (isPipelineStateSkipped_)
+	{
+		return;
+	}
+
 	PipelineState* pip_ = nullptr;
 
 	bool isPipDirtied = false;
@@ -855,14 +1344,6 @@ void CommandListVulkan::Dispatch(int32_t groupX, int32_t groupY, int32_t groupZ,
 
 	auto pip = static_cast<PipelineStateVulkan*>(pip_);
 
-	auto& dp = descriptorPools[currentSwapBufferIndex_];
-
-	const auto& descriptorSets = dp->GetCompute(pip);
-	if (descriptorSets.size() == 0)
-	{
-		return;
-	}
-
 	std::array<vk::WriteDescriptorSet, NumConstantBuffer + NumTexture * 2 + NumComputeBuffer> writeDescriptorSets;
 	int writeDescriptorIndex = 0;
 
@@ -875,16 +1356,57 @@ void CommandListVulkan::Dispatch(int32_t groupX, int32_t groupY, int32_t groupZ,
 	std::array<vk::DescriptorImageInfo, NumTexture> descriptorImageStorageInfos;
 	int descriptorImageStorageIndex = 0;
 
-	AssignConstantBuffersToCommandList(
-		descriptorSets[0], writeDescriptorSets.data(), writeDescriptorIndex, descriptorBufferInfos.data(), descriptorBufferIndex);
-
-	AssignTexturesToCommandList(descriptorSets[1],
+	std::array<DescriptorSetKeyVulkan, 4> keys;
+	std::array<int, 5> writeOffsets;
+
+	// dynamic offsets of constant buffers and compute buffers
+	std::array<uint32_t, DynamicOffsetMax> dynamicOffsets;
+	dynamicOffsets.fill(0);
+
+	writeOffsets[0] = writeDescriptorIndex;
+	keys[0].Reset(0);
+	AssignConstantBuffersToCommandList(keys[0],
+									   writeDescriptorSets.data(),
+									   writeDescriptorIndex,
+									   descriptorBufferInfos.data(),
+									   descriptorBufferIndex,
+									   dynamicOffsets.data());
+
+	writeOffsets[1] = writeDescriptorIndex;
+	keys[1].Reset(1);
+	AssignTexturesToCommandList(keys[1],
 								writeDescriptorSets.data(),
 								writeDescriptorIndex,
 								descriptorImageInfos.data(),
 								descriptorImageIndex,
 								[](TextureUsageType t) -> bool { return !BitwiseContains(t, TextureUsageType::Storage); });
 
+	writeOffsets[2] = writeDescriptorIndex;
+	keys[2].Reset(2);
+	AssignComputeBuffersToCommandList(keys[2],
+									  writeDescriptorSets.data(),
+									  writeDescriptorIndex,
+									  descriptorBufferInfos.data(),
+									  descriptorBufferIndex,
+									  dynamicOffsets.data() + NumConstantBuffer);
+
+	// Assign compute buffers
+	for (int unit_ind = 0; unit_ind < NumComputeBuffer; unit_ind++)
+	{
+		BindingComputeBuffer cb_;
+		GetCurrentComputeBuffer(unit_ind, cb_);
+
+		if (cb_.computeBuffer == nullptr)
+			continue;
+
+		// Cannot change here
+		// auto cb = static_cast<BufferVulkan*>(cb_.computeBuffer);
+		// cb->ResourceBarrier(currentCommandBuffer_, vk::AccessFlagBits::eTransferRead);
+	}
+
+	writeOffsets[3] = writeDescriptorIndex;
+	keys[3].Reset(3);
+
 	// Assign textures
 	for (int unit_ind = 0; unit_ind < static_cast<int32_t>(currentTextures_.size()); unit_ind++)
 	{
@@ -896,15 +1418,17 @@ void CommandListVulkan::Dispatch(int32_t groupX, int32_t groupY, int32_t groupZ,
 
 		const auto targetImageLayout = vk::ImageLayout::eGeneral;
 		auto texture = (TextureVulkan*)currentTextures_[unit_ind].texture;
-		texture->ResourceBarrier(currentCommandBuffer_, targetImageLayout);
+		texture->ResourceBarrier(barrierBatcher_, targetImageLayout);
 
 		vk::DescriptorImageInfo imageInfo;
 		imageInfo.imageLayout = targetImageLayout;
 		imageInfo.imageView = texture->GetView();
 		descriptorImageStorageInfos[descriptorImageStorageIndex] = imageInfo;
 
+		keys[3].Add(unit_ind);
+		keys[3].Add((uint64_t)(static_cast<VkImageView>(imageInfo.imageView)));
+
 		vk::WriteDescriptorSet desc;
-		desc.dstSet = descriptorSets[3];
 		desc.dstBinding = unit_ind;
 		desc.dstArrayElement = 0;
 		desc.pImageInfo = &descriptorImageStorageInfos[descriptorImageStorageIndex];
@@ -917,40 +1441,30 @@ void CommandListVulkan::Dispatch(int32_t groupX, int32_t groupY, int32_t groupZ,
 		writeDescriptorIndex++;
 	}
 
-	AssignComputeBuffersToCommandList(
-		descriptorSets[2], writeDescriptorSets.data(), writeDescriptorIndex, descriptorBufferInfos.data(), descriptorBufferIndex);
-
-	// Assign compute buffers
-	for (int unit_ind = 0; unit_ind < NumComputeBuffer; unit_ind++)
-	{
-		BindingComputeBuffer cb_;
-		GetCurrentComputeBuffer(unit_ind, cb_);
-
-		if (cb_.computeBuffer == nullptr)
-			continue;
+	writeOffsets[4] = writeDescriptorIndex;
 
-		// Cannot change here
-		// auto cb = static_cast<BufferVulkan*>(cb_.computeBuffer);
-		// cb->ResourceBarrier(currentCommandBuffer_, vk::AccessFlagBits::eTransferRead);
-	}
+	const std::array<uint32_t, 4> dynamicOffsetCounts = {NumConstantBuffer, 0, NumComputeBuffer, 0};
 
-	if (writeDescriptorIndex > 0)
+	if (!BindDescriptorSets(vk::PipelineBindPoint::eCompute,
+							pip->GetComputePipelineLayout(),
+							pip->GetComputeDescriptorSetLayout().data(),
+							keys.data(),
+							dynamicOffsets.data(),
+							dynamicOffsetCounts.data(),
+							static_cast<int32_t>(keys.size()),
+							writeDescriptorSets.data(),
+							writeOffsets.data()))
 	{
-		graphics_->GetDevice().updateDescriptorSets(writeDescriptorIndex, writeDescriptorSets.data(), 0, nullptr);
+		return;
 	}
 
-	std::array<uint32_t, 12> offsets;
-	offsets.fill(0);
-
-	currentCommandBuffer_.bindDescriptorSets(
-		vk::PipelineBindPoint::eCompute, pip->GetComputePipelineLayout(), 0, 4, descriptorSets.data(), 12, offsets.data());
-
 	// assign a pipeline
 	if (isPipDirtied)
 	{
 		currentCommandBuffer_.bindPipeline(vk::PipelineBindPoint::eCompute, pip->GetComputePipeline());
 	}
 
+	FlushBarriers();
 	currentCommandBuffer_.dispatch(groupX, groupY, groupZ);
 
 	CommandList::Dispatch(groupX, groupY, groupZ, threadX, threadY, threadZ);
@@ -958,13 +1472,12 @@ void CommandListVulkan::Dispatch(int32_t groupX, int32_t groupY, int32_t groupZ,
 
 void CommandListVulkan::WaitUntilCompleted()
 {
+	// a value of a sub command list is set when a main command list which executes it is submitted
 	if (currentSwapBufferIndex_ >= 0)
 	{
-		vk::Result fenceRes =
-			graphics_->GetDevice().waitForFences(fences_[currentSwapBufferIndex_], VK_TRUE, std::numeric_limits<int>::max());
-		if (fenceRes != vk::Result::eSuccess)
+		if (!graphics_->GetTimeline()->Wait(submittedValues_[currentSwapBufferIndex_]))
 		{
-			throw "Invalid waitForFences";
+			Log(LogType::Error, "Failed to wait for commands.");
 		}
 	}
 }
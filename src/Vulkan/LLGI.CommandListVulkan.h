@@ -1,31 +1,105 @@
 #pragma once
 
 #include "../LLGI.CommandList.h"
+#include "../Utils/LLGI.FixedSizeVector.h"
+#include "../Utils/LLGI.Hash.h"
+#include "LLGI.BarrierBatcherVulkan.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.ReadbackVulkan.h"
+#include "LLGI.UploadManagerVulkan.h"
+#include <unordered_map>
 
 namespace LLGI
 {
 
+/**
+	@brief	a key of resources which are written into a descriptor set
+*/
+struct DescriptorSetKeyVulkan
+{
+	static constexpr int32_t ValueMax = 4 * NumTexture;
+
+	int32_t SetIndex = 0;
+	FixedSizeVector<uint64_t, ValueMax> Values;
+
+	void Reset(int32_t setIndex)
+	{
+		SetIndex = setIndex;
+		Values.resize(0);
+	}
+
+	void Add(uint64_t value)
+	{
+		Values.resize(Values.size() + 1);
+		Values.at(Values.size() - 1) = value;
+	}
+
+	bool operator==(const DescriptorSetKeyVulkan& value) const { return SetIndex == value.SetIndex && Values == value.Values; }
+
+	bool operator!=(const DescriptorSetKeyVulkan& value) const { return !(*this == value); }
+
+	struct Hash
+	{
+		typedef std::size_t result_type;
+
+		std::size_t operator()(const DescriptorSetKeyVulkan& key) const
+		{
+			uint64_t hash = 0;
+			CombineHash(hash, static_cast<uint64_t>(key.SetIndex));
+			CombineHash(hash, key.Values.size());
+
+			for (size_t i = 0; i < key.Values.size(); i++)
+			{
+				CombineHash(hash, key.Values.at(i));
+			}
+
+			return static_cast<std::size_t>(hash);
+		}
+	};
+};
+
+/**
+	@brief	descriptor sets in a frame
+	@note
+	A descriptor set is allocated per set index and cached with resources written into it until Reset.
+	So draws with the same resources share a descriptor set without updateDescriptorSets.
+*/
 class DescriptorPoolVulkan
 {
 private:
+	static constexpr int32_t SetCountMax = 4;
+
+	struct SetCache
+	{
+		std::vector<vk::DescriptorSet> sets;
+		int32_t offset = 0;
+	};
+
 	std::shared_ptr<GraphicsVulkan> graphics_;
 	vk::DescriptorPool descriptorPool_ = nullptr;
-	int32_t offset = 0;
-	std::vector<std::vector<vk::DescriptorSet>> cache;
+	std::array<SetCache, SetCountMax> caches_;
+	std::unordered_map<DescriptorSetKeyVulkan, vk::DescriptorSet, DescriptorSetKeyVulkan::Hash> keyToSet_;
 	int32_t slotSizeMax_;
-	std::vector<vk::DescriptorSet> dummySet_;
 
 	vk::DescriptorPool computeDescriptorPool_ = nullptr;
-	int32_t computeOffset = 0;
-	std::vector<std::vector<vk::DescriptorSet>> computeCache;
+	std::array<SetCache, SetCountMax> computeCaches_;
+	std::unordered_map<DescriptorSetKeyVulkan, vk::DescriptorSet, DescriptorSetKeyVulkan::Hash> computeKeyToSet_;
 
 public:
 	DescriptorPoolVulkan(
 		std::shared_ptr<GraphicsVulkan> graphics, int32_t slot_size_max, int32_t constant_size, int32_t texture_size, int32_t storage_size);
 	virtual ~DescriptorPoolVulkan();
-	const std::vector<vk::DescriptorSet>& Get(PipelineStateVulkan* pip);
-	const std::vector<vk::DescriptorSet>& GetCompute(PipelineStateVulkan* pip);
+
+	/**
+		@brief	find a descriptor set which has been written with resources specified by a key in this frame
+	*/
+	vk::DescriptorSet Find(const DescriptorSetKeyVulkan& key, bool isCompute) const;
+
+	/**
+		@brief	allocate a descriptor set and register it with a key. The descriptor set must be written by a caller.
+	*/
+	vk::DescriptorSet Allocate(const DescriptorSetKeyVulkan& key, vk::DescriptorSetLayout layout, bool isCompute);
+
 	void Reset();
 };
 
@@ -42,25 +116,99 @@ private:
 	std::vector<vk::CommandBuffer> commandBuffers_;
 	std::vector<std::shared_ptr<DescriptorPoolVulkan>> descriptorPools;
 	int32_t currentSwapBufferIndex_;
-	std::vector<vk::Fence> fences_;
-	vk::Sampler samplers_[3][2];
+
+	//! values of the timeline which are signaled when commands in each swap buffer are completed
+	std::vector<uint64_t> submittedValues_;
+
+	//! staging buffers which are read by commands in each swap buffer
+	std::vector<std::vector<StagingBufferVulkan>> stagingBuffers_;
+
+	//! readbacks which are completed with commands in each swap buffer
+	std::vector<std::vector<ReadbackVulkan*>> readbacks_;
+
+	void ReleaseReadbacks(int32_t swapIndex);
+
+	void ReleaseStagingBuffers(int32_t swapIndex);
+
+	/**
+		@brief	barriers which are recorded right before a command which uses resources in them
+		@note
+		When a command list begins with a platform, a render pass may be begun outside of it,
+		so barriers which are left by an operation are flushed at the end of the operation.
+	*/
+	BarrierBatcherVulkan barrierBatcher_;
+	bool isBarrierDeferred_ = true;
+
+	void FlushBarriers();
+
+	//! flush barriers which are left by an operation if they cannot be deferred until a next command
+	void FlushLeftBarriers();
+
+	//! a sub command list records secondary command buffers with its own pool to record on another thread
+	bool isSubCommandList_ = false;
+	vk::CommandPool commandPool_ = nullptr;
+
+	//! sub command lists which are executed in the current command buffer, whose submitted values are set with it
+	std::vector<CommandListVulkan*> executedSubCommandLists_;
 
 	RenderPassVulkan* renderPass_ = nullptr;
 	bool isInValidRenderPass_ = false;
+	bool isSubCommandListsExecuted_ = false;
+
+	//! the number of dynamic offsets of constant buffers and compute buffers
+	static constexpr int32_t DynamicOffsetMax = NumConstantBuffer + NumComputeBuffer;
+
+	//! descriptor sets which are bound to a command buffer currently
+	struct BoundDescriptorSets
+	{
+		std::array<vk::DescriptorSet, 4> sets;
+		std::array<DescriptorSetKeyVulkan, 4> keys;
+		std::array<uint32_t, DynamicOffsetMax> dynamicOffsets;
+
+		void Reset() { sets.fill(nullptr); }
+	};
 
-	void AssignConstantBuffersToCommandList(const vk::DescriptorSet& descriptorSet,
+	BoundDescriptorSets boundDescriptorSets_;
+	BoundDescriptorSets boundComputeDescriptorSets_;
+
+	/**
+		@brief	bind descriptor sets whose keys are changed since the last bind
+		@note
+		dynamicOffsets are sorted by set index and a set i has dynamicOffsetCounts[i] offsets.
+		writeDescriptorSets are sorted by set index and writeOffsets[i] is the first index of set i.
+		writeDescriptorSets are written only for descriptor sets which are not cached.
+	*/
+	bool BindDescriptorSets(vk::PipelineBindPoint bindPoint,
+							vk::PipelineLayout pipelineLayout,
+							const vk::DescriptorSetLayout* setLayouts,
+							const DescriptorSetKeyVulkan* keys,
+							const uint32_t* dynamicOffsets,
+							const uint32_t* dynamicOffsetCounts,
+							int32_t setCount,
+							vk::WriteDescriptorSet* writeDescriptorSets,
+							const int* writeOffsets);
+
+	void ResetBoundDescriptorSets();
+
+	void BeginRenderPassInternal(RenderPass* renderPass, vk::SubpassContents contents);
+
+	void BeginRenderPassAsSubCommandList(RenderPass* renderPass);
+
+	void AssignConstantBuffersToCommandList(DescriptorSetKeyVulkan& key,
 											vk::WriteDescriptorSet* descriptorSets,
 											int& descriptorSetOffset,
 											vk::DescriptorBufferInfo* descBuffers,
-											int& descBufferOffset);
+											int& descBufferOffset,
+											uint32_t* dynamicOffsets);
 
-	void AssignComputeBuffersToCommandList(const vk::DescriptorSet& descriptorSet,
+	void AssignComputeBuffersToCommandList(DescriptorSetKeyVulkan& key,
 											vk::WriteDescriptorSet* descriptorSets,
 											int& descriptorSetOffset,
 											vk::DescriptorBufferInfo* descBuffers,
-											int& descBufferOffset);
+											int& descBufferOffset,
+											uint32_t* dynamicOffsets);
 
-	void AssignTexturesToCommandList(const vk::DescriptorSet& descriptorSet,
+	void AssignTexturesToCommandList(DescriptorSetKeyVulkan& key,
 									 vk::WriteDescriptorSet* descriptorSets,
 									 int& descriptorSetOffset,
 									 vk::DescriptorImageInfo* descImages,
@@ -71,7 +219,7 @@ public:
 	CommandListVulkan() = default;
 	~CommandListVulkan() override;
 
-	bool Initialize(GraphicsVulkan* graphics, int32_t drawingCount);
+	bool Initialize(GraphicsVulkan* graphics, int32_t drawingCount, bool isSubCommandList = false);
 
 	void Begin() override;
 	void End() override;
@@ -93,10 +241,22 @@ public:
 
 	void CopyBuffer(Buffer* src, Buffer* dst) override;
 
+	void SetImageData2D(Texture* texture, int32_t x, int32_t y, int32_t width, int32_t height, const void* data) override;
+
+	Readback* ReadbackTexture(Texture* texture) override;
+
+	Readback* ReadbackBuffer(Buffer* buffer) override;
+
 	void BeginRenderPass(RenderPass* renderPass) override;
 	void EndRenderPass() override;
+	void BeginRenderPassWithSubCommandLists(RenderPass* renderPass) override;
+	void ExecuteSubCommandLists(CommandList** subCommandLists, int32_t count) override;
 	vk::CommandBuffer GetCommandBuffer() const;
-	vk::Fence GetFence() const;
+
+	//! it is called when the current command buffer is submitted
+	void SetSubmittedValue(uint64_t value);
+
+	bool GetIsSubCommandList() const { return isSubCommandList_; }
 
 	bool ResetQuery(Query* query) override;
 	bool BeginQuery(Query* query, uint32_t queryIndex) override;
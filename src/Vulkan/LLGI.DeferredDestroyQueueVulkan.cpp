@@ -0,0 +1,66 @@
+#include "LLGI.DeferredDestroyQueueVulkan.h"
+#include <vector>
+
+namespace LLGI
+{
+
+DeferredDestroyQueueVulkan::DeferredDestroyQueueVulkan(std::shared_ptr<TimelineVulkan> timeline) : timeline_(timeline) {}
+
+DeferredDestroyQueueVulkan::~DeferredDestroyQueueVulkan() { Flush(); }
+
+void DeferredDestroyQueueVulkan::Push(std::function<void()> destroy)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	// values are increased in the order of entries because they are read with locking
+	Entry entry;
+	entry.ReleasedValue = timeline_->GetSubmittedValue();
+	entry.Destroy = std::move(destroy);
+	entries_.emplace_back(std::move(entry));
+}
+
+void DeferredDestroyQueueVulkan::Collect()
+{
+	std::vector<std::function<void()>> destroys;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		while (entries_.size() > 0 && timeline_->IsCompleted(entries_.front().ReleasedValue))
+		{
+			destroys.emplace_back(std::move(entries_.front().Destroy));
+			entries_.pop_front();
+		}
+	}
+
+	// resources are destroyed without locking because destroying them may release other resources
+	for (auto& destroy : destroys)
+	{
+		destroy();
+	}
+}
+
+void DeferredDestroyQueueVulkan::Flush()
+{
+	std::vector<std::function<void()>> destroys;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (entries_.size() > 0)
+		{
+			timeline_->Wait(entries_.back().ReleasedValue);
+		}
+
+		for (auto& entry : entries_)
+		{
+			destroys.emplace_back(std::move(entry.Destroy));
+		}
+		entries_.clear();
+	}
+
+	for (auto& destroy : destroys)
+	{
+		destroy();
+	}
+}
+
+} // namespace LLGI
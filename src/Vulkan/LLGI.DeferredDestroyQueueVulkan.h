@@ -0,0 +1,48 @@
+#pragma once
+
+#include "LLGI.TimelineVulkan.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace LLGI
+{
+
+/**
+	@brief	a queue of resources which are destroyed after gpu completes submissions which may use them
+	@note
+	Present doesn't wait for gpu, so a resource which is released by a caller may be still used by previous frames.
+	It is thread safe.
+*/
+class DeferredDestroyQueueVulkan
+{
+private:
+	struct Entry
+	{
+		//! a submitted value of a timeline when the resource is released
+		uint64_t ReleasedValue = 0;
+
+		std::function<void()> Destroy;
+	};
+
+	std::shared_ptr<TimelineVulkan> timeline_;
+
+	std::mutex mutex_;
+	std::deque<Entry> entries_;
+
+public:
+	DeferredDestroyQueueVulkan(std::shared_ptr<TimelineVulkan> timeline);
+	~DeferredDestroyQueueVulkan();
+
+	//! destroy a resource after gpu completes commands which are submitted until now
+	void Push(std::function<void()> destroy);
+
+	//! destroy resources which are not used by gpu anymore without waiting
+	void Collect();
+
+	//! wait for gpu and destroy all resources
+	void Flush();
+};
+
+} // namespace LLGI
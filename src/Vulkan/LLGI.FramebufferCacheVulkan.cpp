@@ -0,0 +1,125 @@
+#include "LLGI.FramebufferCacheVulkan.h"
+#include "LLGI.TimelineVulkan.h"
+#include <algorithm>
+#include <vector>
+
+namespace LLGI
+{
+
+//! the number of unused framebuffers which are kept to be reused
+static constexpr int32_t MaxUnusedFramebufferCount = 32;
+
+FramebufferCacheVulkan::FramebufferCacheVulkan(vk::Device device, std::shared_ptr<TimelineVulkan> timeline)
+	: device_(device), timeline_(timeline)
+{
+}
+
+FramebufferCacheVulkan::~FramebufferCacheVulkan()
+{
+	for (auto& it : framebuffers_)
+	{
+		device_.destroyFramebuffer(it.second.Framebuffer);
+	}
+	framebuffers_.clear();
+}
+
+vk::Framebuffer FramebufferCacheVulkan::Acquire(const FramebufferKeyVulkan& key,
+												const FixedSizeVector<vk::ImageView, RenderTargetMax + 2>& views)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = framebuffers_.find(key);
+	if (it != framebuffers_.end())
+	{
+		if (it->second.ReferenceCount == 0)
+		{
+			stats_.UnusedFramebufferCount--;
+		}
+
+		it->second.ReferenceCount++;
+		stats_.HitCount++;
+		return it->second.Framebuffer;
+	}
+
+	vk::FramebufferCreateInfo framebufferCreateInfo;
+	framebufferCreateInfo.renderPass = key.RenderPass;
+	framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(views.size());
+	framebufferCreateInfo.pAttachments = views.data();
+	framebufferCreateInfo.width = key.Size.X;
+	framebufferCreateInfo.height = key.Size.Y;
+	framebufferCreateInfo.layers = 1;
+
+	Entry entry;
+	entry.Framebuffer = device_.createFramebuffer(framebufferCreateInfo);
+	entry.ReferenceCount = 1;
+	framebuffers_.emplace(key, entry);
+
+	stats_.FramebufferCount++;
+	stats_.MissCount++;
+	return entry.Framebuffer;
+}
+
+void FramebufferCacheVulkan::Release(const FramebufferKeyVulkan& key)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = framebuffers_.find(key);
+	if (it == framebuffers_.end() || it->second.ReferenceCount <= 0)
+	{
+		Log(LogType::Error, "FramebufferCacheVulkan : A framebuffer is released more than acquired.");
+		return;
+	}
+
+	it->second.ReferenceCount--;
+	if (it->second.ReferenceCount > 0)
+	{
+		return;
+	}
+
+	// commands which are submitted until now may use it
+	it->second.ReleasedValue = timeline_ != nullptr ? timeline_->GetSubmittedValue() : 0;
+	stats_.UnusedFramebufferCount++;
+
+	if (stats_.UnusedFramebufferCount > MaxUnusedFramebufferCount)
+	{
+		CollectUnusedFramebuffers();
+	}
+}
+
+void FramebufferCacheVulkan::CollectUnusedFramebuffers()
+{
+	// attachments of old framebuffers are likely to be destroyed, so they are destroyed first
+	typedef std::pair<uint64_t, FramebufferKeyVulkan> Candidate;
+	std::vector<Candidate> candidates;
+	for (const auto& it : framebuffers_)
+	{
+		if (it.second.ReferenceCount == 0 && (timeline_ == nullptr || timeline_->IsCompleted(it.second.ReleasedValue)))
+		{
+			candidates.emplace_back(it.second.ReleasedValue, it.first);
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) -> bool { return a.first < b.first; });
+
+	for (const auto& candidate : candidates)
+	{
+		if (stats_.UnusedFramebufferCount <= MaxUnusedFramebufferCount / 2)
+		{
+			break;
+		}
+
+		auto it = framebuffers_.find(candidate.second);
+		device_.destroyFramebuffer(it->second.Framebuffer);
+		framebuffers_.erase(it);
+		stats_.FramebufferCount--;
+		stats_.UnusedFramebufferCount--;
+	}
+}
+
+FramebufferCacheStatsVulkan FramebufferCacheVulkan::GetStats()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return stats_;
+}
+
+} // namespace LLGI
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "../LLGI.Graphics.h"
+#include "../Utils/LLGI.FixedSizeVector.h"
+#include "../Utils/LLGI.Hash.h"
+#include "LLGI.BaseVulkan.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace LLGI
+{
+
+class TimelineVulkan;
+
+/**
+	@brief	a key of a framebuffer
+	@note
+	Textures are identified with unique ids instead of views, because a handle of a destroyed view may be reused by a new view.
+*/
+struct FramebufferKeyVulkan
+{
+	//! a render pass of a compatibility class, whose load and store operations are ignored
+	vk::RenderPass RenderPass;
+
+	FixedSizeVector<uint64_t, RenderTargetMax + 2> TextureIDs;
+	Vec2I Size;
+
+	bool operator==(const FramebufferKeyVulkan& value) const
+	{
+		if (RenderPass != value.RenderPass || Size.X != value.Size.X || Size.Y != value.Size.Y ||
+			TextureIDs.size() != value.TextureIDs.size())
+			return false;
+
+		for (size_t i = 0; i < TextureIDs.size(); i++)
+		{
+			if (TextureIDs.at(i) != value.TextureIDs.at(i))
+				return false;
+		}
+
+		return true;
+	}
+
+	struct Hash
+	{
+		typedef std::size_t result_type;
+
+		std::size_t operator()(const FramebufferKeyVulkan& key) const
+		{
+			uint64_t hash = 0;
+			CombineHash(hash, std::hash<VkRenderPass>()(static_cast<VkRenderPass>(key.RenderPass)));
+			CombineHash(hash, static_cast<uint64_t>(static_cast<uint32_t>(key.Size.X)));
+			CombineHash(hash, static_cast<uint64_t>(static_cast<uint32_t>(key.Size.Y)));
+			CombineHash(hash, key.TextureIDs.size());
+
+			for (size_t i = 0; i < key.TextureIDs.size(); i++)
+			{
+				CombineHash(hash, key.TextureIDs.at(i));
+			}
+
+			return static_cast<std::size_t>(hash);
+		}
+	};
+};
+
+struct FramebufferCacheStatsVulkan
+{
+	int32_t FramebufferCount = 0;
+
+	//! the number of framebuffers which are not used by render passes and kept to be reused
+	int32_t UnusedFramebufferCount = 0;
+
+	int32_t HitCount = 0;
+	int32_t MissCount = 0;
+};
+
+/**
+	@brief	a cache of framebuffers which are shared by render passes with the same attachments
+	@note
+	A framebuffer can be used with any render pass which is compatible with one used to create it,
+	so render passes whose load and store operations are different share a framebuffer.
+	A framebuffer which is not used by render passes is kept to be reused by a render pass which is created later,
+	and it is destroyed after gpu completes commands which may use it when there are too many unused framebuffers.
+	It is thread safe.
+*/
+class FramebufferCacheVulkan
+{
+private:
+	struct Entry
+	{
+		vk::Framebuffer Framebuffer;
+		int32_t ReferenceCount = 0;
+
+		//! a submitted value of a timeline when the last render pass which uses it is released
+		uint64_t ReleasedValue = 0;
+	};
+
+	vk::Device device_;
+	std::shared_ptr<TimelineVulkan> timeline_;
+
+	std::mutex mutex_;
+	std::unordered_map<FramebufferKeyVulkan, Entry, FramebufferKeyVulkan::Hash> framebuffers_;
+	FramebufferCacheStatsVulkan stats_;
+
+	void CollectUnusedFramebuffers();
+
+public:
+	FramebufferCacheVulkan(vk::Device device, std::shared_ptr<TimelineVulkan> timeline);
+	~FramebufferCacheVulkan();
+
+	/**
+		@brief	get a framebuffer and increase its reference count
+		@param	views	views of textures in the order of TextureIDs of the key
+		@note
+		A framebuffer is created if it is not found.
+	*/
+	vk::Framebuffer Acquire(const FramebufferKeyVulkan& key, const FixedSizeVector<vk::ImageView, RenderTargetMax + 2>& views);
+
+	//! decrease a reference count of a framebuffer which is acquired with the key
+	void Release(const FramebufferKeyVulkan& key);
+
+	FramebufferCacheStatsVulkan GetStats();
+};
+
+} // namespace LLGI
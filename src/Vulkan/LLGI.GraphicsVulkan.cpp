@@ -7,56 +7,223 @@
 #include "LLGI.SingleFrameMemoryPoolVulkan.h"
 #include "LLGI.TextureVulkan.h"
 #include "LLGI.QueryVulkan.h"
+#include <algorithm>
 
 namespace LLGI
 {
 
+static constexpr vk::DeviceSize StagingPoolSize = 32 * 1024 * 1024;
+static constexpr vk::DeviceSize ReadbackRingSize = 16 * 1024 * 1024;
+
 GraphicsVulkan::GraphicsVulkan(const vk::Device& device,
 							   const vk::Queue& quque,
 							   const vk::CommandPool& commandPool,
 							   const vk::PhysicalDevice& pysicalDevice,
 							   int32_t swapBufferCount,
-							   std::function<void(vk::CommandBuffer, vk::Fence)> addCommand,
+							   std::shared_ptr<TimelineVulkan> timeline,
 							   RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache,
-							   ReferenceObject* owner)
+							   ReferenceObject* owner,
+							   int32_t queueFamilyIndex,
+							   vk::PipelineCache pipelineCache,
+							   std::shared_ptr<DeferredDestroyQueueVulkan> deferredDestroyQueue)
 	: vkDevice_(device)
 	, vkQueue_(quque)
 	, vkCmdPool_(commandPool)
 	, vkPysicalDevice_(pysicalDevice)
-	, addCommand_(addCommand)
+	, timeline_(timeline)
+	, deferredDestroyQueue_(deferredDestroyQueue)
 	, renderPassPipelineStateCache_(renderPassPipelineStateCache)
 	, owner_(owner)
+	, queueFamilyIndex_(queueFamilyIndex)
+	, pipelineCache_(pipelineCache)
 {
 	SafeAddRef(owner_);
 
 	swapBufferCount_ = swapBufferCount;
 
+	timestampPeriod_ = vkPysicalDevice_.getProperties().limits.timestampPeriod;
+
+	// submissions are tracked with fences if a device is not created by PlatformVulkan
+	if (timeline_ == nullptr)
+	{
+		timeline_ = std::make_shared<TimelineVulkan>(vkDevice_, false);
+	}
+
+	if (deferredDestroyQueue_ == nullptr)
+	{
+		deferredDestroyQueue_ = std::make_shared<DeferredDestroyQueueVulkan>(timeline_);
+	}
+
 	SafeAddRef(renderPassPipelineStateCache_);
 	if (renderPassPipelineStateCache_ == nullptr)
 	{
-		renderPassPipelineStateCache_ = new RenderPassPipelineStateCacheVulkan(device, nullptr);
+		renderPassPipelineStateCache_ = new RenderPassPipelineStateCacheVulkan(device, timeline_, nullptr);
 	}
 
-	timestampPeriod_ = vkPysicalDevice_.getProperties().limits.timestampPeriod;
+	memoryAllocator_ = std::make_unique<MemoryAllocatorVulkan>(vkDevice_, vkPysicalDevice_);
+	uploadManager_ = std::make_unique<UploadManagerVulkan>(
+		vkDevice_, vkPysicalDevice_, vkQueue_, timeline_.get(), queueFamilyIndex_, memoryAllocator_.get(), StagingPoolSize);
+	readbackRing_ = std::make_unique<ReadbackRingVulkan>(vkDevice_, vkPysicalDevice_, memoryAllocator_.get(), ReadbackRingSize);
+	samplerCache_ = std::make_unique<SamplerCacheVulkan>(vkDevice_, vkPysicalDevice_);
+
+	if (!pipelineCache_)
+	{
+		pipelineCache_ = vkDevice_.createPipelineCache(vk::PipelineCacheCreateInfo());
+		isPipelineCacheOwned_ = true;
+	}
+
+	pipelineLayout_ =
+		CreatePipelineLayout(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, descriptorSetLayouts_);
+	computePipelineLayout_ = CreatePipelineLayout(vk::ShaderStageFlagBits::eCompute, computeDescriptorSetLayouts_);
 }
 
 GraphicsVulkan::~GraphicsVulkan()
 {
+	// pipeline states being compiled are completed
+	compileWorkerPool_.reset();
+
+	vkDevice_.destroyPipelineLayout(pipelineLayout_);
+	vkDevice_.destroyPipelineLayout(computePipelineLayout_);
+	pipelineLayout_ = nullptr;
+	computePipelineLayout_ = nullptr;
+
+	for (auto& layout : descriptorSetLayouts_)
+	{
+		vkDevice_.destroyDescriptorSetLayout(layout);
+		layout = nullptr;
+	}
+
+	for (auto& layout : computeDescriptorSetLayouts_)
+	{
+		vkDevice_.destroyDescriptorSetLayout(layout);
+		layout = nullptr;
+	}
+
+	if (isPipelineCacheOwned_ && pipelineCache_)
+	{
+		vkDevice_.destroyPipelineCache(pipelineCache_);
+		pipelineCache_ = nullptr;
+	}
+
 	SafeRelease(renderPassPipelineStateCache_);
 
+	// resources which are destroyed later may be allocated with the allocator
+	deferredDestroyQueue_->Flush();
+	deferredDestroyQueue_.reset();
+
+	samplerCache_.reset();
+	readbackRing_.reset();
+	uploadManager_.reset();
+	memoryAllocator_.reset();
+	timeline_.reset();
+
 	SafeRelease(owner_);
 }
 
+template <size_t N>
+vk::PipelineLayout GraphicsVulkan::CreatePipelineLayout(vk::ShaderStageFlags stageFlag,
+														 std::array<vk::DescriptorSetLayout, N>& descriptorSetLayouts)
+{
+	static_assert(N == 3 || N == 4, "set 3 is only for compute pipelines");
+
+	// uniform buffers
+	std::array<vk::DescriptorSetLayoutBinding, NumConstantBuffer> uboLayoutBindings;
+	for (size_t i = 0; i < uboLayoutBindings.size(); i++)
+	{
+		uboLayoutBindings[i].binding = static_cast<uint32_t>(i);
+		uboLayoutBindings[i].descriptorType = vk::DescriptorType::eUniformBufferDynamic;
+		uboLayoutBindings[i].descriptorCount = 1;
+		uboLayoutBindings[i].stageFlags = stageFlag;
+		uboLayoutBindings[i].pImmutableSamplers = nullptr;
+	}
+
+	// textures
+	std::array<vk::DescriptorSetLayoutBinding, TextureSlotMax> textureLayoutBindings;
+	for (size_t i = 0; i < textureLayoutBindings.size(); i++)
+	{
+		textureLayoutBindings[i].binding = static_cast<uint32_t>(i);
+		textureLayoutBindings[i].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+		textureLayoutBindings[i].descriptorCount = 1;
+		textureLayoutBindings[i].stageFlags = stageFlag;
+		textureLayoutBindings[i].pImmutableSamplers = nullptr;
+	}
+
+	// compute buffers
+	std::array<vk::DescriptorSetLayoutBinding, 8> computeLayoutBindings;
+	for (size_t i = 0; i < computeLayoutBindings.size(); i++)
+	{
+		computeLayoutBindings[i].binding = static_cast<uint32_t>(i);
+		computeLayoutBindings[i].descriptorType = vk::DescriptorType::eStorageBufferDynamic;
+		computeLayoutBindings[i].descriptorCount = 1;
+		computeLayoutBindings[i].stageFlags = stageFlag;
+		computeLayoutBindings[i].pImmutableSamplers = nullptr;
+	}
+
+	// storage images
+	std::array<vk::DescriptorSetLayoutBinding, TextureSlotMax> storageImageLayoutBindings;
+	for (size_t i = 0; i < storageImageLayoutBindings.size(); i++)
+	{
+		storageImageLayoutBindings[i].binding = static_cast<uint32_t>(i);
+		storageImageLayoutBindings[i].descriptorType = vk::DescriptorType::eStorageImage;
+		storageImageLayoutBindings[i].descriptorCount = 1;
+		storageImageLayoutBindings[i].stageFlags = stageFlag;
+		storageImageLayoutBindings[i].pImmutableSamplers = nullptr;
+	}
+
+	vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutInfos[4];
+	descriptorSetLayoutInfos[0].bindingCount = static_cast<uint32_t>(uboLayoutBindings.size());
+	descriptorSetLayoutInfos[0].pBindings = uboLayoutBindings.data();
+	descriptorSetLayoutInfos[1].bindingCount = static_cast<uint32_t>(textureLayoutBindings.size());
+	descriptorSetLayoutInfos[1].pBindings = textureLayoutBindings.data();
+	descriptorSetLayoutInfos[2].bindingCount = static_cast<uint32_t>(computeLayoutBindings.size());
+	descriptorSetLayoutInfos[2].pBindings = computeLayoutBindings.data();
+	descriptorSetLayoutInfos[3].bindingCount = static_cast<uint32_t>(storageImageLayoutBindings.size());
+	descriptorSetLayoutInfos[3].pBindings = storageImageLayoutBindings.data();
+
+	for (size_t i = 0; i < N; i++)
+	{
+		descriptorSetLayouts[i] = vkDevice_.createDescriptorSetLayout(descriptorSetLayoutInfos[i]);
+	}
+
+	vk::PipelineLayoutCreateInfo layoutInfo = {};
+	layoutInfo.setLayoutCount = static_cast<uint32_t>(N);
+	layoutInfo.pSetLayouts = descriptorSetLayouts.data();
+	layoutInfo.pushConstantRangeCount = 0;
+	layoutInfo.pPushConstantRanges = nullptr;
+
+	return vkDevice_.createPipelineLayout(layoutInfo);
+}
+
 void GraphicsVulkan::SetWindowSize(const Vec2I& windowSize) { throw "Not inplemented"; }
 
 void GraphicsVulkan::Execute(CommandList* commandList)
 {
 	auto commandList_ = static_cast<CommandListVulkan*>(commandList);
+	if (commandList_->GetIsSubCommandList())
+	{
+		Log(LogType::Error, "A sub command list must be executed with CommandList::ExecuteSubCommandLists.");
+		return;
+	}
+
+	// uploads are submitted ahead of commands which use them
+	uploadManager_->Submit();
+
 	auto cmdBuf = commandList_->GetCommandBuffer();
-	addCommand_(cmdBuf, commandList_->GetFence());
+
+	vk::SubmitInfo submitInfo;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &cmdBuf;
+	commandList_->SetSubmittedValue(timeline_->Submit(vkQueue_, submitInfo));
+
+	deferredDestroyQueue_->Collect();
 }
 
-void GraphicsVulkan::WaitFinish() { vkQueue_.waitIdle(); }
+void GraphicsVulkan::WaitFinish()
+{
+	uploadManager_->Submit();
+	timeline_->Wait(timeline_->GetSubmittedValue());
+	deferredDestroyQueue_->Collect();
+}
 
 Buffer* GraphicsVulkan::CreateBuffer(BufferUsageType usage, int32_t size)
 {
@@ -113,6 +280,19 @@ CommandList* GraphicsVulkan::CreateCommandList(SingleFrameMemoryPool* memoryPool
 	return nullptr;
 }
 
+CommandList* GraphicsVulkan::CreateSubCommandList(SingleFrameMemoryPool* memoryPool)
+{
+	auto mp = static_cast<SingleFrameMemoryPoolVulkan*>(memoryPool);
+
+	auto commandList = new CommandListVulkan();
+	if (commandList->Initialize(this, mp->GetDrawingCount(), true))
+	{
+		return commandList;
+	}
+	SafeRelease(commandList);
+	return nullptr;
+}
+
 RenderPass* GraphicsVulkan::CreateRenderPass(Texture** textures, int32_t textureCount, Texture* depthTexture)
 {
 	assert(textures != nullptr);
@@ -201,6 +381,10 @@ Texture* GraphicsVulkan::CreateRenderTexture(const RenderTextureInitializationPa
 	param.SampleCount = parameter.SamplingCount;
 	param.Size = {parameter.Size.X, parameter.Size.Y, 1};
 	param.Usage = TextureUsageType::RenderTarget;
+	if (parameter.IsTransient)
+	{
+		param.Usage = param.Usage | TextureUsageType::Transient;
+	}
 	return CreateTexture(param);
 }
 
@@ -218,6 +402,10 @@ Texture* GraphicsVulkan::CreateDepthTexture(const DepthTextureInitializationPara
 	param.MipLevelCount = 1;
 	param.SampleCount = parameter.SamplingCount;
 	param.Size = {parameter.Size.X, parameter.Size.Y, 1};
+	if (parameter.IsTransient)
+	{
+		param.Usage = TextureUsageType::Transient;
+	}
 	return CreateTexture(param);
 }
 
@@ -326,11 +514,10 @@ std::vector<uint8_t> GraphicsVulkan::CaptureRenderTarget(Texture* renderTarget)
 
 	// Blit
 	{
-		void* rawData = nullptr;
-		vkMapMemory(device, destBuffer.GetNativeBufferMemory(), 0, destBuffer.GetSize(), 0, &rawData);
+		memoryAllocator_->Invalidate(destBuffer.GetAllocation(), 0, destBuffer.GetSize());
+		auto rawData = memoryAllocator_->GetMappedPointer(destBuffer.GetAllocation());
 		result.resize(static_cast<size_t>(destBuffer.GetSize()));
 		memcpy(result.data(), rawData, result.size());
-		vkUnmapMemory(device, destBuffer.GetNativeBufferMemory());
 	}
 
 Exit:
@@ -343,7 +530,7 @@ RenderPassPipelineState* GraphicsVulkan::CreateRenderPassPipelineState(RenderPas
 	assert(renderPass != nullptr);
 	auto rpvk = static_cast<RenderPassVulkan*>(renderPass);
 
-	auto ret = rpvk->renderPassPipelineState;
+	auto ret = rpvk->GetRenderPassPipelineState();
 	SafeAddRef(ret);
 	return ret;
 }
@@ -370,6 +557,83 @@ uint64_t GraphicsVulkan::TimestampToMicroseconds(uint64_t timestamp) const
 	return static_cast<uint64_t>(timestamp * timestampPeriod_ / 1000);
 }
 
+std::vector<uint8_t> GraphicsVulkan::GetPipelineCacheData()
+{
+	size_t size = 0;
+	if (vkGetPipelineCacheData(static_cast<VkDevice>(vkDevice_), static_cast<VkPipelineCache>(pipelineCache_), &size, nullptr) !=
+		VK_SUCCESS)
+	{
+		return std::vector<uint8_t>();
+	}
+
+	std::vector<uint8_t> data(size);
+	if (vkGetPipelineCacheData(static_cast<VkDevice>(vkDevice_), static_cast<VkPipelineCache>(pipelineCache_), &size, data.data()) !=
+		VK_SUCCESS)
+	{
+		return std::vector<uint8_t>();
+	}
+
+	data.resize(size);
+	return data;
+}
+
+bool GraphicsVulkan::LoadPipelineCacheData(const void* data, int32_t size)
+{
+	// VkPipelineCacheHeaderVersionOne
+	struct Header
+	{
+		uint32_t headerSize;
+		uint32_t headerVersion;
+		uint32_t vendorID;
+		uint32_t deviceID;
+		uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+	};
+
+	if (data == nullptr || size < static_cast<int32_t>(sizeof(Header)))
+	{
+		Log(LogType::Warning, "LoadPipelineCacheData : Data is too small.");
+		return false;
+	}
+
+	Header header;
+	memcpy(&header, data, sizeof(Header));
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(static_cast<VkPhysicalDevice>(vkPysicalDevice_), &properties);
+
+	// a cache created with another device or driver may be unsafe to load
+	if (header.headerSize < sizeof(Header) || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+		header.vendorID != properties.vendorID || header.deviceID != properties.deviceID ||
+		memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+	{
+		Log(LogType::Warning, "LoadPipelineCacheData : Data is created with another device or driver.");
+		return false;
+	}
+
+	vk::PipelineCacheCreateInfo createInfo;
+	createInfo.initialDataSize = static_cast<size_t>(size);
+	createInfo.pInitialData = data;
+	auto loadedCache = vkDevice_.createPipelineCache(createInfo);
+	if (!loadedCache)
+	{
+		return false;
+	}
+
+	vkDevice_.mergePipelineCaches(pipelineCache_, loadedCache);
+	vkDevice_.destroyPipelineCache(loadedCache);
+	return true;
+}
+
+WorkerThreadPool* GraphicsVulkan::GetCompileWorkerPool()
+{
+	std::call_once(compileWorkerPoolFlag_, [this]() -> void {
+		const auto threadCount = std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()) - 1);
+		compileWorkerPool_ = std::make_unique<WorkerThreadPool>(threadCount);
+	});
+
+	return compileWorkerPool_.get();
+}
+
 int32_t GraphicsVulkan::GetSwapBufferCount() const { return swapBufferCount_; }
 
 uint32_t GraphicsVulkan::GetMemoryTypeIndex(uint32_t bits, const vk::MemoryPropertyFlags& properties)
@@ -401,13 +665,21 @@ bool GraphicsVulkan::EndSingleTimeCommands(VkCommandBuffer commandBuffer)
 {
 	vkEndCommandBuffer(commandBuffer);
 
-	VkSubmitInfo submitInfo = {};
-	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	vk::CommandBuffer commandBufferCpp = static_cast<vk::CommandBuffer>(commandBuffer);
+	vk::SubmitInfo submitInfo;
 	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &commandBuffer;
+	submitInfo.pCommandBuffers = &commandBufferCpp;
 
-	LLGI_VK_CHECK(vkQueueSubmit(static_cast<VkQueue>(vkQueue_), 1, &submitInfo, VK_NULL_HANDLE));
-	LLGI_VK_CHECK(vkQueueWaitIdle(static_cast<VkQueue>(vkQueue_)));
+	// uploads recorded before are executed first
+	uploadManager_->Submit();
+
+	// only the commands are waited for instead of the whole queue
+	const auto submittedValue = timeline_->Submit(vkQueue_, submitInfo);
+	if (submittedValue == 0 || !timeline_->Wait(submittedValue))
+	{
+		vkFreeCommandBuffers(static_cast<VkDevice>(GetDevice()), static_cast<VkCommandPool>(GetCommandPool()), 1, &commandBuffer);
+		return false;
+	}
 
 	vkFreeCommandBuffers(static_cast<VkDevice>(GetDevice()), static_cast<VkCommandPool>(GetCommandPool()), 1, &commandBuffer);
 
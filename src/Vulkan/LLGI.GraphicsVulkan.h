@@ -2,8 +2,15 @@
 
 #include "../LLGI.Graphics.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.DeferredDestroyQueueVulkan.h"
+#include "LLGI.MemoryAllocatorVulkan.h"
+#include "LLGI.ReadbackVulkan.h"
 #include "LLGI.RenderPassPipelineStateCacheVulkan.h"
 #include "LLGI.RenderPassVulkan.h"
+#include "LLGI.SamplerCacheVulkan.h"
+#include "LLGI.TimelineVulkan.h"
+#include "LLGI.UploadManagerVulkan.h"
+#include "../Utils/LLGI.WorkerThreadPool.h"
 #include <functional>
 #include <unordered_map>
 
@@ -24,10 +31,33 @@ private:
 	vk::CommandPool vkCmdPool_;
 	vk::PhysicalDevice vkPysicalDevice_;
 
-	std::function<void(vk::CommandBuffer, vk::Fence)> addCommand_;
+	std::shared_ptr<TimelineVulkan> timeline_;
+	std::shared_ptr<DeferredDestroyQueueVulkan> deferredDestroyQueue_;
 	RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache_ = nullptr;
 	ReferenceObject* owner_ = nullptr;
 	float timestampPeriod_ = 1.0f;
+	int32_t queueFamilyIndex_ = 0;
+
+	//! pipeline states are compiled with it. It is created by GraphicsVulkan if it is not specified.
+	vk::PipelineCache pipelineCache_ = nullptr;
+	bool isPipelineCacheOwned_ = false;
+
+	std::unique_ptr<MemoryAllocatorVulkan> memoryAllocator_;
+	std::unique_ptr<UploadManagerVulkan> uploadManager_;
+	std::unique_ptr<ReadbackRingVulkan> readbackRing_;
+	std::unique_ptr<SamplerCacheVulkan> samplerCache_;
+
+	std::unique_ptr<WorkerThreadPool> compileWorkerPool_;
+	std::once_flag compileWorkerPoolFlag_;
+
+	//! layouts shared among all pipeline states
+	std::array<vk::DescriptorSetLayout, 3> descriptorSetLayouts_;
+	vk::PipelineLayout pipelineLayout_ = nullptr;
+	std::array<vk::DescriptorSetLayout, 4> computeDescriptorSetLayouts_;
+	vk::PipelineLayout computePipelineLayout_ = nullptr;
+
+	template <size_t N>
+	vk::PipelineLayout CreatePipelineLayout(vk::ShaderStageFlags stageFlag, std::array<vk::DescriptorSetLayout, N>& descriptorSetLayouts);
 
 public:
 	GraphicsVulkan(const vk::Device& device,
@@ -35,9 +65,12 @@ public:
 				   const vk::CommandPool& commandPool,
 				   const vk::PhysicalDevice& pysicalDevice,
 				   int32_t swapBufferCount,
-				   std::function<void(vk::CommandBuffer, vk::Fence)> addCommand,
+				   std::shared_ptr<TimelineVulkan> timeline,
 				   RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache = nullptr,
-				   ReferenceObject* owner = nullptr);
+				   ReferenceObject* owner = nullptr,
+				   int32_t queueFamilyIndex = 0,
+				   vk::PipelineCache pipelineCache = nullptr,
+				   std::shared_ptr<DeferredDestroyQueueVulkan> deferredDestroyQueue = nullptr);
 
 	~GraphicsVulkan() override;
 
@@ -52,6 +85,7 @@ public:
 	PipelineState* CreatePiplineState() override;
 	SingleFrameMemoryPool* CreateSingleFrameMemoryPool(int32_t constantBufferPoolSize, int32_t drawingCount) override;
 	CommandList* CreateCommandList(SingleFrameMemoryPool* memoryPool) override;
+	CommandList* CreateSubCommandList(SingleFrameMemoryPool* memoryPool) override;
 	RenderPass* CreateRenderPass(Texture** textures, int32_t textureCount, Texture* depthTexture) override;
 
 	RenderPass* CreateRenderPass(Texture* texture, Texture* resolvedTexture, Texture* depthTexture, Texture* resolvedDepthTexture) override;
@@ -73,6 +107,7 @@ public:
 	vk::Device GetDevice() const { return vkDevice_; }
 	vk::CommandPool GetCommandPool() const { return vkCmdPool_; }
 	vk::Queue GetQueue() const { return vkQueue_; }
+	int32_t GetQueueFamilyIndex() const { return queueFamilyIndex_; }
 
 	int32_t GetSwapBufferCount() const;
 	uint32_t GetMemoryTypeIndex(uint32_t bits, const vk::MemoryPropertyFlags& properties);
@@ -82,6 +117,49 @@ public:
 
 	Query* CreateQuery(QueryType queryType, int32_t queryCount) override;
 	uint64_t TimestampToMicroseconds(uint64_t timestamp) const override;
+
+	std::vector<uint8_t> GetPipelineCacheData() override;
+	bool LoadPipelineCacheData(const void* data, int32_t size) override;
+
+	vk::PipelineCache GetPipelineCache() const { return pipelineCache_; }
+
+	//! all submissions to the queue signal values of it. It is shared with the platform.
+	TimelineVulkan* GetTimeline() const { return timeline_.get(); }
+
+	//! resources which may be used by gpu are destroyed with it. It is shared with the platform.
+	DeferredDestroyQueueVulkan* GetDeferredDestroyQueue() const { return deferredDestroyQueue_.get(); }
+
+	//! resources allocate device memory with it
+	MemoryAllocatorVulkan* GetMemoryAllocator() const { return memoryAllocator_.get(); }
+
+	//! copies from cpu to gpu are batched with it and submitted before a command list is executed
+	UploadManagerVulkan* GetUploadManager() const { return uploadManager_.get(); }
+
+	//! copies from gpu to cpu which are recorded into command lists use buffers in it
+	ReadbackRingVulkan* GetReadbackRing() const { return readbackRing_.get(); }
+
+	//! samplers which are shared among command lists
+	SamplerCacheVulkan* GetSamplerCache() const { return samplerCache_.get(); }
+
+	//! threads to compile pipeline states asynchronously
+	WorkerThreadPool* GetCompileWorkerPool();
+
+	/**
+		@brief	layouts of descriptor sets which are shared among all graphics pipelines
+		@note
+		set 0 : uniform buffers, set 1 : textures, set 2 : storage buffers
+		Bound descriptor sets remain valid when a pipeline is switched because the layouts are identical.
+	*/
+	const std::array<vk::DescriptorSetLayout, 3>& GetDescriptorSetLayouts() const { return descriptorSetLayouts_; }
+	vk::PipelineLayout GetPipelineLayout() const { return pipelineLayout_; }
+
+	/**
+		@brief	layouts of descriptor sets which are shared among all compute pipelines
+		@note
+		set 3 : storage images is added to the sets of graphics pipelines
+	*/
+	const std::array<vk::DescriptorSetLayout, 4>& GetComputeDescriptorSetLayouts() const { return computeDescriptorSetLayouts_; }
+	vk::PipelineLayout GetComputePipelineLayout() const { return computePipelineLayout_; }
 };
 
 } // namespace LLGI
@@ -0,0 +1,313 @@
+#include "LLGI.MemoryAllocatorVulkan.h"
+
+namespace LLGI
+{
+
+static constexpr vk::DeviceSize DefaultBlockSize = 64 * 1024 * 1024;
+static constexpr vk::DeviceSize SmallHeapSize = 1024 * 1024 * 1024;
+
+class MemoryBlockVulkan
+{
+public:
+	vk::DeviceMemory memory;
+	uint32_t memoryTypeIndex = 0;
+	bool isLinear = false;
+	bool isDedicated = false;
+	FreeListAllocator allocator;
+
+	//! host visible memory is mapped while the block is alive
+	void* mapped = nullptr;
+	bool isCoherent = false;
+
+	MemoryBlockVulkan(vk::DeviceMemory memory, uint32_t memoryTypeIndex, bool isLinear, bool isDedicated, vk::DeviceSize size)
+		: memory(memory), memoryTypeIndex(memoryTypeIndex), isLinear(isLinear), isDedicated(isDedicated), allocator(size)
+	{
+	}
+};
+
+static bool AllocateDeviceMemory(vk::Device device, vk::DeviceSize size, uint32_t memoryTypeIndex, vk::DeviceMemory& memory)
+{
+	VkMemoryAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = size;
+	allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+	VkDeviceMemory nativeMemory = VK_NULL_HANDLE;
+	LLGI_VK_CHECK(vkAllocateMemory(static_cast<VkDevice>(device), &allocInfo, nullptr, &nativeMemory));
+	memory = nativeMemory;
+	return true;
+}
+
+MemoryBlockVulkan* MemoryAllocatorVulkan::CreateBlock(vk::DeviceSize size, uint32_t memoryTypeIndex, bool isLinear, bool isDedicated)
+{
+	vk::DeviceMemory memory;
+	if (!AllocateDeviceMemory(device_, size, memoryTypeIndex, memory))
+	{
+		return nullptr;
+	}
+
+	auto block = std::make_unique<MemoryBlockVulkan>(memory, memoryTypeIndex, isLinear, isDedicated, size);
+
+	const auto propertyFlags = memoryProperties_.memoryTypes[memoryTypeIndex].propertyFlags;
+	if (propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)
+	{
+		block->mapped = device_.mapMemory(memory, 0, VK_WHOLE_SIZE, vk::MemoryMapFlags());
+		block->isCoherent = static_cast<bool>(propertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent);
+	}
+
+	auto ret = block.get();
+	(isDedicated ? dedicatedBlocks_ : blocks_).emplace_back(std::move(block));
+	return ret;
+}
+
+vk::MappedMemoryRange MemoryAllocatorVulkan::GetMappedRange(const MemoryAllocationVulkan& allocation,
+															 vk::DeviceSize offset,
+															 vk::DeviceSize size) const
+{
+	// a range must be aligned with nonCoherentAtomSize
+	const auto begin = (allocation.Offset + offset) / nonCoherentAtomSize_ * nonCoherentAtomSize_;
+	auto end = (allocation.Offset + offset + size + nonCoherentAtomSize_ - 1) / nonCoherentAtomSize_ * nonCoherentAtomSize_;
+	end = std::min(end, static_cast<vk::DeviceSize>(allocation.Block->allocator.GetCapacity()));
+
+	return vk::MappedMemoryRange(allocation.Memory, begin, end - begin);
+}
+
+vk::DeviceSize MemoryAllocatorVulkan::GetPreferredBlockSize(uint32_t memoryTypeIndex) const
+{
+	const auto heapIndex = memoryProperties_.memoryTypes[memoryTypeIndex].heapIndex;
+	const auto heapSize = memoryProperties_.memoryHeaps[heapIndex].size;
+
+	// a small heap (ex. host visible device local memory) is not occupied by a few blocks
+	if (heapSize <= SmallHeapSize)
+	{
+		return heapSize / 8;
+	}
+
+	return DefaultBlockSize;
+}
+
+MemoryAllocatorVulkan::MemoryAllocatorVulkan(vk::Device device, vk::PhysicalDevice physicalDevice)
+	: device_(device), physicalDevice_(physicalDevice)
+{
+	memoryProperties_ = physicalDevice_.getMemoryProperties();
+	nonCoherentAtomSize_ = std::max(physicalDevice_.getProperties().limits.nonCoherentAtomSize, static_cast<vk::DeviceSize>(1));
+}
+
+MemoryAllocatorVulkan::~MemoryAllocatorVulkan()
+{
+	for (auto blocks : {&blocks_, &dedicatedBlocks_})
+	{
+		for (auto& block : *blocks)
+		{
+			if (block->allocator.GetAllocationCount() > 0)
+			{
+				Log(LogType::Warning, "Device memory is freed before resources are released.");
+			}
+
+			if (block->mapped != nullptr)
+			{
+				device_.unmapMemory(block->memory);
+			}
+
+			device_.freeMemory(block->memory);
+		}
+
+		blocks->clear();
+	}
+}
+
+bool MemoryAllocatorVulkan::Allocate(const vk::MemoryRequirements& requirements,
+									 vk::MemoryPropertyFlags properties,
+									 bool isLinear,
+									 MemoryAllocationVulkan& allocation)
+{
+	const auto memoryTypeIndex = GetMemoryTypeIndex(physicalDevice_, requirements.memoryTypeBits, properties);
+	if (memoryTypeIndex == 0xffffffff)
+	{
+		Log(LogType::Error, "Memory type is not found.");
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const auto blockSize = GetPreferredBlockSize(memoryTypeIndex);
+
+	// a large resource doesn't share a block
+	if (requirements.size > blockSize / 2)
+	{
+		auto block = CreateBlock(requirements.size, memoryTypeIndex, isLinear, true);
+		if (block == nullptr)
+		{
+			return false;
+		}
+
+		uint64_t offset = 0;
+		block->allocator.Allocate(requirements.size, 1, offset);
+
+		allocation.Memory = block->memory;
+		allocation.Offset = 0;
+		allocation.Size = requirements.size;
+		allocation.Block = block;
+		return true;
+	}
+
+	const auto alignment = std::max(requirements.alignment, static_cast<vk::DeviceSize>(1));
+
+	for (auto& block : blocks_)
+	{
+		if (block->memoryTypeIndex != memoryTypeIndex || block->isLinear != isLinear)
+		{
+			continue;
+		}
+
+		uint64_t offset = 0;
+		if (block->allocator.Allocate(requirements.size, alignment, offset))
+		{
+			allocation.Memory = block->memory;
+			allocation.Offset = offset;
+			allocation.Size = requirements.size;
+			allocation.Block = block.get();
+			return true;
+		}
+	}
+
+	auto block = CreateBlock(blockSize, memoryTypeIndex, isLinear, false);
+	if (block == nullptr)
+	{
+		return false;
+	}
+
+	uint64_t offset = 0;
+	block->allocator.Allocate(requirements.size, alignment, offset);
+
+	allocation.Memory = block->memory;
+	allocation.Offset = offset;
+	allocation.Size = requirements.size;
+	allocation.Block = block;
+	return true;
+}
+
+bool MemoryAllocatorVulkan::HasMemoryType(uint32_t memoryTypeBits, vk::MemoryPropertyFlags properties) const
+{
+	for (uint32_t i = 0; i < memoryProperties_.memoryTypeCount; i++)
+	{
+		if ((memoryTypeBits & (1u << i)) != 0 && (memoryProperties_.memoryTypes[i].propertyFlags & properties) == properties)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void MemoryAllocatorVulkan::Free(MemoryAllocationVulkan& allocation)
+{
+	if (allocation.Block == nullptr)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto block = allocation.Block;
+	block->allocator.Free(allocation.Offset, allocation.Size);
+	allocation = MemoryAllocationVulkan();
+
+	if (!block->allocator.IsEmpty())
+	{
+		return;
+	}
+
+	auto& blocks = block->isDedicated ? dedicatedBlocks_ : blocks_;
+
+	// an empty shared block is kept for each type to avoid allocating device memory repeatedly
+	if (!block->isDedicated)
+	{
+		const auto emptyCount = std::count_if(blocks.begin(), blocks.end(), [block](const std::unique_ptr<MemoryBlockVulkan>& b) -> bool {
+			return b->memoryTypeIndex == block->memoryTypeIndex && b->isLinear == block->isLinear && b->allocator.IsEmpty();
+		});
+
+		if (emptyCount < 2)
+		{
+			return;
+		}
+	}
+
+	auto it = std::find_if(
+		blocks.begin(), blocks.end(), [block](const std::unique_ptr<MemoryBlockVulkan>& b) -> bool { return b.get() == block; });
+	assert(it != blocks.end());
+
+	if (block->mapped != nullptr)
+	{
+		device_.unmapMemory(block->memory);
+	}
+
+	device_.freeMemory(block->memory);
+	blocks.erase(it);
+}
+
+void* MemoryAllocatorVulkan::GetMappedPointer(const MemoryAllocationVulkan& allocation) const
+{
+	if (allocation.Block == nullptr || allocation.Block->mapped == nullptr)
+	{
+		Log(LogType::Error, "Memory is not host visible.");
+		return nullptr;
+	}
+
+	return static_cast<uint8_t*>(allocation.Block->mapped) + allocation.Offset;
+}
+
+void MemoryAllocatorVulkan::Flush(const MemoryAllocationVulkan& allocation, vk::DeviceSize offset, vk::DeviceSize size)
+{
+	if (allocation.Block == nullptr || allocation.Block->mapped == nullptr || allocation.Block->isCoherent)
+	{
+		return;
+	}
+
+	device_.flushMappedMemoryRanges(GetMappedRange(allocation, offset, size));
+}
+
+void MemoryAllocatorVulkan::Invalidate(const MemoryAllocationVulkan& allocation, vk::DeviceSize offset, vk::DeviceSize size)
+{
+	if (allocation.Block == nullptr || allocation.Block->mapped == nullptr || allocation.Block->isCoherent)
+	{
+		return;
+	}
+
+	device_.invalidateMappedMemoryRanges(GetMappedRange(allocation, offset, size));
+}
+
+MemoryAllocatorStatsVulkan MemoryAllocatorVulkan::GetStats()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	MemoryAllocatorStatsVulkan stats;
+	uint64_t freeSize = 0;
+
+	for (const auto& block : blocks_)
+	{
+		stats.BlockCount++;
+		stats.AllocationCount += block->allocator.GetAllocationCount();
+		stats.ReservedSize += block->allocator.GetCapacity();
+		stats.UsedSize += block->allocator.GetUsedSize();
+		stats.FreeRangeCount += block->allocator.GetFreeRangeCount();
+		stats.LargestFreeRange = std::max(stats.LargestFreeRange, block->allocator.GetLargestFreeRange());
+		freeSize += block->allocator.GetCapacity() - block->allocator.GetUsedSize();
+	}
+
+	for (const auto& block : dedicatedBlocks_)
+	{
+		stats.DedicatedAllocationCount++;
+		stats.AllocationCount++;
+		stats.ReservedSize += block->allocator.GetCapacity();
+		stats.UsedSize += block->allocator.GetUsedSize();
+	}
+
+	if (freeSize > 0)
+	{
+		stats.Fragmentation = 1.0f - static_cast<float>(static_cast<double>(stats.LargestFreeRange) / static_cast<double>(freeSize));
+	}
+
+	return stats;
+}
+
+} // namespace LLGI
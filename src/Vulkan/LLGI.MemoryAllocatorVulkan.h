@@ -0,0 +1,102 @@
+#pragma once
+
+#include "../Utils/LLGI.FreeListAllocator.h"
+#include "LLGI.BaseVulkan.h"
+#include <mutex>
+#include <vector>
+
+namespace LLGI
+{
+
+struct MemoryAllocatorStatsVulkan
+{
+	//! the number of memory blocks which are shared by resources
+	int32_t BlockCount = 0;
+
+	//! the number of memory blocks which are allocated for a large resource
+	int32_t DedicatedAllocationCount = 0;
+
+	int32_t AllocationCount = 0;
+
+	//! the size of device memory allocated with vkAllocateMemory
+	uint64_t ReservedSize = 0;
+
+	//! the size used by resources
+	uint64_t UsedSize = 0;
+
+	//! the number of free ranges in shared blocks
+	int32_t FreeRangeCount = 0;
+
+	uint64_t LargestFreeRange = 0;
+
+	//! 0 if free memory in shared blocks is contiguous, near 1 if it is split into small ranges
+	float Fragmentation = 0.0f;
+};
+
+/**
+	@brief	an allocator which sub-allocates resources from large blocks of device memory
+	@note
+	Blocks are created for each memory type, and buffers and images are put into different blocks to meet bufferImageGranularity.
+	A large resource is allocated with its own device memory.
+	Host visible blocks are mapped once when they are created.
+	It is thread safe.
+*/
+class MemoryAllocatorVulkan
+{
+private:
+	vk::Device device_;
+	vk::PhysicalDevice physicalDevice_;
+	vk::PhysicalDeviceMemoryProperties memoryProperties_;
+	vk::DeviceSize nonCoherentAtomSize_ = 1;
+
+	std::mutex mutex_;
+	std::vector<std::unique_ptr<MemoryBlockVulkan>> blocks_;
+	std::vector<std::unique_ptr<MemoryBlockVulkan>> dedicatedBlocks_;
+
+	vk::DeviceSize GetPreferredBlockSize(uint32_t memoryTypeIndex) const;
+
+	MemoryBlockVulkan* CreateBlock(vk::DeviceSize size, uint32_t memoryTypeIndex, bool isLinear, bool isDedicated);
+
+	vk::MappedMemoryRange GetMappedRange(const MemoryAllocationVulkan& allocation, vk::DeviceSize offset, vk::DeviceSize size) const;
+
+public:
+	MemoryAllocatorVulkan(vk::Device device, vk::PhysicalDevice physicalDevice);
+	~MemoryAllocatorVulkan();
+
+	/**
+		@brief	allocate device memory
+		@param	isLinear	whether is it used for a buffer or a linear image
+	*/
+	bool Allocate(const vk::MemoryRequirements& requirements,
+				  vk::MemoryPropertyFlags properties,
+				  bool isLinear,
+				  MemoryAllocationVulkan& allocation);
+
+	//! whether is there a memory type which has the properties in memoryTypeBits
+	bool HasMemoryType(uint32_t memoryTypeBits, vk::MemoryPropertyFlags properties) const;
+
+	void Free(MemoryAllocationVulkan& allocation);
+
+	/**
+		@brief	get a pointer to a host visible allocation in a persistent mapping
+	*/
+	void* GetMappedPointer(const MemoryAllocationVulkan& allocation) const;
+
+	/**
+		@brief	make writes from cpu visible to gpu
+		@note
+		It does nothing with host coherent memory.
+	*/
+	void Flush(const MemoryAllocationVulkan& allocation, vk::DeviceSize offset, vk::DeviceSize size);
+
+	/**
+		@brief	make writes from gpu visible to cpu
+		@note
+		It does nothing with host coherent memory.
+	*/
+	void Invalidate(const MemoryAllocationVulkan& allocation, vk::DeviceSize offset, vk::DeviceSize size);
+
+	MemoryAllocatorStatsVulkan GetStats();
+};
+
+} // namespace LLGI
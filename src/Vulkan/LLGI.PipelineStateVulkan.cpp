@@ -10,10 +10,6 @@ namespace LLGI
 PipelineStateVulkan::PipelineStateVulkan()
 {
 	shaders.fill(0);
-	for (size_t i = 0; i < descriptorSetLayouts_.size(); i++)
-	{
-		descriptorSetLayouts_[i] = nullptr;
-	}
 }
 
 PipelineStateVulkan ::~PipelineStateVulkan()
@@ -23,36 +19,12 @@ PipelineStateVulkan ::~PipelineStateVulkan()
 		SafeRelease(shader);
 	}
 
-	for (size_t i = 0; i < descriptorSetLayouts_.size(); i++)
-	{
-		graphics_->GetDevice().destroyDescriptorSetLayout(descriptorSetLayouts_[i]);
-		descriptorSetLayouts_[i] = nullptr;
-	}
-
-	if (pipelineLayout_)
-	{
-		graphics_->GetDevice().destroyPipelineLayout(pipelineLayout_);
-		pipelineLayout_ = nullptr;
-	}
-
 	if (pipeline_)
 	{
 		graphics_->GetDevice().destroyPipeline(pipeline_);
 		pipeline_ = nullptr;
 	}
 
-	for (size_t i = 0; i < computeDescriptorSetLayouts_.size(); i++)
-	{
-		graphics_->GetDevice().destroyDescriptorSetLayout(computeDescriptorSetLayouts_[i]);
-		computeDescriptorSetLayouts_[i] = nullptr;
-	}
-
-	if (computePipelineLayout_)
-	{
-		graphics_->GetDevice().destroyPipelineLayout(computePipelineLayout_);
-		computePipelineLayout_ = nullptr;
-	}
-
 	if (computePipeline_)
 	{
 		graphics_->GetDevice().destroyPipeline(computePipeline_);
@@ -88,6 +60,32 @@ bool PipelineStateVulkan::Compile()
 	return CreateGraphicsPipeline();
 }
 
+std::shared_future<bool> PipelineStateVulkan::CompileAsync()
+{
+	auto promise = std::make_shared<std::promise<bool>>();
+	compileTask_ = promise->get_future().share();
+
+	// pipelines can be created on multiple threads at the same time with a pipeline cache
+	SafeAddRef(this);
+	graphics_->GetCompileWorkerPool()->Push([this, promise]() -> void {
+		bool result = false;
+
+		try
+		{
+			result = Compile();
+		}
+		catch (std::exception& e)
+		{
+			Log(LogType::Error, e.what());
+		}
+
+		promise->set_value(result);
+		Release();
+	});
+
+	return compileTask_;
+}
+
 bool PipelineStateVulkan::CreateGraphicsPipeline()
 {
 	if (renderPassPipelineState_ == nullptr)
@@ -435,73 +433,19 @@ bool PipelineStateVulkan::CreateGraphicsPipeline()
 
 	graphicsPipelineInfo.renderPass = renderPass;
 
-	auto stageFlag = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
-
-	// uniform layout info
-	std::array<vk::DescriptorSetLayoutBinding, 4> uboLayoutBindings;
-	for (size_t i = 0; i < uboLayoutBindings.size(); i++)
-	{
-		uboLayoutBindings[i].binding = static_cast<int>(i);
-		uboLayoutBindings[i].descriptorType = vk::DescriptorType::eUniformBufferDynamic;
-		uboLayoutBindings[i].descriptorCount = 1;
-		uboLayoutBindings[i].stageFlags = stageFlag;
-		uboLayoutBindings[i].pImmutableSamplers = nullptr;
-	}
-
-	std::array<vk::DescriptorSetLayoutBinding, TextureSlotMax> textureLayoutBindings;
-
-	for (size_t i = 0; i < textureLayoutBindings.size(); i++)
-	{
-		textureLayoutBindings[i].binding = static_cast<uint32_t>(i);
-		textureLayoutBindings[i].descriptorType = vk::DescriptorType::eCombinedImageSampler;
-		textureLayoutBindings[i].descriptorCount = 1;
-		textureLayoutBindings[i].stageFlags = stageFlag;
-		textureLayoutBindings[i].pImmutableSamplers = nullptr;
-	}
-
-	// compute buffer info(readonly)
-	std::array<vk::DescriptorSetLayoutBinding, 8> computeLayoutBindings;
-
-	for (size_t i = 0; i < computeLayoutBindings.size(); i++)
-	{
-		computeLayoutBindings[i].binding = static_cast<uint32_t>(i);
-		computeLayoutBindings[i].descriptorType = vk::DescriptorType::eStorageBufferDynamic;
-		computeLayoutBindings[i].descriptorCount = 1;
-		computeLayoutBindings[i].stageFlags = stageFlag;
-		computeLayoutBindings[i].pImmutableSamplers = nullptr;
-	}
-
-	vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutInfos[3];
-	descriptorSetLayoutInfos[0].bindingCount = static_cast<int32_t>(uboLayoutBindings.size());
-	descriptorSetLayoutInfos[0].pBindings = uboLayoutBindings.data();
-	descriptorSetLayoutInfos[1].bindingCount = static_cast<int32_t>(textureLayoutBindings.size());
-	descriptorSetLayoutInfos[1].pBindings = textureLayoutBindings.data();
-	descriptorSetLayoutInfos[2].bindingCount = static_cast<int32_t>(computeLayoutBindings.size());
-	descriptorSetLayoutInfos[2].pBindings = computeLayoutBindings.data();
-
-	descriptorSetLayouts_[0] = graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfos[0]);
-	descriptorSetLayouts_[1] = graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfos[1]);
-	descriptorSetLayouts_[2] = graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfos[2]);
-
-	vk::PipelineLayoutCreateInfo layoutInfo = {};
-	layoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts_.size());
-	layoutInfo.pSetLayouts = descriptorSetLayouts_.data();
-	layoutInfo.pushConstantRangeCount = 0;
-	layoutInfo.pPushConstantRanges = nullptr;
-
-	pipelineLayout_ = graphics_->GetDevice().createPipelineLayout(layoutInfo);
-	graphicsPipelineInfo.layout = pipelineLayout_;
+	// layouts are shared among pipeline states so that descriptor sets are compatible
+	graphicsPipelineInfo.layout = graphics_->GetPipelineLayout();
 
 #if VK_HEADER_VERSION >= 136
 	// setup a pipeline
-	const auto pipeline = graphics_->GetDevice().createGraphicsPipeline(nullptr, graphicsPipelineInfo);
+	const auto pipeline = graphics_->GetDevice().createGraphicsPipeline(graphics_->GetPipelineCache(), graphicsPipelineInfo);
 	if (pipeline.result != vk::Result::eSuccess)
 	{
 		throw std::runtime_error("Cannnot create graphicPipeline: " + std::to_string(static_cast<int>(pipeline.result)));
 	}
 	pipeline_ = pipeline.value;
 #else
-	pipeline_ = graphics_->GetDevice().createGraphicsPipeline(nullptr, graphicsPipelineInfo);
+	pipeline_ = graphics_->GetDevice().createGraphicsPipeline(graphics_->GetPipelineCache(), graphicsPipelineInfo);
 #endif
 
 	return true;
@@ -526,88 +470,19 @@ bool PipelineStateVulkan::CreateComputePipeline()
 	info.pName = mainName.c_str();
 	computePipelineInfo.stage = info;
 
-	// uniform layout info
-
-	auto stageFlag = vk::ShaderStageFlagBits::eCompute;
-
-	// uniform layout info
-	std::array<vk::DescriptorSetLayoutBinding, 4> uboLayoutBindings;
-	for (size_t i = 0; i < uboLayoutBindings.size(); i++)
-	{
-		uboLayoutBindings[i].binding = static_cast<int>(i);
-		uboLayoutBindings[i].descriptorType = vk::DescriptorType::eUniformBufferDynamic;
-		uboLayoutBindings[i].descriptorCount = 1;
-		uboLayoutBindings[i].stageFlags = stageFlag;
-		uboLayoutBindings[i].pImmutableSamplers = nullptr;
-	}
-
-	std::array<vk::DescriptorSetLayoutBinding, TextureSlotMax> textureLayoutBindings;
-
-	for (size_t i = 0; i < textureLayoutBindings.size(); i++)
-	{
-		textureLayoutBindings[i].binding = static_cast<uint32_t>(i);
-		textureLayoutBindings[i].descriptorType = vk::DescriptorType::eCombinedImageSampler;
-		textureLayoutBindings[i].descriptorCount = 1;
-		textureLayoutBindings[i].stageFlags = stageFlag;
-		textureLayoutBindings[i].pImmutableSamplers = nullptr;
-	}
-
-	std::array<vk::DescriptorSetLayoutBinding, 8> computeLayoutBindings;
-
-	for (size_t i = 0; i < computeLayoutBindings.size(); i++)
-	{
-		computeLayoutBindings[i].binding = static_cast<uint32_t>(i);
-		computeLayoutBindings[i].descriptorType = vk::DescriptorType::eStorageBufferDynamic;
-		computeLayoutBindings[i].descriptorCount = 1;
-		computeLayoutBindings[i].stageFlags = stageFlag;
-		computeLayoutBindings[i].pImmutableSamplers = nullptr;
-	}
-
-	std::array<vk::DescriptorSetLayoutBinding, TextureSlotMax> storageImageLayoutBindings;
-
-	for (size_t i = 0; i < storageImageLayoutBindings.size(); i++)
-	{
-		storageImageLayoutBindings[i].binding = static_cast<uint32_t>(i);
-		storageImageLayoutBindings[i].descriptorType = vk::DescriptorType::eStorageImage;
-		storageImageLayoutBindings[i].descriptorCount = 1;
-		storageImageLayoutBindings[i].stageFlags = stageFlag;
-		storageImageLayoutBindings[i].pImmutableSamplers = nullptr;
-	}
-
-	vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutInfos[4];
-	descriptorSetLayoutInfos[0].bindingCount = static_cast<int32_t>(uboLayoutBindings.size());
-	descriptorSetLayoutInfos[0].pBindings = uboLayoutBindings.data();
-	descriptorSetLayoutInfos[1].bindingCount = static_cast<int32_t>(textureLayoutBindings.size());
-	descriptorSetLayoutInfos[1].pBindings = textureLayoutBindings.data();
-	descriptorSetLayoutInfos[2].bindingCount = static_cast<int32_t>(computeLayoutBindings.size());
-	descriptorSetLayoutInfos[2].pBindings = computeLayoutBindings.data();
-	descriptorSetLayoutInfos[3].bindingCount = static_cast<int32_t>(storageImageLayoutBindings.size());
-	descriptorSetLayoutInfos[3].pBindings = storageImageLayoutBindings.data();
-
-	computeDescriptorSetLayouts_[0] = graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfos[0]);
-	computeDescriptorSetLayouts_[1] = graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfos[1]);
-	computeDescriptorSetLayouts_[2] = graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfos[2]);
-	computeDescriptorSetLayouts_[3] = graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfos[3]);
-
-	vk::PipelineLayoutCreateInfo layoutInfo = {};
-	layoutInfo.setLayoutCount = 4;
-	layoutInfo.pSetLayouts = computeDescriptorSetLayouts_.data();
-	layoutInfo.pushConstantRangeCount = 0;
-	layoutInfo.pPushConstantRanges = nullptr;
-
-	computePipelineLayout_ = graphics_->GetDevice().createPipelineLayout(layoutInfo);
-	computePipelineInfo.layout = computePipelineLayout_;
+	// layouts are shared among pipeline states so that descriptor sets are compatible
+	computePipelineInfo.layout = graphics_->GetComputePipelineLayout();
 
 #if VK_HEADER_VERSION >= 136
 	// setup a pipeline
-	const auto pipeline = graphics_->GetDevice().createComputePipeline(nullptr, computePipelineInfo);
+	const auto pipeline = graphics_->GetDevice().createComputePipeline(graphics_->GetPipelineCache(), computePipelineInfo);
 	if (pipeline.result != vk::Result::eSuccess)
 	{
 		throw std::runtime_error("Cannnot create graphicPipeline: " + std::to_string(static_cast<int>(pipeline.result)));
 	}
 	computePipeline_ = pipeline.value;
 #else
-	computePipeline_ = graphics_->GetDevice().createComputePipeline(nullptr, computePipelineInfo);
+	computePipeline_ = graphics_->GetDevice().createComputePipeline(graphics_->GetPipelineCache(), computePipelineInfo);
 #endif
 
 	return true;
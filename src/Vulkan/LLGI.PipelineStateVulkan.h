@@ -15,12 +15,7 @@ private:
 	std::array<Shader*, static_cast<int>(ShaderStageType::Max)> shaders;
 
 	vk::Pipeline pipeline_ = nullptr;
-	vk::PipelineLayout pipelineLayout_ = nullptr;
-	std::array<vk::DescriptorSetLayout, 3> descriptorSetLayouts_;
-
 	vk::Pipeline computePipeline_ = nullptr;
-	vk::PipelineLayout computePipelineLayout_ = nullptr;
-	std::array<vk::DescriptorSetLayout, 4> computeDescriptorSetLayouts_;
 
 	bool CreateGraphicsPipeline();
 	bool CreateComputePipeline();
@@ -35,17 +30,22 @@ public:
 
 	bool Compile() override;
 
+	std::shared_future<bool> CompileAsync() override;
+
 	vk::Pipeline GetPipeline() const { return pipeline_; }
 
-	vk::PipelineLayout GetPipelineLayout() const { return pipelineLayout_; }
+	vk::PipelineLayout GetPipelineLayout() const { return graphics_->GetPipelineLayout(); }
 
-	const std::array<vk::DescriptorSetLayout, 3>& GetDescriptorSetLayout() const { return descriptorSetLayouts_; }
+	const std::array<vk::DescriptorSetLayout, 3>& GetDescriptorSetLayout() const { return graphics_->GetDescriptorSetLayouts(); }
 
 	vk::Pipeline GetComputePipeline() const { return computePipeline_; }
 
-	vk::PipelineLayout GetComputePipelineLayout() const { return computePipelineLayout_; }
+	vk::PipelineLayout GetComputePipelineLayout() const { return graphics_->GetComputePipelineLayout(); }
 
-	const std::array<vk::DescriptorSetLayout, 4>& GetComputeDescriptorSetLayout() const { return computeDescriptorSetLayouts_; }
+	const std::array<vk::DescriptorSetLayout, 4>& GetComputeDescriptorSetLayout() const
+	{
+		return graphics_->GetComputeDescriptorSetLayouts();
+	}
 };
 
 } // namespace LLGI
@@ -51,11 +51,6 @@ bool PlatformVulkan::CreateSwapChain(Vec2I windowSize, bool waitVSync)
 			for (uint32_t i = 0; i < swapBuffers.size(); i++)
 			{
 				vkDevice_.destroyImageView(swapBuffers[i].view);
-				if (swapBuffers[i].fence)
-				{
-					vkDevice_.destroyFence(swapBuffers[i].fence);
-				}
-
 				SafeRelease(swapBuffers[i].texture);
 			}
 			vkDevice_.destroySwapchainKHR(oldSwapChain);
@@ -155,7 +150,7 @@ bool PlatformVulkan::CreateSwapChain(Vec2I windowSize, bool waitVSync)
 			swapBuffers[i].image = swapChainImages[i];
 			viewCreateInfo.image = swapChainImages[i];
 			swapBuffers[i].view = vkDevice_.createImageView(viewCreateInfo);
-			swapBuffers[i].fence = vk::Fence();
+			swapBuffers[i].submittedValue = 0;
 
 			swapBuffers[i].texture = new TextureVulkan();
 			if (!swapBuffers[i].texture->InitializeAsScreen(swapBuffers[i].image, swapBuffers[i].view, surfaceFormat, windowSize))
@@ -169,6 +164,76 @@ bool PlatformVulkan::CreateSwapChain(Vec2I windowSize, bool waitVSync)
 	return true;
 }
 
+bool PlatformVulkan::CreateOffscreenScreens(Vec2I screenSize)
+{
+	for (auto& swapBuffer : swapBuffers)
+	{
+		SafeRelease(swapBuffer.texture);
+	}
+	swapBuffers.clear();
+
+	frameIndex = 0;
+
+	if (screenSize.X == 0 || screenSize.Y == 0)
+	{
+		return true;
+	}
+
+	// same as the number which is requested for a swapchain
+	swapBufferCount = swapBufferCountMin_ + 1;
+
+	TextureParameter param;
+	param.Usage = TextureUsageType::RenderTarget;
+	param.Format = VulkanHelper::VkFormatToTextureFormat(static_cast<VkFormat>(surfaceFormat));
+	param.Dimension = 2;
+	param.MipLevelCount = 1;
+	param.SampleCount = 1;
+	param.Size = {screenSize.X, screenSize.Y, 1};
+
+	swapBuffers.resize(swapBufferCount);
+	for (auto& swapBuffer : swapBuffers)
+	{
+		swapBuffer.texture = new TextureVulkan();
+		if (!swapBuffer.texture->Initialize(nullptr, vkDevice_, vkPhysicalDevice, nullptr, param))
+		{
+			Log(LogType::Error, "failed to create a texture while creating offscreen screens.");
+			return false;
+		}
+	}
+
+	// screens must be readable from the first frame, so the states are changed with a command buffer
+	vk::CommandBufferAllocateInfo cmdBufInfo;
+	cmdBufInfo.commandPool = vkCmdPool_;
+	cmdBufInfo.level = vk::CommandBufferLevel::ePrimary;
+	cmdBufInfo.commandBufferCount = 1;
+	auto cmdBuffers = vkDevice_.allocateCommandBuffersUnique(cmdBufInfo);
+
+	vk::CommandBufferBeginInfo cmdBufferBeginInfo;
+	cmdBuffers[0]->begin(cmdBufferBeginInfo);
+	for (auto& swapBuffer : swapBuffers)
+	{
+		swapBuffer.texture->ResourceBarrier(cmdBuffers[0].get(), vk::ImageLayout::eShaderReadOnlyOptimal);
+	}
+	cmdBuffers[0]->end();
+
+	vk::SubmitInfo submitInfo;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &(cmdBuffers[0].get());
+	timeline_->Wait(timeline_->Submit(vkQueue, submitInfo));
+
+	return true;
+}
+
+bool PlatformVulkan::CreateScreens(Vec2I windowSize, bool waitVSync)
+{
+	if (isHeadless_)
+	{
+		return CreateOffscreenScreens(windowSize);
+	}
+
+	return CreateSwapChain(windowSize, waitVSync);
+}
+
 bool PlatformVulkan::CreateDepthBuffer(Vec2I windowSize)
 {
 	SafeRelease(depthStencilTexture_);
@@ -208,6 +273,9 @@ void PlatformVulkan::CreateRenderPass()
 
 		renderPass->Initialize(const_cast<const TextureVulkan**>(textures.data()), 1, depthStencilTexture_, nullptr, nullptr);
 
+		// a depth of a screen is not used after the frame, so it is not written back
+		renderPass->SetDepthStoreOp(AttachmentStoreOp::Discard);
+
 		renderPasses_.emplace_back(CreateSharedPtr(renderPass));
 	}
 }
@@ -221,24 +289,32 @@ uint32_t PlatformVulkan::AcquireNextImage(vk::Semaphore& semaphore)
 	return frameIndex;
 }
 
-vk::Fence PlatformVulkan::GetSubmitFence(bool destroy)
+bool PlatformVulkan::CreateFramesInFlight()
 {
-	auto& image = swapBuffers[frameIndex];
-	while (image.fence)
+	// resources of a command list or a memory pool are reused after frames as many as swap buffers
+	if (maxFramesInFlight_ > swapBufferCount)
 	{
-		vk::Result fenceRes = vkDevice_.waitForFences(image.fence, VK_TRUE, std::numeric_limits<int>::max());
-		if (fenceRes == vk::Result::eSuccess)
-		{
-			if (destroy)
-			{
-				vkDevice_.destroyFence(image.fence);
-			}
-			image.fence = vk::Fence();
-		}
+		Log(LogType::Info, "The maximum number of frames in flight is clamped to the number of swap buffers.");
+		maxFramesInFlight_ = std::max(swapBufferCount, 1);
+	}
+
+	vk::CommandBufferAllocateInfo allocInfo;
+	allocInfo.commandPool = vkCmdPool_;
+	allocInfo.commandBufferCount = maxFramesInFlight_;
+	auto commandBuffers = vkDevice_.allocateCommandBuffers(allocInfo);
+
+	framesInFlight_.resize(maxFramesInFlight_);
+	for (size_t i = 0; i < framesInFlight_.size(); i++)
+	{
+		auto& frame = framesInFlight_[i];
+		frame.presentComplete = vkDevice_.createSemaphore(vk::SemaphoreCreateInfo());
+		frame.renderComplete = vkDevice_.createSemaphore(vk::SemaphoreCreateInfo());
+		frame.submittedValue = 0;
+		frame.commandBuffer = commandBuffers[i];
 	}
 
-	image.fence = vkDevice_.createFence(vk::FenceCreateFlags());
-	return image.fence;
+	currentFrameInFlight_ = 0;
+	return true;
 }
 
 vk::Result PlatformVulkan::Present(vk::Semaphore semaphore)
@@ -271,11 +347,6 @@ void PlatformVulkan::Reset()
 				vkDevice_.destroyImageView(swapBuffer.view);
 			}
 
-			if (swapBuffer.fence)
-			{
-				vkDevice_.destroyFence(swapBuffer.fence);
-			}
-
 			SafeRelease(swapBuffer.texture);
 		}
 		swapBuffers.clear();
@@ -296,23 +367,28 @@ void PlatformVulkan::Reset()
 			vkPipelineCache_ = nullptr;
 		}
 
-		if (vkPresentComplete_)
+		for (auto& frame : framesInFlight_)
 		{
-			vkDevice_.destroySemaphore(vkPresentComplete_);
-			vkPresentComplete_ = nullptr;
-		}
+			if (frame.presentComplete)
+			{
+				vkDevice_.destroySemaphore(frame.presentComplete);
+			}
 
-		if (vkRenderComplete_)
-		{
-			vkDevice_.destroySemaphore(vkRenderComplete_);
-			vkRenderComplete_ = nullptr;
-		}
+			if (frame.renderComplete)
+			{
+				vkDevice_.destroySemaphore(frame.renderComplete);
+			}
 
-		if (vkCmdBuffers.size() > 0)
-		{
-			vkDevice_.freeCommandBuffers(vkCmdPool_, vkCmdBuffers);
-			vkCmdBuffers.clear();
+			if (frame.commandBuffer)
+			{
+				vkDevice_.freeCommandBuffers(vkCmdPool_, frame.commandBuffer);
+			}
 		}
+		framesInFlight_.clear();
+
+		// submissions are completed before the device is destroyed
+		deferredDestroyQueue_.reset();
+		timeline_.reset();
 
 		if (vkCmdPool_)
 		{
@@ -389,6 +465,17 @@ std::vector<const char*> PlatformVulkan::GetOptimalLayers(const std::vector<VkLa
 
 PlatformVulkan::PlatformVulkan() {}
 
+void PlatformVulkan::SetMaxFramesInFlight(int32_t maxFramesInFlight)
+{
+	if (vkDevice_)
+	{
+		Log(LogType::Warning, "The maximum number of frames in flight must be set before initializing.");
+		return;
+	}
+
+	maxFramesInFlight_ = std::max(maxFramesInFlight, 1);
+}
+
 PlatformVulkan::~PlatformVulkan()
 {
 	// destroy vulkan
@@ -441,6 +528,23 @@ PlatformVulkan::~PlatformVulkan()
 }
 
 bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
+{
+	if (window == nullptr)
+	{
+		Log(LogType::Error, "A window is required. Use InitializeAsHeadless without a window.");
+		return false;
+	}
+
+	return InitializeInternal(window, window->GetWindowSize(), waitVSync);
+}
+
+bool PlatformVulkan::InitializeAsHeadless(const Vec2I& screenSize)
+{
+	isHeadless_ = true;
+	return InitializeInternal(nullptr, screenSize, false);
+}
+
+bool PlatformVulkan::InitializeInternal(Window* window, const Vec2I& windowSize, bool waitVSync)
 {
 	window_ = window;
 	waitVSync_ = waitVSync;
@@ -455,19 +559,37 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 	appInfo.apiVersion = VK_API_VERSION_1_0;
 
 	// specify extension
-	const std::vector<const char*> extensions = {
-		VK_KHR_SURFACE_EXTENSION_NAME,
-#ifdef _WIN32
-		VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
-#else
-		VK_KHR_XCB_SURFACE_EXTENSION_NAME,
-#endif
+	std::vector<const char*> extensions = {
 #if !defined(NDEBUG)
 		VK_EXT_DEBUG_REPORT_EXTENSION_NAME,
 		VK_EXT_DEBUG_UTILS_EXTENSION_NAME,
 #endif
 	};
 
+	if (!isHeadless_)
+	{
+		extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+#ifdef _WIN32
+		extensions.push_back(VK_KHR_WIN32_SURFACE_EXTENSION_NAME);
+#else
+		extensions.push_back(VK_KHR_XCB_SURFACE_EXTENSION_NAME);
+#endif
+	}
+
+#if defined(VK_KHR_timeline_semaphore)
+	// a timeline semaphore depends on it with Vulkan 1.0
+	bool isProperties2Enabled = false;
+	for (const auto& property : vk::enumerateInstanceExtensionProperties())
+	{
+		if (strcmp(property.extensionName, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0)
+		{
+			extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+			isProperties2Enabled = true;
+			break;
+		}
+	}
+#endif
+
 	auto exitWithError = [this]() -> void {
 		Reset();
 
@@ -534,17 +656,20 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 		// vk::PhysicalDeviceMemoryProperties deviceMemoryProperties = vkPhysicalDevice.getMemoryProperties();
 
 		// create surface
+		if (!isHeadless_)
+		{
 #ifdef _WIN32
-		vk::Win32SurfaceCreateInfoKHR surfaceCreateInfo;
-		surfaceCreateInfo.hinstance = (HINSTANCE)window->GetNativePtr(1);
-		surfaceCreateInfo.hwnd = (HWND)window->GetNativePtr(0);
-		surface_ = vkInstance_.createWin32SurfaceKHR(surfaceCreateInfo);
+			vk::Win32SurfaceCreateInfoKHR surfaceCreateInfo;
+			surfaceCreateInfo.hinstance = (HINSTANCE)window->GetNativePtr(1);
+			surfaceCreateInfo.hwnd = (HWND)window->GetNativePtr(0);
+			surface_ = vkInstance_.createWin32SurfaceKHR(surfaceCreateInfo);
 #else
-		vk::XcbSurfaceCreateInfoKHR surfaceCreateInfo;
-		surfaceCreateInfo.connection = XGetXCBConnection((Display*)window->GetNativePtr(0));
-		surfaceCreateInfo.window = ((::Window)window->GetNativePtr(1));
-		surface_ = vkInstance_.createXcbSurfaceKHR(surfaceCreateInfo);
+			vk::XcbSurfaceCreateInfoKHR surfaceCreateInfo;
+			surfaceCreateInfo.connection = XGetXCBConnection((Display*)window->GetNativePtr(0));
+			surfaceCreateInfo.window = ((::Window)window->GetNativePtr(1));
+			surface_ = vkInstance_.createXcbSurfaceKHR(surfaceCreateInfo);
 #endif
+		}
 		// create device
 
 		// find queue for graphics
@@ -576,12 +701,37 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 		queueCreateInfo.pQueuePriorities = queuePriorities;
 		queueFamilyIndex_ = queueCreateInfo.queueFamilyIndex;
 
-		const std::vector<const char*> enabledExtensions = {
-			VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+		std::vector<const char*> enabledExtensions = {
 #if !defined(NDEBUG)
 		// VK_EXT_DEBUG_MARKER_EXTENSION_NAME,
 #endif
 		};
+
+		if (!isHeadless_)
+		{
+			enabledExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+		}
+
+		// submissions are tracked with a timeline semaphore if it is supported
+		bool isTimelineSemaphoreEnabled = false;
+#if defined(VK_KHR_timeline_semaphore)
+		vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures;
+		timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+
+		if (isProperties2Enabled)
+		{
+			for (const auto& property : vkPhysicalDevice.enumerateDeviceExtensionProperties())
+			{
+				if (strcmp(property.extensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0)
+				{
+					enabledExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+					isTimelineSemaphoreEnabled = true;
+					break;
+				}
+			}
+		}
+#endif
+
 		vk::DeviceCreateInfo deviceCreateInfo;
 		deviceCreateInfo.queueCreateInfoCount = 1;
 		deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
@@ -602,8 +752,19 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 #else
 		deviceCreateInfo.enabledLayerCount = 0;
 #endif
+
+#if defined(VK_KHR_timeline_semaphore)
+		if (isTimelineSemaphoreEnabled)
+		{
+			deviceCreateInfo.pNext = &timelineSemaphoreFeatures;
+		}
+#endif
+
 		vkDevice_ = vkPhysicalDevice.createDevice(deviceCreateInfo);
 
+		timeline_ = std::make_shared<TimelineVulkan>(vkDevice_, isTimelineSemaphoreEnabled);
+		deferredDestroyQueue_ = std::make_shared<DeferredDestroyQueueVulkan>(timeline_);
+
 #if !defined(NDEBUG)
 		// get callbacks
 		createDebugReportCallback = (PFN_vkCreateDebugReportCallbackEXT)vkInstance_.getProcAddr("vkCreateDebugReportCallbackEXT");
@@ -635,50 +796,48 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 		vkCmdPool_ = vkDevice_.createCommandPool(cmdPoolInfo);
 
 		// get supported formats
-		auto surfaceFormats = vkPhysicalDevice.getSurfaceFormatsKHR(surface_);
-
 		surfaceFormat = vk::Format::eR8G8B8A8Unorm;
-		if (surfaceFormats[0].format != vk::Format::eUndefined)
+
+		if (!isHeadless_)
 		{
-			surfaceFormat = surfaceFormats[0].format;
-		}
+			auto surfaceFormats = vkPhysicalDevice.getSurfaceFormatsKHR(surface_);
 
-		surfaceColorSpace = surfaceFormats[0].colorSpace;
+			if (surfaceFormats[0].format != vk::Format::eUndefined)
+			{
+				surfaceFormat = surfaceFormats[0].format;
+			}
 
-		// create swapchain
-		if (!vkPhysicalDevice.getSurfaceSupportKHR(graphicsQueueInd, surface_))
-		{
+			surfaceColorSpace = surfaceFormats[0].colorSpace;
+
+			// create swapchain
+			if (!vkPhysicalDevice.getSurfaceSupportKHR(graphicsQueueInd, surface_))
+			{
+			}
 		}
 
-		if (!CreateSwapChain(window->GetWindowSize(), waitVSync))
+		if (!CreateScreens(windowSize, waitVSync))
 		{
-			Log(LogType::Error, "Swapchain is not supported.");
+			Log(LogType::Error, isHeadless_ ? "Failed to create offscreen screens." : "Swapchain is not supported.");
 			exitWithError();
 			return false;
 		}
 
-		// create semaphore
-		vk::SemaphoreCreateInfo semaphoreCreateInfo;
-
-		vkPresentComplete_ = vkDevice_.createSemaphore(semaphoreCreateInfo);
-
-		vkRenderComplete_ = vkDevice_.createSemaphore(semaphoreCreateInfo);
-
-		// create command buffer
-		vk::CommandBufferAllocateInfo allocInfo;
-		allocInfo.commandPool = vkCmdPool_;
-		allocInfo.commandBufferCount = swapBufferCount;
-		vkCmdBuffers = vkDevice_.allocateCommandBuffers(allocInfo);
+		// create semaphores and command buffers of frames
+		if (!CreateFramesInFlight())
+		{
+			exitWithError();
+			return false;
+		}
 
 		// create depth buffer
-		if (!CreateDepthBuffer(window->GetWindowSize()))
+		if (!CreateDepthBuffer(windowSize))
 		{
 			exitWithError();
 			return false;
 		}
 
-		windowSize_ = window->GetWindowSize();
-		renderPassPipelineStateCache_ = new RenderPassPipelineStateCacheVulkan(vkDevice_, nullptr);
+		windowSize_ = windowSize;
+		renderPassPipelineStateCache_ = new RenderPassPipelineStateCacheVulkan(vkDevice_, timeline_, nullptr);
 
 		// create renderpasses
 		CreateRenderPass();
@@ -700,68 +859,99 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 
 bool PlatformVulkan::NewFrame()
 {
-	if (!window_->OnNewFrame())
+	if (window_ != nullptr && !window_->OnNewFrame())
 	{
 		return false;
 	}
 
-	if (IsSwapchainValid())
+	if (!IsScreenValid())
+	{
+		return true;
+	}
+
+	// cpu waits only for the frame which used the same resources
+	auto& frame = framesInFlight_[currentFrameInFlight_];
+	if (!timeline_->Wait(frame.submittedValue))
+	{
+		return false;
+	}
+
+	deferredDestroyQueue_->Collect();
+
+	if (isHeadless_)
+	{
+		frameIndex = (frameIndex + 1) % static_cast<uint32_t>(swapBuffers.size());
+	}
+	else
+	{
+		AcquireNextImage(frame.presentComplete);
+	}
+
+	// an image may be acquired while another frame uses it if there are fewer images than frames
+	if (!timeline_->Wait(swapBuffers[frameIndex].submittedValue))
 	{
-		AcquireNextImage(vkPresentComplete_);
+		return false;
 	}
-	executedCommandCount = 0;
+
 	return true;
 }
 
 void PlatformVulkan::Present()
 {
-	if (!IsSwapchainValid())
+	if (!IsScreenValid())
 	{
 		return;
 	}
 
-	// waiting or empty command
-	auto& cmdBuffer = vkCmdBuffers[frameIndex];
+	// the command buffer is not used by gpu because the frame has been waited for in NewFrame
+	auto& frame = framesInFlight_[currentFrameInFlight_];
+	auto& cmdBuffer = frame.commandBuffer;
 
 	cmdBuffer.reset(vk::CommandBufferResetFlagBits::eReleaseResources);
 	vk::CommandBufferBeginInfo cmdBufInfo;
 	cmdBuffer.begin(cmdBufInfo);
 
-	if (swapBuffers[frameIndex].texture->GetImageLayouts()[0] != vk::ImageLayout::ePresentSrcKHR)
+	if (isHeadless_)
+	{
+		// nothing is shown. a screen is kept readable until it is used again.
+		swapBuffers[frameIndex].texture->ResourceBarrier(cmdBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
+	}
+	else if (swapBuffers[frameIndex].texture->GetImageLayouts()[0] != vk::ImageLayout::ePresentSrcKHR)
 	{
-		swapBuffers[frameIndex].texture->ResourceBarrier(cmdBuffer, vk::ImageLayout::eColorAttachmentOptimal);
 		swapBuffers[frameIndex].texture->ResourceBarrier(cmdBuffer, vk::ImageLayout::ePresentSrcKHR);
 	}
 
 	cmdBuffer.end();
 
-	{
-		vk::PipelineStageFlags pipelineStages = vk::PipelineStageFlagBits::eBottomOfPipe;
-		vk::SubmitInfo submitInfo;
-		submitInfo.pWaitDstStageMask = &pipelineStages;
+	vk::PipelineStageFlags pipelineStages = vk::PipelineStageFlagBits::eBottomOfPipe;
+	vk::SubmitInfo submitInfo;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &cmdBuffer;
 
+	if (!isHeadless_)
+	{
 		// send semaphore to be need to wait
+		submitInfo.pWaitDstStageMask = &pipelineStages;
 		submitInfo.waitSemaphoreCount = 1;
-		submitInfo.pWaitSemaphores = &vkPresentComplete_;
-
-		// set command
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &cmdBuffer;
+		submitInfo.pWaitSemaphores = &frame.presentComplete;
 
 		// set a semaphore which notify to finish to execute commands
 		submitInfo.signalSemaphoreCount = 1;
-		submitInfo.pSignalSemaphores = &vkRenderComplete_;
+		submitInfo.pSignalSemaphores = &frame.renderComplete;
+	}
 
-		vk::Fence fence = GetSubmitFence(true);
-		vkQueue.submit(submitInfo, fence);
-		vk::Result fenceRes = vkDevice_.waitForFences(fence, VK_TRUE, std::numeric_limits<int>::max());
-		if (fenceRes != vk::Result::eSuccess)
-		{
-			throw "Invalid waitForFences";
-		}
+	// the value is waited for when the frame is reused instead of now, so cpu records next frames while gpu executes this frame
+	frame.submittedValue = timeline_->Submit(vkQueue, submitInfo);
+	swapBuffers[frameIndex].submittedValue = frame.submittedValue;
+
+	currentFrameInFlight_ = (currentFrameInFlight_ + 1) % static_cast<uint32_t>(framesInFlight_.size());
+
+	if (isHeadless_)
+	{
+		return;
 	}
 
-	const auto result = Present(vkRenderComplete_);
+	const auto result = Present(frame.renderComplete);
 
 	// TODO optimize it
 	if (result == vk::Result::eErrorOutOfDateKHR)
@@ -781,7 +971,7 @@ void PlatformVulkan::SetWindowSize(const Vec2I& windowSize)
 	}
 
 	vkDevice_.waitIdle();
-	CreateSwapChain(windowSize, waitVSync_);
+	CreateScreens(windowSize, waitVSync_);
 
 	CreateDepthBuffer(windowSize);
 
@@ -791,35 +981,24 @@ void PlatformVulkan::SetWindowSize(const Vec2I& windowSize)
 
 Graphics* PlatformVulkan::CreateGraphics()
 {
-	auto addCommand = [this](vk::CommandBuffer commandBuffer, vk::Fence fence) -> void {
-		std::array<vk::SubmitInfo, 1> copySubmitInfos;
-		copySubmitInfos[0].commandBufferCount = 1;
-		copySubmitInfos[0].pCommandBuffers = &commandBuffer;
-		const auto submitResult = vkQueue.submit(static_cast<uint32_t>(copySubmitInfos.size()), copySubmitInfos.data(), fence);
-		if (submitResult != vk::Result::eSuccess)
-		{
-			LLGI::Log(LogType::Error, "Failed to submit");
-			return;
-		}
-
-		this->executedCommandCount++;
-	};
-
 	auto graphics = new GraphicsVulkan(vkDevice_,
 									   vkQueue,
 									   vkCmdPool_,
 									   vkPhysicalDevice,
 									   static_cast<int32_t>(swapBuffers.size()),
-									   addCommand,
+									   timeline_,
 									   renderPassPipelineStateCache_,
-									   this);
+									   this,
+									   queueFamilyIndex_,
+									   vkPipelineCache_,
+									   deferredDestroyQueue_);
 
 	return graphics;
 }
 
 RenderPass* PlatformVulkan::GetCurrentScreen(const Color8& clearColor, bool isColorCleared, bool isDepthCleared)
 {
-	if (IsSwapchainValid())
+	if (IsScreenValid())
 	{
 		auto currentRenderPass = renderPasses_[frameIndex];
 
@@ -4,6 +4,8 @@
 
 #include "../LLGI.Platform.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.DeferredDestroyQueueVulkan.h"
+#include "LLGI.TimelineVulkan.h"
 
 #ifdef _WIN32
 #include "../Win/LLGI.WindowWin.h"
@@ -33,10 +35,29 @@ private:
 	public:
 		vk::Image image = nullptr;
 		vk::ImageView view = nullptr;
-		vk::Fence fence = nullptr;
+
+		//! a value of the timeline which is signaled when a frame which uses the image last is completed
+		uint64_t submittedValue = 0;
 		TextureVulkan* texture = nullptr;
 	};
 
+	/**
+		@brief	resources of a frame which cpu records while gpu executes previous frames
+	*/
+	struct FrameInFlight
+	{
+		//! to check to finish present
+		vk::Semaphore presentComplete = nullptr;
+
+		//! to check to finish render
+		vk::Semaphore renderComplete = nullptr;
+
+		//! a value of the timeline which is signaled when gpu finishes the frame
+		uint64_t submittedValue = 0;
+
+		vk::CommandBuffer commandBuffer = nullptr;
+	};
+
 	struct DepthStencilBuffer
 	{
 		vk::Image image = nullptr;
@@ -55,14 +76,17 @@ private:
 	vk::CommandPool vkCmdPool_ = nullptr;
 	int32_t queueFamilyIndex_ = 0;
 
-	Vec2I windowSize_;
+	//! all submissions to the queue signal values of it
+	std::shared_ptr<TimelineVulkan> timeline_;
 
-	//! to check to finish present
-	vk::Semaphore vkPresentComplete_;
+	//! resources which are released while previous frames use them are destroyed with it
+	std::shared_ptr<DeferredDestroyQueueVulkan> deferredDestroyQueue_;
 
-	//! to check to finish render
-	vk::Semaphore vkRenderComplete_;
-	std::vector<vk::CommandBuffer> vkCmdBuffers;
+	Vec2I windowSize_;
+
+	int32_t maxFramesInFlight_ = 2;
+	std::vector<FrameInFlight> framesInFlight_;
+	uint32_t currentFrameInFlight_ = 0;
 
 	vk::SurfaceKHR surface_ = nullptr;
 	vk::SwapchainKHR swapchain_ = nullptr;
@@ -81,10 +105,11 @@ private:
 
 	std::vector<SwapBuffer> swapBuffers;
 
-	int32_t executedCommandCount = 0;
-
 	Window* window_ = nullptr;
 
+	//! render into offscreen screens instead of a swapchain
+	bool isHeadless_ = false;
+
 #if !defined(NDEBUG)
 	PFN_vkCreateDebugReportCallbackEXT createDebugReportCallback = nullptr;
 	PFN_vkDestroyDebugReportCallbackEXT destroyDebugReportCallback = nullptr;
@@ -95,6 +120,13 @@ private:
 
 	bool CreateSwapChain(Vec2I windowSize, bool waitVSync);
 
+	/**
+		@brief	create render targets which are used as screens instead of a swapchain in headless mode
+	*/
+	bool CreateOffscreenScreens(Vec2I screenSize);
+
+	bool CreateScreens(Vec2I windowSize, bool waitVSync);
+
 	bool CreateDepthBuffer(Vec2I windowSize);
 
 	void CreateRenderPass();
@@ -105,7 +137,7 @@ private:
 	*/
 	uint32_t AcquireNextImage(vk::Semaphore& semaphore);
 
-	vk::Fence GetSubmitFence(bool destroy = false);
+	bool CreateFramesInFlight();
 
 	/**
 		@brief	the semaphore to wait for before present
@@ -126,12 +158,35 @@ private:
 
 	bool IsSwapchainValid() const { return static_cast<bool>(swapchain_); }
 
+	bool IsScreenValid() const { return isHeadless_ ? swapBuffers.size() > 0 : IsSwapchainValid(); }
+
+	bool InitializeInternal(Window* window, const Vec2I& windowSize, bool waitVSync);
+
 public:
 	PlatformVulkan();
 	~PlatformVulkan() override;
 
+	/**
+		@brief	set the maximum number of frames which cpu records while gpu executes previous frames
+		@note
+		It must be called before initializing. cpu waits only for a frame which uses the same resources in NewFrame.
+		It is clamped to the number of swap buffers when initializing.
+	*/
+	void SetMaxFramesInFlight(int32_t maxFramesInFlight);
+
+	int32_t GetMaxFramesInFlight() const { return maxFramesInFlight_; }
+
 	bool Initialize(Window* window, bool waitVSync);
 
+	/**
+		@brief	initialize without a window and a surface
+		@note
+		Screens are offscreen render targets. They can be read with Graphics::CaptureRenderTarget.
+	*/
+	bool InitializeAsHeadless(const Vec2I& screenSize);
+
+	bool IsHeadless() const { return isHeadless_; }
+
 	bool NewFrame() override;
 	void Present() override;
 	void SetWindowSize(const Vec2I& windowSize) override;
@@ -0,0 +1,273 @@
+#include "LLGI.ReadbackVulkan.h"
+#include "LLGI.GraphicsVulkan.h"
+#include "LLGI.MemoryAllocatorVulkan.h"
+
+namespace LLGI
+{
+
+//! an offset of a copy from an image must be a multiple of a texel size and 4
+static constexpr vk::DeviceSize ReadbackAlignment = 256;
+
+static bool HasMemoryType(vk::PhysicalDevice physicalDevice, uint32_t bits, vk::MemoryPropertyFlags properties)
+{
+	const auto memoryProperties = physicalDevice.getMemoryProperties();
+	for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+	{
+		if ((bits & (1u << i)) != 0 && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+ReadbackRingVulkan::ReadbackRingVulkan(vk::Device device,
+									   vk::PhysicalDevice physicalDevice,
+									   MemoryAllocatorVulkan* memoryAllocator,
+									   vk::DeviceSize capacity)
+	: device_(device), physicalDevice_(physicalDevice), memoryAllocator_(memoryAllocator)
+{
+	ReadbackBufferVulkan ring;
+	if (CreateBuffer(capacity, ring))
+	{
+		ring_ = ring.Buffer;
+		ringAllocation_ = ring.Allocation;
+		capacity_ = capacity;
+	}
+	else
+	{
+		Log(LogType::Warning, "Failed to create a readback ring. Readback buffers are created individually.");
+	}
+}
+
+ReadbackRingVulkan::~ReadbackRingVulkan()
+{
+	if (ring_)
+	{
+		device_.destroyBuffer(ring_);
+		memoryAllocator_->Free(ringAllocation_);
+		ring_ = nullptr;
+	}
+}
+
+bool ReadbackRingVulkan::CreateBuffer(vk::DeviceSize size, ReadbackBufferVulkan& readbackBuffer)
+{
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.size = size;
+	bufferInfo.usage = vk::BufferUsageFlagBits::eTransferDst;
+	bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+
+	auto buffer = device_.createBuffer(bufferInfo);
+	auto memReqs = device_.getBufferMemoryRequirements(buffer);
+
+	// cpu reads cached memory faster
+	vk::MemoryPropertyFlags properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached;
+	if (!HasMemoryType(physicalDevice_, memReqs.memoryTypeBits, properties))
+	{
+		properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+	}
+
+	MemoryAllocationVulkan allocation;
+	if (!memoryAllocator_->Allocate(memReqs, properties, true, allocation))
+	{
+		device_.destroyBuffer(buffer);
+		return false;
+	}
+
+	device_.bindBufferMemory(buffer, allocation.Memory, allocation.Offset);
+
+	readbackBuffer.Buffer = buffer;
+	readbackBuffer.Offset = 0;
+	readbackBuffer.Size = size;
+	readbackBuffer.Allocation = allocation;
+	readbackBuffer.IsInRing = false;
+	return true;
+}
+
+bool ReadbackRingVulkan::AllocateFromRing(vk::DeviceSize size, vk::DeviceSize& offset) const
+{
+	if (ranges_.empty())
+	{
+		offset = 0;
+		return size <= capacity_;
+	}
+
+	const auto tail = ranges_.front().Offset;
+	const auto head = (ranges_.back().Offset + ranges_.back().Size + ReadbackAlignment - 1) / ReadbackAlignment * ReadbackAlignment;
+
+	if (ranges_.back().Offset >= tail)
+	{
+		// a free space is after the head and before the tail
+		if (head + size <= capacity_)
+		{
+			offset = head;
+			return true;
+		}
+
+		if (size <= tail)
+		{
+			offset = 0;
+			return true;
+		}
+
+		return false;
+	}
+
+	// the head has wrapped around
+	if (head + size <= tail)
+	{
+		offset = head;
+		return true;
+	}
+
+	return false;
+}
+
+bool ReadbackRingVulkan::Allocate(vk::DeviceSize size, ReadbackBufferVulkan& readbackBuffer)
+{
+	if (size == 0)
+	{
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		vk::DeviceSize offset = 0;
+		if (ring_ && AllocateFromRing(size, offset))
+		{
+			Range range;
+			range.Offset = offset;
+			range.Size = size;
+			ranges_.emplace_back(range);
+
+			readbackBuffer.Buffer = ring_;
+			readbackBuffer.Offset = offset;
+			readbackBuffer.Size = size;
+			readbackBuffer.Allocation = ringAllocation_;
+			readbackBuffer.IsInRing = true;
+			return true;
+		}
+	}
+
+	return CreateBuffer(size, readbackBuffer);
+}
+
+void ReadbackRingVulkan::Free(ReadbackBufferVulkan& readbackBuffer)
+{
+	if (!readbackBuffer.Buffer)
+	{
+		return;
+	}
+
+	if (readbackBuffer.IsInRing)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		for (auto& range : ranges_)
+		{
+			if (range.Offset == readbackBuffer.Offset && !range.IsReleased)
+			{
+				range.IsReleased = true;
+				break;
+			}
+		}
+
+		// the tail advances over ranges which are released out of order
+		while (!ranges_.empty() && ranges_.front().IsReleased)
+		{
+			ranges_.pop_front();
+		}
+	}
+	else
+	{
+		device_.destroyBuffer(readbackBuffer.Buffer);
+		memoryAllocator_->Free(readbackBuffer.Allocation);
+	}
+
+	readbackBuffer = ReadbackBufferVulkan();
+}
+
+const void* ReadbackRingVulkan::Map(const ReadbackBufferVulkan& readbackBuffer)
+{
+	memoryAllocator_->Invalidate(readbackBuffer.Allocation, readbackBuffer.Offset, readbackBuffer.Size);
+
+	auto mapped = static_cast<const uint8_t*>(memoryAllocator_->GetMappedPointer(readbackBuffer.Allocation));
+	if (mapped == nullptr)
+	{
+		return nullptr;
+	}
+
+	return mapped + readbackBuffer.Offset;
+}
+
+vk::DeviceSize ReadbackRingVulkan::GetUsedSize()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	vk::DeviceSize size = 0;
+	for (const auto& range : ranges_)
+	{
+		if (!range.IsReleased)
+		{
+			size += range.Size;
+		}
+	}
+	return size;
+}
+
+ReadbackVulkan::~ReadbackVulkan()
+{
+	if (graphics_ != nullptr)
+	{
+		graphics_->GetReadbackRing()->Free(readbackBuffer_);
+	}
+}
+
+bool ReadbackVulkan::Initialize(GraphicsVulkan* graphics, int32_t size)
+{
+	SafeAddRef(graphics);
+	graphics_ = CreateSharedPtr(graphics);
+	size_ = size;
+
+	if (!graphics_->GetReadbackRing()->Allocate(size, readbackBuffer_))
+	{
+		Log(LogType::Error, "Failed to allocate a readback buffer.");
+		return false;
+	}
+
+	return true;
+}
+
+bool ReadbackVulkan::GetIsCompleted() { return submittedValue_ != 0 && graphics_->GetTimeline()->IsCompleted(submittedValue_); }
+
+bool ReadbackVulkan::Wait()
+{
+	if (submittedValue_ == 0)
+	{
+		Log(LogType::Error, "Failed to wait for a readback which is not executed.");
+		return false;
+	}
+
+	return graphics_->GetTimeline()->Wait(submittedValue_);
+}
+
+bool ReadbackVulkan::GetData(std::vector<uint8_t>& data)
+{
+	if (!Wait())
+	{
+		return false;
+	}
+
+	auto mapped = graphics_->GetReadbackRing()->Map(readbackBuffer_);
+	if (mapped == nullptr)
+	{
+		return false;
+	}
+
+	data.resize(size_);
+	memcpy(data.data(), mapped, size_);
+	return true;
+}
+
+} // namespace LLGI
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../LLGI.Readback.h"
+#include "LLGI.BaseVulkan.h"
+#include <deque>
+#include <mutex>
+
+namespace LLGI
+{
+
+class GraphicsVulkan;
+class MemoryAllocatorVulkan;
+
+/**
+	@brief	a range of host visible memory which gpu copies data into
+*/
+struct ReadbackBufferVulkan
+{
+	vk::Buffer Buffer;
+	vk::DeviceSize Offset = 0;
+	vk::DeviceSize Size = 0;
+
+	//! memory which the range belongs to
+	MemoryAllocationVulkan Allocation;
+
+	bool IsInRing = false;
+};
+
+/**
+	@brief	a ring of readback buffers
+	@note
+	Readback buffers are usually released in the order in which they are allocated, so they are allocated from a ring.
+	A buffer is created individually if the ring is full.
+	Host cached memory is used if it is supported because cpu reads it.
+	It is thread safe.
+*/
+class ReadbackRingVulkan
+{
+private:
+	struct Range
+	{
+		vk::DeviceSize Offset = 0;
+		vk::DeviceSize Size = 0;
+		bool IsReleased = false;
+	};
+
+	vk::Device device_;
+	vk::PhysicalDevice physicalDevice_;
+	MemoryAllocatorVulkan* memoryAllocator_ = nullptr;
+
+	vk::Buffer ring_;
+	MemoryAllocationVulkan ringAllocation_;
+	vk::DeviceSize capacity_ = 0;
+
+	std::mutex mutex_;
+	std::deque<Range> ranges_;
+
+	bool CreateBuffer(vk::DeviceSize size, ReadbackBufferVulkan& readbackBuffer);
+
+	bool AllocateFromRing(vk::DeviceSize size, vk::DeviceSize& offset) const;
+
+public:
+	ReadbackRingVulkan(vk::Device device, vk::PhysicalDevice physicalDevice, MemoryAllocatorVulkan* memoryAllocator, vk::DeviceSize capacity);
+	~ReadbackRingVulkan();
+
+	bool Allocate(vk::DeviceSize size, ReadbackBufferVulkan& readbackBuffer);
+
+	void Free(ReadbackBufferVulkan& readbackBuffer);
+
+	/**
+		@brief	get a pointer to data which gpu has copied
+	*/
+	const void* Map(const ReadbackBufferVulkan& readbackBuffer);
+
+	vk::DeviceSize GetCapacity() const { return capacity_; }
+
+	vk::DeviceSize GetUsedSize();
+};
+
+class ReadbackVulkan : public Readback
+{
+private:
+	std::shared_ptr<GraphicsVulkan> graphics_;
+	ReadbackBufferVulkan readbackBuffer_;
+
+	//! a value of the timeline which is signaled when the copy is completed. It is 0 until the command list is executed.
+	uint64_t submittedValue_ = 0;
+
+public:
+	ReadbackVulkan() = default;
+	~ReadbackVulkan() override;
+
+	bool Initialize(GraphicsVulkan* graphics, int32_t size);
+
+	const ReadbackBufferVulkan& GetReadbackBuffer() const { return readbackBuffer_; }
+
+	//! it is called when a command list which records the copy is executed
+	void SetSubmittedValue(uint64_t value) { submittedValue_ = value; }
+
+	bool GetIsCompleted() override;
+
+	bool Wait() override;
+
+	bool GetData(std::vector<uint8_t>& data) override;
+};
+
+} // namespace LLGI
@@ -3,20 +3,45 @@
 namespace LLGI
 {
 
-RenderPassPipelineStateCacheVulkan::RenderPassPipelineStateCacheVulkan(vk::Device device, ReferenceObject* owner)
+static vk::AttachmentLoadOp GetAttachmentLoadOp(AttachmentLoadOp loadOp)
+{
+	switch (loadOp)
+	{
+	case AttachmentLoadOp::Load:
+		return vk::AttachmentLoadOp::eLoad;
+	case AttachmentLoadOp::Clear:
+		return vk::AttachmentLoadOp::eClear;
+	default:
+		return vk::AttachmentLoadOp::eDontCare;
+	}
+}
+
+static vk::AttachmentStoreOp GetAttachmentStoreOp(AttachmentStoreOp storeOp)
+{
+	// multisampled contents are resolved with resolve attachments
+	return storeOp == AttachmentStoreOp::Store ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare;
+}
+
+RenderPassPipelineStateCacheVulkan::RenderPassPipelineStateCacheVulkan(vk::Device device,
+																	   std::shared_ptr<TimelineVulkan> timeline,
+																	   ReferenceObject* owner)
 	: device_(device), owner_(owner)
 {
 	SafeAddRef(owner_);
+	framebufferCache_ = std::make_unique<FramebufferCacheVulkan>(device, timeline);
 }
 
 RenderPassPipelineStateCacheVulkan::~RenderPassPipelineStateCacheVulkan()
 {
+	framebufferCache_.reset();
 	renderPassPipelineStates_.clear();
 	SafeRelease(owner_);
 }
 
 RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const RenderPassPipelineStateKey key)
 {
+	std::lock_guard<std::mutex> lock(mutex_);
+
 	// already?
 	{
 		auto it = renderPassPipelineStates_.find(key);
@@ -38,6 +63,7 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 	bool hasDepth = key.DepthFormat != TextureFormatType::Unknown;
 	FixedSizeVector<vk::AttachmentDescription, RenderTargetMax + 1> attachmentDescs;
 	FixedSizeVector<vk::AttachmentReference, RenderTargetMax + 1> attachmentRefs;
+	FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1> initialLayouts;
 	FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1> finalLayouts;
 
 	int colorCount = static_cast<int32_t>(key.RenderTargetFormats.size());
@@ -53,30 +79,33 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 		attachmentDescs.at(i).format = (vk::Format)VulkanHelper::TextureFormatToVkFormat(key.RenderTargetFormats.at(i));
 		attachmentDescs.at(i).samples = (vk::SampleCountFlagBits)key.SamplingCount;
 
-		if (key.IsColorCleared)
-			attachmentDescs.at(i).loadOp = vk::AttachmentLoadOp::eClear;
-		else
-			attachmentDescs.at(i).loadOp = vk::AttachmentLoadOp::eDontCare;
-
-		attachmentDescs.at(i).storeOp = vk::AttachmentStoreOp::eStore;
+		attachmentDescs.at(i).loadOp = GetAttachmentLoadOp(key.ColorLoadOps.at(i));
+		attachmentDescs.at(i).storeOp = GetAttachmentStoreOp(key.ColorStoreOps.at(i));
 		attachmentDescs.at(i).stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
 		attachmentDescs.at(i).stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
 	}
 
 	if (key.IsPresent)
 	{
-		// When clearing, the initialLayout does not matter.
-		attachmentDescs.at(0).initialLayout = (key.IsColorCleared) ? vk::ImageLayout::eUndefined : vk::ImageLayout::ePresentSrcKHR;
+		// Unless loading, the initialLayout does not matter.
+		attachmentDescs.at(0).initialLayout =
+			(key.ColorLoadOps.at(0) != AttachmentLoadOp::Load) ? vk::ImageLayout::eUndefined : vk::ImageLayout::ePresentSrcKHR;
 		attachmentDescs.at(0).finalLayout = vk::ImageLayout::ePresentSrcKHR;
 	}
 	else
 	{
 		for (int i = 0; i < colorCount; i++)
 		{
-			// When clearing, the initialLayout does not matter.
-			attachmentDescs.at(i).initialLayout =
-				(key.IsColorCleared) ? vk::ImageLayout::eUndefined : vk::ImageLayout::eShaderReadOnlyOptimal;
-			attachmentDescs.at(i).finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+			// a transient attachment cannot be sampled, so it stays as an attachment
+			auto layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+			if ((key.TransientRenderTargets & (1u << i)) != 0)
+			{
+				layout = vk::ImageLayout::eColorAttachmentOptimal;
+			}
+
+			// Unless loading, the initialLayout does not matter.
+			attachmentDescs.at(i).initialLayout = (key.ColorLoadOps.at(i) != AttachmentLoadOp::Load) ? vk::ImageLayout::eUndefined : layout;
+			attachmentDescs.at(i).finalLayout = layout;
 		}
 	}
 
@@ -86,23 +115,14 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 		attachmentDescs.at(colorCount).format = (vk::Format)VulkanHelper::TextureFormatToVkFormat(key.DepthFormat);
 		attachmentDescs.at(colorCount).samples = (vk::SampleCountFlagBits)key.SamplingCount;
 
-		if (key.IsDepthCleared)
-		{
-			attachmentDescs.at(colorCount).loadOp = vk::AttachmentLoadOp::eClear;
-			attachmentDescs.at(colorCount).stencilLoadOp = vk::AttachmentLoadOp::eClear;
-		}
-		else
-		{
-			attachmentDescs.at(colorCount).loadOp = vk::AttachmentLoadOp::eDontCare;
-			attachmentDescs.at(colorCount).stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
-		}
-
-		attachmentDescs.at(colorCount).storeOp = vk::AttachmentStoreOp::eDontCare;
-		attachmentDescs.at(colorCount).stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+		attachmentDescs.at(colorCount).loadOp = GetAttachmentLoadOp(key.DepthLoadOp);
+		attachmentDescs.at(colorCount).stencilLoadOp = GetAttachmentLoadOp(key.DepthLoadOp);
+		attachmentDescs.at(colorCount).storeOp = GetAttachmentStoreOp(key.DepthStoreOp);
+		attachmentDescs.at(colorCount).stencilStoreOp = GetAttachmentStoreOp(key.DepthStoreOp);
 
-		// When clearing, the initialLayout does not matter.
+		// Unless loading, the initialLayout does not matter.
 		attachmentDescs.at(colorCount).initialLayout =
-			(key.IsDepthCleared) ? vk::ImageLayout::eUndefined : vk::ImageLayout::eDepthStencilAttachmentOptimal;
+			(key.DepthLoadOp != AttachmentLoadOp::Load) ? vk::ImageLayout::eUndefined : vk::ImageLayout::eDepthStencilAttachmentOptimal;
 		attachmentDescs.at(colorCount).finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
 		// attachmentDescs.at(colorCount).finalLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal;
 	}
@@ -170,10 +190,12 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 		// ref.layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
 	}
 
+	initialLayouts.resize(attachmentDescs.size());
 	finalLayouts.resize(attachmentDescs.size());
 
 	for (size_t i = 0; i < attachmentDescs.size(); i++)
 	{
+		initialLayouts.at(i) = attachmentDescs.at(i).initialLayout;
 		finalLayouts.at(i) = attachmentDescs.at(i).finalLayout;
 	}
 
@@ -218,6 +240,13 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 			dependencies[i * 2 + 0].dstAccessMask = (vk::AccessFlags)VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 			dependencies[i * 2 + 0].dependencyFlags = (vk::DependencyFlags)VK_DEPENDENCY_BY_REGION_BIT;
 
+			// a transient attachment is written by a previous render pass instead of being read by shaders
+			if ((key.TransientRenderTargets & (1u << i)) != 0)
+			{
+				dependencies[i * 2 + 0].srcStageMask = (vk::PipelineStageFlags)VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+				dependencies[i * 2 + 0].srcAccessMask = (vk::AccessFlags)VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			}
+
 			dependencies[i * 2 + 1].srcSubpass = 0;
 			dependencies[i * 2 + 1].dstSubpass = VK_SUBPASS_EXTERNAL;
 			dependencies[i * 2 + 1].srcStageMask = (vk::PipelineStageFlags)VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -255,6 +284,7 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 
 		std::shared_ptr<RenderPassPipelineStateVulkan> ret = CreateSharedPtr(new RenderPassPipelineStateVulkan(device_, owner_));
 		ret->renderPass_ = renderPass;
+		ret->initialLayouts_ = initialLayouts;
 		ret->finalLayouts_ = finalLayouts;
 		renderPassPipelineStates_[key] = ret;
 
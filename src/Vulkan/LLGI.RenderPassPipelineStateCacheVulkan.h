@@ -3,8 +3,10 @@
 #include "../LLGI.Graphics.h"
 #include "../Utils/LLGI.FixedSizeVector.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.FramebufferCacheVulkan.h"
 #include "LLGI.RenderPassVulkan.h"
 #include <functional>
+#include <mutex>
 #include <unordered_map>
 
 namespace LLGI
@@ -16,14 +18,22 @@ private:
 	std::unordered_map<RenderPassPipelineStateKey, std::shared_ptr<RenderPassPipelineStateVulkan>, RenderPassPipelineStateKey::Hash>
 		renderPassPipelineStates_;
 
+	//! render passes are looked up by command lists on multiple threads
+	std::mutex mutex_;
+
 	vk::Device device_;
 	ReferenceObject* owner_ = nullptr;
 
+	std::unique_ptr<FramebufferCacheVulkan> framebufferCache_;
+
 public:
-	RenderPassPipelineStateCacheVulkan(vk::Device device, ReferenceObject* owner);
+	RenderPassPipelineStateCacheVulkan(vk::Device device, std::shared_ptr<TimelineVulkan> timeline, ReferenceObject* owner);
 	~RenderPassPipelineStateCacheVulkan() override;
 
 	RenderPassPipelineStateVulkan* Create(const RenderPassPipelineStateKey key);
+
+	//! framebuffers are cached with render passes, because they are created with render passes
+	FramebufferCacheVulkan* GetFramebufferCache() const { return framebufferCache_.get(); }
 };
 
 } // namespace LLGI
@@ -13,7 +13,7 @@ namespace LLGI
 RenderPassVulkan::RenderPassVulkan(RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache,
 								   vk::Device device,
 								   ReferenceObject* owner)
-	: renderPassPipelineStateCache_(renderPassPipelineStateCache), device_(device), owner_(owner), renderPassPipelineState(nullptr)
+	: renderPassPipelineStateCache_(renderPassPipelineStateCache), device_(device), owner_(owner)
 {
 	SafeAddRef(renderPassPipelineStateCache_);
 	SafeAddRef(owner_);
@@ -23,10 +23,10 @@ RenderPassVulkan::~RenderPassVulkan()
 {
 	if (frameBuffer_)
 	{
-		device_.destroyFramebuffer(frameBuffer_);
+		renderPassPipelineStateCache_->GetFramebufferCache()->Release(framebufferKey_);
 	}
 
-	SafeRelease(renderPassPipelineState);
+	SafeRelease(renderPassPipelineState_);
 	SafeRelease(renderPassPipelineStateCache_);
 	SafeRelease(owner_);
 }
@@ -84,24 +84,30 @@ bool RenderPassVulkan::Initialize(const TextureVulkan** textures,
 		renderTargetProperties.at(i).format = textures[i]->GetVulkanFormat();
 	}
 
-	FixedSizeVector<vk::ImageView, RenderTargetMax + 1> views;
+	FixedSizeVector<vk::ImageView, RenderTargetMax + 2> views;
 	views.resize(textureCount);
+	framebufferKey_.TextureIDs.resize(textureCount);
 
 	for (int32_t i = 0; i < textureCount; i++)
 	{
 		views.at(i) = textures[i]->GetView();
+		framebufferKey_.TextureIDs.at(i) = textures[i]->GetUniqueID();
 	}
 
 	if (GetHasDepthTexture())
 	{
 		views.resize(views.size() + 1);
 		views.at(views.size() - 1) = depthTexture->GetView();
+		framebufferKey_.TextureIDs.resize(framebufferKey_.TextureIDs.size() + 1);
+		framebufferKey_.TextureIDs.at(framebufferKey_.TextureIDs.size() - 1) = depthTexture->GetUniqueID();
 	}
 
 	if (auto resolvedTextureVulkan = static_cast<TextureVulkan*>(GetResolvedRenderTexture()))
 	{
 		views.resize(views.size() + 1);
 		views.at(views.size() - 1) = resolvedTextureVulkan->GetView();
+		framebufferKey_.TextureIDs.resize(framebufferKey_.TextureIDs.size() + 1);
+		framebufferKey_.TextureIDs.at(framebufferKey_.TextureIDs.size() - 1) = resolvedTextureVulkan->GetUniqueID();
 	}
 
 	// if (auto resolvedTextureVulkan = static_cast<TextureVulkan*>(GetResolvedDepthTexture()))
@@ -113,15 +119,28 @@ bool RenderPassVulkan::Initialize(const TextureVulkan** textures,
 
 	ResetRenderPassPipelineState();
 
-	vk::FramebufferCreateInfo framebufferCreateInfo;
-	framebufferCreateInfo.renderPass = renderPassPipelineState->GetRenderPass();
-	framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(views.size());
-	framebufferCreateInfo.pAttachments = views.data();
-	framebufferCreateInfo.width = screenSize_.X;
-	framebufferCreateInfo.height = screenSize_.Y;
-	framebufferCreateInfo.layers = 1;
+	// load and store operations don't affect compatibility, so render passes which differ only in them share a framebuffer
+	auto compatibleKey = GetKey();
+	for (size_t i = 0; i < compatibleKey.ColorLoadOps.size(); i++)
+	{
+		compatibleKey.ColorLoadOps.at(i) = AttachmentLoadOp::Load;
+		compatibleKey.ColorStoreOps.at(i) = AttachmentStoreOp::Store;
+	}
+	compatibleKey.DepthLoadOp = AttachmentLoadOp::Load;
+	compatibleKey.DepthStoreOp = AttachmentStoreOp::Store;
+
+	auto compatibleState = renderPassPipelineStateCache_->Create(compatibleKey);
+	if (compatibleState == nullptr)
+	{
+		return false;
+	}
+
+	// the state is kept by the cache, so the render pass is still valid after it is released
+	framebufferKey_.RenderPass = compatibleState->GetRenderPass();
+	framebufferKey_.Size = screenSize_;
+	SafeRelease(compatibleState);
 
-	frameBuffer_ = device_.createFramebuffer(framebufferCreateInfo);
+	frameBuffer_ = renderPassPipelineStateCache_->GetFramebufferCache()->Acquire(framebufferKey_, views);
 
 	isValid_ = true;
 
@@ -133,27 +152,65 @@ Vec2I RenderPassVulkan::GetImageSize() const { return screenSize_; }
 void RenderPassVulkan::SetIsColorCleared(bool isColorCleared)
 {
 	RenderPass::SetIsColorCleared(isColorCleared);
-	ResetRenderPassPipelineState();
+	isPipelineStateDirty_ = true;
 }
 
 void RenderPassVulkan::SetIsDepthCleared(bool isDepthCleared)
 {
 	RenderPass::SetIsDepthCleared(isDepthCleared);
-	ResetRenderPassPipelineState();
+	isPipelineStateDirty_ = true;
 }
 
-void RenderPassVulkan::ResetRenderPassPipelineState()
+void RenderPassVulkan::SetColorLoadOp(int32_t index, AttachmentLoadOp loadOp)
 {
-	SafeRelease(renderPassPipelineState);
+	RenderPass::SetColorLoadOp(index, loadOp);
+	isPipelineStateDirty_ = true;
+}
 
-	FixedSizeVector<vk::Format, RenderTargetMax> formats;
-	formats.resize(renderTargetProperties.size());
-	for (size_t i = 0; i < renderTargetProperties.size(); i++)
+void RenderPassVulkan::SetColorStoreOp(int32_t index, AttachmentStoreOp storeOp)
+{
+	RenderPass::SetColorStoreOp(index, storeOp);
+	isPipelineStateDirty_ = true;
+}
+
+void RenderPassVulkan::SetDepthLoadOp(AttachmentLoadOp loadOp)
+{
+	RenderPass::SetDepthLoadOp(loadOp);
+	isPipelineStateDirty_ = true;
+}
+
+void RenderPassVulkan::SetDepthStoreOp(AttachmentStoreOp storeOp)
+{
+	RenderPass::SetDepthStoreOp(storeOp);
+	isPipelineStateDirty_ = true;
+}
+
+RenderPassPipelineStateVulkan* RenderPassVulkan::GetRenderPassPipelineState()
+{
+	if (isPipelineStateDirty_)
 	{
-		formats.at(i) = renderTargetProperties.at(i).colorBufferPtr->GetVulkanFormat();
+		std::lock_guard<std::mutex> lock(pipelineStateMutex_);
+
+		// another thread may look it up while waiting
+		if (isPipelineStateDirty_)
+		{
+			// flags are set every frame with the same values in most cases
+			if (renderPassPipelineState_ == nullptr || renderPassPipelineState_->GetKeyID() != GetKeyID())
+			{
+				ResetRenderPassPipelineState();
+			}
+
+			isPipelineStateDirty_ = false;
+		}
 	}
 
-	this->renderPassPipelineState = renderPassPipelineStateCache_->Create(GetKey());
+	return renderPassPipelineState_;
+}
+
+void RenderPassVulkan::ResetRenderPassPipelineState()
+{
+	SafeRelease(renderPassPipelineState_);
+	renderPassPipelineState_ = renderPassPipelineStateCache_->Create(GetKey());
 }
 
 RenderPassPipelineStateVulkan::RenderPassPipelineStateVulkan(vk::Device device, ReferenceObject* owner)
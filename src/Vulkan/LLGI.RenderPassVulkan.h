@@ -3,7 +3,10 @@
 #include "../LLGI.Graphics.h"
 #include "../Utils/LLGI.FixedSizeVector.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.FramebufferCacheVulkan.h"
+#include <atomic>
 #include <functional>
+#include <mutex>
 #include <unordered_map>
 
 namespace LLGI
@@ -24,6 +27,16 @@ private:
 	std::shared_ptr<TextureVulkan> depthBufferPtr;
 	bool isValid_ = false;
 
+	RenderPassPipelineStateVulkan* renderPassPipelineState_ = nullptr;
+
+	//! whether load or store operations are changed after renderPassPipelineState_ is created
+	std::atomic<bool> isPipelineStateDirty_{false};
+
+	//! sub command lists may look up renderPassPipelineState_ on worker threads
+	std::mutex pipelineStateMutex_;
+
+	FramebufferKeyVulkan framebufferKey_;
+
 public:
 	struct RenderTargetProperty
 	{
@@ -32,8 +45,7 @@ public:
 		std::shared_ptr<TextureVulkan> colorBufferPtr;
 	};
 
-	RenderPassPipelineStateVulkan* renderPassPipelineState = nullptr;
-
+	//! a framebuffer which is shared with other render passes with the same attachments
 	vk::Framebuffer frameBuffer_;
 
 	FixedSizeVector<RenderTargetProperty, RenderTargetMax> renderTargetProperties;
@@ -55,8 +67,24 @@ public:
 
 	virtual void SetIsDepthCleared(bool isDepthCleared) override;
 
+	virtual void SetColorLoadOp(int32_t index, AttachmentLoadOp loadOp) override;
+
+	virtual void SetColorStoreOp(int32_t index, AttachmentStoreOp storeOp) override;
+
+	virtual void SetDepthLoadOp(AttachmentLoadOp loadOp) override;
+
+	virtual void SetDepthStoreOp(AttachmentStoreOp storeOp) override;
+
 	bool GetIsValid() const { return isValid_; }
 
+	/**
+		@brief	get a render pass which matches current load and store operations
+		@note
+		Changing operations only marks it, and it is looked up when it is required.
+		It can be called from multiple threads unless operations are changed at the same time.
+	*/
+	RenderPassPipelineStateVulkan* GetRenderPassPipelineState();
+
 private:
 	void ResetRenderPassPipelineState();
 };
@@ -74,6 +102,7 @@ public:
 
 	vk::RenderPass renderPass_ = nullptr;
 	int32_t RenderTargetCount = 0;
+	FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1> initialLayouts_;
 	FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1> finalLayouts_;
 
 	vk::RenderPass GetRenderPass() const;
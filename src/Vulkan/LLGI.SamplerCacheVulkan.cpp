@@ -0,0 +1,125 @@
+#include "LLGI.SamplerCacheVulkan.h"
+#include <algorithm>
+
+namespace LLGI
+{
+
+static vk::SamplerAddressMode GetAddressMode(TextureWrapMode wrapMode)
+{
+	switch (wrapMode)
+	{
+	case TextureWrapMode::Repeat:
+		return vk::SamplerAddressMode::eRepeat;
+	case TextureWrapMode::Mirror:
+		return vk::SamplerAddressMode::eMirroredRepeat;
+	case TextureWrapMode::Border:
+		return vk::SamplerAddressMode::eClampToBorder;
+	default:
+		return vk::SamplerAddressMode::eClampToEdge;
+	}
+}
+
+static vk::Filter GetFilter(TextureMinMagFilter filter)
+{
+	return filter == TextureMinMagFilter::Linear ? vk::Filter::eLinear : vk::Filter::eNearest;
+}
+
+static vk::BorderColor GetBorderColor(TextureBorderColor color)
+{
+	switch (color)
+	{
+	case TextureBorderColor::OpaqueBlack:
+		return vk::BorderColor::eFloatOpaqueBlack;
+	case TextureBorderColor::OpaqueWhite:
+		return vk::BorderColor::eFloatOpaqueWhite;
+	default:
+		return vk::BorderColor::eFloatTransparentBlack;
+	}
+}
+
+static vk::CompareOp GetCompareOp(CompareFuncType func)
+{
+	switch (func)
+	{
+	case CompareFuncType::Never:
+		return vk::CompareOp::eNever;
+	case CompareFuncType::Less:
+		return vk::CompareOp::eLess;
+	case CompareFuncType::Equal:
+		return vk::CompareOp::eEqual;
+	case CompareFuncType::LessEqual:
+		return vk::CompareOp::eLessOrEqual;
+	case CompareFuncType::Greater:
+		return vk::CompareOp::eGreater;
+	case CompareFuncType::NotEqual:
+		return vk::CompareOp::eNotEqual;
+	case CompareFuncType::GreaterEqual:
+		return vk::CompareOp::eGreaterOrEqual;
+	default:
+		return vk::CompareOp::eAlways;
+	}
+}
+
+SamplerCacheVulkan::SamplerCacheVulkan(vk::Device device, vk::PhysicalDevice physicalDevice) : device_(device)
+{
+	// PlatformVulkan enables all features which are supported
+	isAnisotropySupported_ = physicalDevice.getFeatures().samplerAnisotropy == VK_TRUE;
+	maxAnisotropy_ = physicalDevice.getProperties().limits.maxSamplerAnisotropy;
+}
+
+SamplerCacheVulkan::~SamplerCacheVulkan()
+{
+	for (auto& it : samplers_)
+	{
+		device_.destroySampler(it.second);
+	}
+	samplers_.clear();
+}
+
+vk::Sampler SamplerCacheVulkan::Get(const SamplerParameter& parameter)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = samplers_.find(parameter);
+	if (it != samplers_.end())
+	{
+		return it->second;
+	}
+
+	vk::SamplerCreateInfo samplerInfo;
+	samplerInfo.magFilter = GetFilter(parameter.MagFilter);
+	samplerInfo.minFilter = GetFilter(parameter.MinFilter);
+	samplerInfo.addressModeU = GetAddressMode(parameter.WrapModeU);
+	samplerInfo.addressModeV = GetAddressMode(parameter.WrapModeV);
+	samplerInfo.addressModeW = GetAddressMode(parameter.WrapModeW);
+	samplerInfo.borderColor = GetBorderColor(parameter.BorderColor);
+	samplerInfo.unnormalizedCoordinates = false;
+	samplerInfo.compareEnable = parameter.IsCompareEnabled;
+	samplerInfo.compareOp = parameter.IsCompareEnabled ? GetCompareOp(parameter.CompareFunc) : vk::CompareOp::eAlways;
+	samplerInfo.mipmapMode =
+		parameter.MipFilter == TextureMipFilter::Linear ? vk::SamplerMipmapMode::eLinear : vk::SamplerMipmapMode::eNearest;
+	samplerInfo.mipLodBias = parameter.MipLodBias;
+	samplerInfo.minLod = parameter.MinLod;
+
+	// Vulkan doesn't have a mode which is not mipmapped, so lods are clamped with the first level instead
+	samplerInfo.maxLod = parameter.MipFilter == TextureMipFilter::None ? parameter.MinLod : parameter.MaxLod;
+
+	samplerInfo.anisotropyEnable = isAnisotropySupported_ && parameter.MaxAnisotropy > 1;
+	samplerInfo.maxAnisotropy = 1.0f;
+	if (samplerInfo.anisotropyEnable)
+	{
+		samplerInfo.maxAnisotropy = std::min(static_cast<float>(parameter.MaxAnisotropy), maxAnisotropy_);
+	}
+
+	auto sampler = device_.createSampler(samplerInfo);
+	samplers_[parameter] = sampler;
+	return sampler;
+}
+
+int32_t SamplerCacheVulkan::GetCount()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return static_cast<int32_t>(samplers_.size());
+}
+
+} // namespace LLGI
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../LLGI.Base.h"
+#include "LLGI.BaseVulkan.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace LLGI
+{
+
+/**
+	@brief	samplers which are shared among all command lists of a device
+	@note
+	A sampler is created when its description is used first and kept until the cache is destroyed,
+	so a handle of a sampler can be a part of a key of descriptor sets.
+	It is thread safe.
+*/
+class SamplerCacheVulkan
+{
+private:
+	vk::Device device_;
+	bool isAnisotropySupported_ = false;
+	float maxAnisotropy_ = 1.0f;
+
+	std::mutex mutex_;
+	std::unordered_map<SamplerParameter, vk::Sampler, SamplerParameter::Hash> samplers_;
+
+public:
+	SamplerCacheVulkan(vk::Device device, vk::PhysicalDevice physicalDevice);
+	~SamplerCacheVulkan();
+
+	//! get a sampler of the description, which is created if it is not found
+	vk::Sampler Get(const SamplerParameter& parameter);
+
+	int32_t GetCount();
+};
+
+} // namespace LLGI
@@ -8,31 +8,84 @@ InternalSingleFrameMemoryPoolVulkan::InternalSingleFrameMemoryPoolVulkan() {}
 
 InternalSingleFrameMemoryPoolVulkan ::~InternalSingleFrameMemoryPoolVulkan() {}
 
+bool InternalSingleFrameMemoryPoolVulkan::AddPage(int32_t size)
+{
+	auto buffer = static_cast<BufferVulkan*>(graphics_->CreateBuffer(BufferUsageType::Constant | BufferUsageType::MapWrite, size));
+	if (buffer == nullptr)
+	{
+		return false;
+	}
+
+	pages_.insert(pages_.begin() + currentPage_ + (pages_.empty() ? 0 : 1), std::unique_ptr<BufferVulkan>(buffer));
+	return true;
+}
+
 bool InternalSingleFrameMemoryPoolVulkan::Initialize(GraphicsVulkan* graphics, int32_t constantBufferPoolSize, int32_t drawingCount)
 {
+	graphics_ = graphics;
 	constantBufferSize_ = (constantBufferPoolSize + 255) & ~255; // buffer size should be multiple of 256
 
-	buffer_ = std::unique_ptr<BufferVulkan>(
-		static_cast<BufferVulkan*>(graphics->CreateBuffer(BufferUsageType::Constant | BufferUsageType::MapWrite, constantBufferSize_)));
-
-	return true;
+	return AddPage(constantBufferSize_);
 }
 
-void InternalSingleFrameMemoryPoolVulkan::Dispose() { buffer_ = nullptr; }
+void InternalSingleFrameMemoryPoolVulkan::Dispose() { pages_.clear(); }
 
 bool InternalSingleFrameMemoryPoolVulkan::GetConstantBuffer(int32_t size, BufferVulkan*& buffer, int32_t& outOffset)
 {
-	if (constantBufferOffset_ + size > constantBufferSize_)
+	if (pages_.empty())
 		return false;
 
-	buffer = buffer_.get();
-	outOffset = constantBufferOffset_;
-	constantBufferOffset_ += size;
+	if (pageOffset_ + size > pages_[currentPage_]->GetSize())
+	{
+		// chain a next page
+		const auto nextPage = currentPage_ + 1;
+		if (nextPage >= static_cast<int32_t>(pages_.size()) || pages_[nextPage]->GetSize() < size)
+		{
+			if (!AddPage(std::max(constantBufferSize_, size)))
+			{
+				return false;
+			}
+		}
+
+		usedSizeInPreviousPages_ += pageOffset_;
+		currentPage_ = nextPage;
+		pageOffset_ = 0;
+	}
+
+	buffer = pages_[currentPage_].get();
+	outOffset = pageOffset_;
+	pageOffset_ += size;
 
 	return true;
 }
 
-void InternalSingleFrameMemoryPoolVulkan::Reset() { constantBufferOffset_ = 0; }
+void InternalSingleFrameMemoryPoolVulkan::Reset()
+{
+	highWaterMark_.Push(GetUsedSize());
+
+	// release extra pages which are not needed for the high-water mark
+	const auto requiredPageCount = std::max<size_t>(1, HighWaterMark::GetRequiredPageCount(pages_, GetHighWaterMark()));
+	if (pages_.size() > requiredPageCount)
+	{
+		pages_.resize(requiredPageCount);
+	}
+
+	currentPage_ = 0;
+	pageOffset_ = 0;
+	usedSizeInPreviousPages_ = 0;
+}
+
+int32_t InternalSingleFrameMemoryPoolVulkan::GetCapacitySize() const
+{
+	int32_t capacity = 0;
+	for (const auto& page : pages_)
+	{
+		capacity += page->GetSize();
+	}
+	return capacity;
+}
+
+int32_t InternalSingleFrameMemoryPoolVulkan::GetHighWaterMark() const { return highWaterMark_.Get(GetUsedSize()); }
 
 Buffer* SingleFrameMemoryPoolVulkan::CreateBufferInternal(int32_t size)
 {
@@ -59,7 +112,11 @@ Buffer* SingleFrameMemoryPoolVulkan::ReinitializeBuffer(Buffer* cb, int32_t size
 
 SingleFrameMemoryPoolVulkan::SingleFrameMemoryPoolVulkan(
 	GraphicsVulkan* graphics, bool isStrongRef, int32_t swapBufferCount, int32_t constantBufferPoolSize, int32_t drawingCount)
-	: SingleFrameMemoryPool(swapBufferCount), graphics_(graphics), isStrongRef_(isStrongRef), currentSwap_(-1), drawingCount_(drawingCount)
+	: SingleFrameMemoryPool(swapBufferCount, graphics)
+	, graphics_(graphics)
+	, isStrongRef_(isStrongRef)
+	, currentSwap_(-1)
+	, drawingCount_(drawingCount)
 {
 	if (isStrongRef)
 	{
@@ -109,4 +166,20 @@ void SingleFrameMemoryPoolVulkan::NewFrame()
 	SingleFrameMemoryPool::NewFrame();
 }
 
+SingleFrameMemoryPoolStats SingleFrameMemoryPoolVulkan::GetStats() const
+{
+	auto stats = SingleFrameMemoryPool::GetStats();
+	if (currentSwap_ < 0)
+	{
+		return stats;
+	}
+
+	const auto& pool = memoryPools[currentSwap_];
+	stats.UsedSize = pool->GetUsedSize();
+	stats.CapacitySize = pool->GetCapacitySize();
+	stats.PageCount = pool->GetPageCount();
+	stats.HighWaterMark = pool->GetHighWaterMark();
+	return stats;
+}
+
 } // namespace LLGI
@@ -4,17 +4,33 @@
 #include "LLGI.BaseVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
 #include "LLGI.BufferVulkan.h"
+#include "../Utils/LLGI.HighWaterMark.h"
 
 namespace LLGI
 {
 class GraphicsVulkan;
 
+/**
+	@brief	a memory pool for a frame
+	@note
+	Pages are chained when the first page is full.
+	Extra pages are released when they are not used in recent frames.
+*/
 class InternalSingleFrameMemoryPoolVulkan
 {
 private:
+	GraphicsVulkan* graphics_ = nullptr;
 	int32_t constantBufferSize_ = 0;
-	int32_t constantBufferOffset_ = 0;
-	std::unique_ptr<BufferVulkan> buffer_ = nullptr;
+	std::vector<std::unique_ptr<BufferVulkan>> pages_;
+	int32_t currentPage_ = 0;
+	int32_t pageOffset_ = 0;
+
+	//! the size used in pages before the current page
+	int32_t usedSizeInPreviousPages_ = 0;
+
+	HighWaterMark highWaterMark_;
+
+	bool AddPage(int32_t size);
 
 public:
 	InternalSingleFrameMemoryPoolVulkan();
@@ -23,6 +39,11 @@ public:
 	void Dispose();
 	bool GetConstantBuffer(int32_t size, BufferVulkan*& buffer, int32_t& outOffset);
 	void Reset();
+
+	int32_t GetUsedSize() const { return usedSizeInPreviousPages_ + pageOffset_; }
+	int32_t GetCapacitySize() const;
+	int32_t GetPageCount() const { return static_cast<int32_t>(pages_.size()); }
+	int32_t GetHighWaterMark() const;
 };
 
 class SingleFrameMemoryPoolVulkan : public SingleFrameMemoryPool
@@ -51,6 +72,8 @@ public:
 	int32_t GetDrawingCount() const;
 
 	void NewFrame() override;
+
+	SingleFrameMemoryPoolStats GetStats() const override;
 };
 
 } // namespace LLGI
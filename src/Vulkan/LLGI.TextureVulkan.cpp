@@ -1,5 +1,6 @@
 
 #include "LLGI.TextureVulkan.h"
+#include <atomic>
 
 namespace LLGI
 {
@@ -14,10 +15,50 @@ void TextureVulkan::ResetImageLayouts(int32_t count, vk::ImageLayout layout)
 	}
 }
 
-TextureVulkan::TextureVulkan() {}
+TextureVulkan::TextureVulkan()
+{
+	static std::atomic<uint64_t> nextUniqueID(1);
+	uniqueID_ = nextUniqueID++;
+}
 
 TextureVulkan::~TextureVulkan()
 {
+	if (graphics_ != nullptr)
+	{
+		if (uploadTicket_ != 0)
+		{
+			graphics_->GetUploadManager()->Wait(uploadTicket_);
+		}
+
+		graphics_->GetUploadManager()->FreeStagingBuffer(lockedStagingBuffer_);
+	}
+
+	// previous frames may still use the image because Present doesn't wait for gpu
+	if (graphics_ != nullptr && type_ != TextureType::Screen && !isExternalResource_)
+	{
+		auto device = device_;
+		auto view = view_;
+		auto image = image_;
+		auto allocation = allocation_;
+		auto allocator = graphics_->GetMemoryAllocator();
+
+		graphics_->GetDeferredDestroyQueue()->Push([device, view, image, allocation, allocator]() mutable -> void {
+			if (view)
+			{
+				device.destroyImageView(view);
+			}
+
+			if (image)
+			{
+				device.destroyImage(image);
+				allocator->Free(allocation);
+			}
+		});
+
+		view_ = nullptr;
+		image_ = nullptr;
+	}
+
 	if (view_ && type_ != TextureType::Screen)
 	{
 		device_.destroyImageView(view_);
@@ -29,7 +70,7 @@ TextureVulkan::~TextureVulkan()
 		if (type_ != TextureType::Screen && !isExternalResource_)
 		{
 			device_.destroyImage(image_);
-			device_.freeMemory(devMem_);
+			device_.freeMemory(allocation_.Memory);
 			image_ = nullptr;
 		}
 	}
@@ -72,6 +113,20 @@ bool TextureVulkan::Initialize(GraphicsVulkan* graphics,
 
 	vk::ImageUsageFlags resourceUsage = {};
 
+	// contents of a transient attachment are never stored to memory
+	const auto isTransient = BitwiseContains(parameter.Usage, TextureUsageType::Transient);
+	if (isTransient && !IsDepthFormat(parameter.Format) && !BitwiseContains(parameter.Usage, TextureUsageType::RenderTarget))
+	{
+		Log(LogType::Error, "A transient texture must be a render target or a depth texture.");
+		return false;
+	}
+
+	if (isTransient && BitwiseContains(parameter.Usage, TextureUsageType::Storage))
+	{
+		Log(LogType::Error, "A transient texture cannot be used as a storage.");
+		return false;
+	}
+
 	vk::ImageAspectFlags aspect = {};
 
 	if (IsDepthFormat(parameter.Format))
@@ -97,8 +152,17 @@ bool TextureVulkan::Initialize(GraphicsVulkan* graphics,
 	{
 		aspect = vk::ImageAspectFlagBits::eColor;
 
-		resourceUsage =
-			resourceUsage | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled;
+		// an image with eTransientAttachment can be used only as attachments
+		if (!isTransient)
+		{
+			resourceUsage = resourceUsage | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc |
+							vk::ImageUsageFlagBits::eSampled;
+		}
+	}
+
+	if (isTransient)
+	{
+		resourceUsage = resourceUsage | vk::ImageUsageFlagBits::eTransientAttachment;
 	}
 
 	if ((parameter.Usage & TextureUsageType::RenderTarget) != TextureUsageType::NoneFlag)
@@ -147,33 +211,40 @@ bool TextureVulkan::Initialize(GraphicsVulkan* graphics,
 	// calculate size
 	memorySize = GetTextureMemorySize(format_, parameter.Size);
 
-	// create a buffer on cpu
-	if (!IsDepthFormat(parameter.Format))
-	{
-		cpuBuf = std::unique_ptr<InternalBuffer>(new InternalBuffer(graphics_));
-		vk::BufferCreateInfo bufferInfo;
-		bufferInfo.size = memorySize;
-		bufferInfo.usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst;
-		vk::Buffer buffer = device.createBuffer(bufferInfo);
-
-		vk::MemoryRequirements memReqs = device.getBufferMemoryRequirements(buffer);
-		vk::MemoryAllocateInfo memAlloc;
-		memAlloc.allocationSize = memReqs.size;
-		memAlloc.memoryTypeIndex = GetMemoryTypeIndex(physicalDevice, memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible);
-		vk::DeviceMemory devMem = device.allocateMemory(memAlloc);
-		device.bindBufferMemory(buffer, devMem, 0);
-
-		cpuBuf->Attach(buffer, devMem);
-	}
-
 	// create a buffer on gpu
 	{
 		vk::MemoryRequirements memReqs = device.getImageMemoryRequirements(image_);
-		vk::MemoryAllocateInfo memAlloc;
-		memAlloc.allocationSize = memReqs.size;
-		memAlloc.memoryTypeIndex = GetMemoryTypeIndex(physicalDevice, memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-		devMem_ = device.allocateMemory(memAlloc);
-		device.bindImageMemory(image_, devMem_, 0);
+
+		if (graphics_ != nullptr)
+		{
+			auto allocator = graphics_->GetMemoryAllocator();
+
+			// tile based gpus don't commit memory for a transient attachment which is not stored
+			vk::MemoryPropertyFlags properties = vk::MemoryPropertyFlagBits::eDeviceLocal;
+			if (isTransient &&
+				allocator->HasMemoryType(memReqs.memoryTypeBits,
+										 vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated))
+			{
+				properties = vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated;
+			}
+
+			if (!allocator->Allocate(memReqs, properties, false, allocation_))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			// textures created by a platform have their own memory because they are few
+			vk::MemoryAllocateInfo memAlloc;
+			memAlloc.allocationSize = memReqs.size;
+			memAlloc.memoryTypeIndex =
+				GetMemoryTypeIndex(physicalDevice, memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+			allocation_.Memory = device.allocateMemory(memAlloc);
+			allocation_.Size = memReqs.size;
+		}
+
+		device.bindImageMemory(image_, allocation_.Memory, allocation_.Offset);
 	}
 
 	// create a texture view
@@ -214,30 +285,12 @@ bool TextureVulkan::Initialize(GraphicsVulkan* graphics,
 
 	if (!IsDepthFormat(parameter.Format) && graphics_ != nullptr)
 	{
-		vk::CommandBufferAllocateInfo cmdBufInfo;
-		cmdBufInfo.commandPool = graphics_->GetCommandPool();
-		cmdBufInfo.level = vk::CommandBufferLevel::ePrimary;
-		cmdBufInfo.commandBufferCount = 1;
-		auto cmdBuffers = graphics_->GetDevice().allocateCommandBuffersUnique(cmdBufInfo);
-
 		// a texture state must starts from undefined, so the states must be changed with a command buffer
-		vk::CommandBufferBeginInfo cmdBufferBeginInfo;
-		cmdBuffers[0]->begin(cmdBufferBeginInfo);
-		ResourceBarrier(cmdBuffers[0].get(), vk::ImageLayout::eShaderReadOnlyOptimal);
-		cmdBuffers[0]->end();
-		std::array<vk::SubmitInfo, 1> submitInfos;
-		submitInfos[0].commandBufferCount = 1;
-		submitInfos[0].pCommandBuffers = &(cmdBuffers[0].get());
-
-		const auto submitResult = graphics_->GetQueue().submit(static_cast<uint32_t>(submitInfos.size()), submitInfos.data(), vk::Fence());
-
-		if (submitResult != vk::Result::eSuccess)
-		{
-			LLGI::Log(LogType::Error, "Failed to submit");
-			return false;
-		}
-
-		graphics_->GetQueue().waitIdle();
+		// transitions of many textures are batched and submitted before a command list which uses them
+		uploadTicket_ = graphics_->GetUploadManager()->Record(
+			[this, isTransient](vk::CommandBuffer& commandBuffer) -> void {
+				ResourceBarrier(commandBuffer, isTransient ? vk::ImageLayout::eColorAttachmentOptimal : vk::ImageLayout::eShaderReadOnlyOptimal);
+			});
 	}
 
 	return true;
@@ -304,83 +357,53 @@ bool TextureVulkan::InitializeAsExternal(vk::Device device, const VulkanImageInf
 
 void* TextureVulkan::Lock()
 {
-	if (graphics_ == nullptr)
+	if (graphics_ == nullptr || IsDepthFormat(format_))
 		return nullptr;
 
-	data_ = graphics_->GetDevice().mapMemory(cpuBuf->devMem(), 0, memorySize, vk::MemoryMapFlags());
-	return data_;
-}
+	auto uploadManager = graphics_->GetUploadManager();
+	uploadManager->FreeStagingBuffer(lockedStagingBuffer_);
 
-void TextureVulkan::Unlock()
-{
-	if (graphics_ == nullptr)
+	if (!uploadManager->AllocateStagingBuffer(memorySize, lockedStagingBuffer_))
 	{
-		return;
+		Log(LogType::Error, "Failed to allocate a staging buffer.");
+		return nullptr;
 	}
 
-	graphics_->GetDevice().unmapMemory(cpuBuf->devMem());
-
-	// copy buffer
-	vk::CommandBufferAllocateInfo cmdBufInfo;
-	cmdBufInfo.commandPool = graphics_->GetCommandPool();
-	cmdBufInfo.level = vk::CommandBufferLevel::ePrimary;
-	cmdBufInfo.commandBufferCount = 1;
-	vk::CommandBuffer copyCommandBuffer = graphics_->GetDevice().allocateCommandBuffers(cmdBufInfo)[0];
-
-	vk::CommandBufferBeginInfo cmdBufferBeginInfo;
-
-	copyCommandBuffer.begin(cmdBufferBeginInfo);
-
-	auto isArray = (parameter_.Usage & TextureUsageType::Array) != TextureUsageType::NoneFlag;
-
-	vk::BufferImageCopy imageRegion;
-
-	imageRegion.bufferOffset = 0;
-	imageRegion.bufferRowLength = 0;
-	imageRegion.bufferImageHeight = 0;
-
-	imageRegion.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-	imageRegion.imageSubresource.mipLevel = 0;
-	imageRegion.imageSubresource.baseArrayLayer = 0;
-	imageRegion.imageSubresource.layerCount = isArray ? parameter_.Size.Z : 1;
-
-	imageRegion.imageOffset = vk::Offset3D(0, 0, 0);
-	imageRegion.imageExtent =
-		vk::Extent3D(static_cast<uint32_t>(GetSizeAs2D().X), static_cast<uint32_t>(GetSizeAs2D().Y), isArray ? 1 : parameter_.Size.Z);
-
-	vk::ImageSubresourceRange colorSubRange;
-	colorSubRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-	colorSubRange.levelCount = 1;
-	colorSubRange.layerCount = isArray ? parameter_.Size.Z : 1;
-
-	vk::ImageLayout imageLayout = vk::ImageLayout::eTransferDstOptimal;
-	ResourceBarrier(copyCommandBuffer, imageLayout);
-	copyCommandBuffer.copyBufferToImage(cpuBuf->buffer(), image_, imageLayout, imageRegion);
-	ResourceBarrier(copyCommandBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
-	copyCommandBuffer.end();
-
-	// submit and wait to execute command
-	std::array<vk::SubmitInfo, 1> copySubmitInfos;
-	copySubmitInfos[0].commandBufferCount = 1;
-	copySubmitInfos[0].pCommandBuffers = &copyCommandBuffer;
+	return lockedStagingBuffer_.Pointer;
+}
 
-	const auto submitResult =
-		graphics_->GetQueue().submit(static_cast<uint32_t>(copySubmitInfos.size()), copySubmitInfos.data(), vk::Fence());
-	if (submitResult != vk::Result::eSuccess)
+void TextureVulkan::Unlock()
+{
+	if (graphics_ == nullptr || !lockedStagingBuffer_.Buffer)
 	{
-		LLGI::Log(LogType::Error, "Failed to submit");
 		return;
 	}
 
-	graphics_->GetQueue().waitIdle();
-
-	graphics_->GetDevice().freeCommandBuffers(graphics_->GetCommandPool(), copyCommandBuffer);
+	auto isArray = (parameter_.Usage & TextureUsageType::Array) != TextureUsageType::NoneFlag;
+	const auto layerCount = isArray ? parameter_.Size.Z : 1;
+	const auto size = Vec3I(GetSizeAs2D().X, GetSizeAs2D().Y, isArray ? 1 : parameter_.Size.Z);
+
+	// a copy is submitted with other uploads instead of waiting for it here
+	// and the staging buffer is returned to the pool after the copy is completed
+	uploadTicket_ = graphics_->GetUploadManager()->Record(
+		lockedStagingBuffer_, [&](vk::CommandBuffer& commandBuffer, const StagingBufferVulkan& staging) -> void {
+			CopyFromBuffer(commandBuffer, staging.Buffer, staging.Offset, Vec3I(0, 0, 0), size, 0, layerCount);
+		});
 }
 
 bool TextureVulkan::GetData(std::vector<uint8_t>& data)
 {
-	if (graphics_ == nullptr)
+	if (graphics_ == nullptr || IsDepthFormat(format_))
+	{
+		return false;
+	}
+
+	// staging memory is borrowed only while reading
+	auto uploadManager = graphics_->GetUploadManager();
+	StagingBufferVulkan stagingBuffer;
+	if (!uploadManager->AllocateStagingBuffer(memorySize, stagingBuffer))
 	{
+		Log(LogType::Error, "Failed to allocate a staging buffer.");
 		return false;
 	}
 
@@ -399,7 +422,7 @@ bool TextureVulkan::GetData(std::vector<uint8_t>& data)
 
 	vk::BufferImageCopy imageRegion;
 
-	imageRegion.bufferOffset = 0;
+	imageRegion.bufferOffset = stagingBuffer.Offset;
 	imageRegion.bufferRowLength = 0;
 	imageRegion.bufferImageHeight = 0;
 
@@ -419,36 +442,34 @@ bool TextureVulkan::GetData(std::vector<uint8_t>& data)
 
 	vk::ImageLayout imageLayout = vk::ImageLayout::eTransferSrcOptimal;
 	ResourceBarrier(copyCommandBuffer, imageLayout);
-	copyCommandBuffer.copyImageToBuffer(image_, imageLayout, cpuBuf->buffer(), imageRegion);
+	copyCommandBuffer.copyImageToBuffer(image_, imageLayout, stagingBuffer.Buffer, imageRegion);
 	ResourceBarrier(copyCommandBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
 	copyCommandBuffer.end();
 
+	// uploads into the texture are executed before reading it
+	uploadManager->Submit();
+
 	// submit and wait to execute command
-	std::array<vk::SubmitInfo, 1> copySubmitInfos;
-	copySubmitInfos[0].commandBufferCount = 1;
-	copySubmitInfos[0].pCommandBuffers = &copyCommandBuffer;
+	vk::SubmitInfo copySubmitInfo;
+	copySubmitInfo.commandBufferCount = 1;
+	copySubmitInfo.pCommandBuffers = &copyCommandBuffer;
 
-	const auto submitResult =
-		graphics_->GetQueue().submit(static_cast<uint32_t>(copySubmitInfos.size()), copySubmitInfos.data(), vk::Fence());
-	if (submitResult != vk::Result::eSuccess)
+	const auto submittedValue = graphics_->GetTimeline()->Submit(graphics_->GetQueue(), copySubmitInfo);
+	if (submittedValue == 0)
 	{
-		LLGI::Log(LogType::Error, "Failed to submit");
+		graphics_->GetDevice().freeCommandBuffers(graphics_->GetCommandPool(), copyCommandBuffer);
+		uploadManager->FreeStagingBuffer(stagingBuffer);
 		return false;
 	}
 
-	graphics_->GetQueue().waitIdle();
+	graphics_->GetTimeline()->Wait(submittedValue);
 
 	graphics_->GetDevice().freeCommandBuffers(graphics_->GetCommandPool(), copyCommandBuffer);
 
-	auto datatemp = graphics_->GetDevice().mapMemory(cpuBuf->devMem(), 0, memorySize, vk::MemoryMapFlags());
+	data.resize(memorySize);
+	memcpy(data.data(), stagingBuffer.Pointer, memorySize);
 
-	if (datatemp != nullptr)
-	{
-		data.resize(memorySize);
-		memcpy(data.data(), datatemp, memorySize);
-	}
-
-	graphics_->GetDevice().unmapMemory(cpuBuf->devMem());
+	uploadManager->FreeStagingBuffer(stagingBuffer);
 
 	return true;
 }
@@ -468,25 +489,68 @@ void TextureVulkan::ChangeImageLayout(const vk::ImageLayout& imageLayout)
 void TextureVulkan::ChangeImageLayout(int32_t mipLevel, const vk::ImageLayout& imageLayout) { imageLayouts_[mipLevel] = imageLayout; }
 
 void TextureVulkan::ResourceBarrier(vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout)
+{
+	BarrierBatcherVulkan batcher;
+	ResourceBarrier(batcher, imageLayout);
+	batcher.Flush(commandBuffer);
+}
+
+void TextureVulkan::ResourceBarrier(int32_t mipLevel, vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout)
+{
+	BarrierBatcherVulkan batcher;
+	ResourceBarrier(mipLevel, batcher, imageLayout);
+	batcher.Flush(commandBuffer);
+}
+
+void TextureVulkan::ResourceBarrier(BarrierBatcherVulkan& batcher, const vk::ImageLayout& imageLayout)
 {
 	for (int32_t i = 0; i < mipmapCount_; i++)
 	{
-		ResourceBarrier(i, commandBuffer, imageLayout);
+		ResourceBarrier(i, batcher, imageLayout);
 	}
 }
 
-void TextureVulkan::ResourceBarrier(int32_t mipLevel, vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout)
+void TextureVulkan::ResourceBarrier(int32_t mipLevel, BarrierBatcherVulkan& batcher, const vk::ImageLayout& imageLayout)
 {
 	if (imageLayouts_[mipLevel] == imageLayout)
 	{
 		return;
 	}
 
-	auto subresourceRange = subresourceRange_;
-	subresourceRange.baseMipLevel = mipLevel;
-	subresourceRange.levelCount = 1;
-	SetImageLayout(commandBuffer, image_, imageLayouts_[mipLevel], imageLayout, subresourceRange);
+	batcher.AddImageBarrier(image_,
+							subresourceRange_.aspectMask,
+							mipLevel,
+							subresourceRange_.baseArrayLayer,
+							subresourceRange_.layerCount,
+							imageLayouts_[mipLevel],
+							imageLayout);
 	ChangeImageLayout(mipLevel, imageLayout);
 }
 
+void TextureVulkan::CopyFromBuffer(vk::CommandBuffer& commandBuffer,
+								   vk::Buffer buffer,
+								   vk::DeviceSize bufferOffset,
+								   const Vec3I& position,
+								   const Vec3I& size,
+								   int32_t layer,
+								   int32_t layerCount)
+{
+	vk::BufferImageCopy imageRegion;
+	imageRegion.bufferOffset = bufferOffset;
+	imageRegion.bufferRowLength = 0;
+	imageRegion.bufferImageHeight = 0;
+
+	imageRegion.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+	imageRegion.imageSubresource.mipLevel = 0;
+	imageRegion.imageSubresource.baseArrayLayer = layer;
+	imageRegion.imageSubresource.layerCount = layerCount;
+
+	imageRegion.imageOffset = vk::Offset3D(position.X, position.Y, position.Z);
+	imageRegion.imageExtent = vk::Extent3D(static_cast<uint32_t>(size.X), static_cast<uint32_t>(size.Y), static_cast<uint32_t>(size.Z));
+
+	ResourceBarrier(0, commandBuffer, vk::ImageLayout::eTransferDstOptimal);
+	commandBuffer.copyBufferToImage(buffer, image_, vk::ImageLayout::eTransferDstOptimal, imageRegion);
+	ResourceBarrier(0, commandBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
+}
+
 } // namespace LLGI
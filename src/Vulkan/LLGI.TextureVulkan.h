@@ -2,6 +2,7 @@
 #pragma once
 
 #include "../LLGI.Texture.h"
+#include "LLGI.BarrierBatcherVulkan.h"
 #include "LLGI.BaseVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
 
@@ -19,7 +20,7 @@ private:
 	vk::Image image_ = nullptr;
 	vk::ImageView view_ = nullptr;
 	std::vector<vk::ImageLayout> imageLayouts_;
-	vk::DeviceMemory devMem_ = nullptr;
+	MemoryAllocationVulkan allocation_;
 	vk::Format vkTextureFormat_;
 	vk::ImageSubresourceRange subresourceRange_;
 
@@ -27,11 +28,18 @@ private:
 	TextureParameter parameter_;
 
 	int32_t memorySize = 0;
-	std::unique_ptr<InternalBuffer> cpuBuf;
-	void* data_ = nullptr;
+
+	//! staging memory is borrowed from UploadManagerVulkan only while the texture is locked
+	StagingBufferVulkan lockedStagingBuffer_;
 
 	bool isExternalResource_ = false;
 
+	//! a ticket of the last upload which must be completed before the image is destroyed
+	uint64_t uploadTicket_ = 0;
+
+	//! an id which is not reused even if the texture is destroyed
+	uint64_t uniqueID_ = 0;
+
 	void ResetImageLayouts(int32_t count, vk::ImageLayout layout);
 
 public:
@@ -51,6 +59,8 @@ public:
 
 	bool InitializeAsExternal(vk::Device device, const VulkanImageInfo& info, ReferenceObject* owner);
 
+	uint64_t GetUniqueID() const { return uniqueID_; }
+
 	void* Lock() override;
 	void Unlock() override;
 
@@ -77,6 +87,28 @@ public:
 	void ResourceBarrier(vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout);
 
 	void ResourceBarrier(int32_t mipLevel, vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout);
+
+	/**
+		@brief	add transitions of all mip levels into a batcher
+		@note
+		A tracked layout is changed when a transition is added, so the batcher must be flushed before the texture is used.
+	*/
+	void ResourceBarrier(BarrierBatcherVulkan& batcher, const vk::ImageLayout& imageLayout);
+
+	void ResourceBarrier(int32_t mipLevel, BarrierBatcherVulkan& batcher, const vk::ImageLayout& imageLayout);
+
+	/**
+		@brief	record a copy from a buffer into mip 0
+		@note
+		A layout is changed into eTransferDstOptimal while copying and into eShaderReadOnlyOptimal after copying.
+	*/
+	void CopyFromBuffer(vk::CommandBuffer& commandBuffer,
+						vk::Buffer buffer,
+						vk::DeviceSize bufferOffset,
+						const Vec3I& position,
+						const Vec3I& size,
+						int32_t layer,
+						int32_t layerCount);
 };
 
 } // namespace LLGI
@@ -0,0 +1,260 @@
+#include "LLGI.TimelineVulkan.h"
+#include <algorithm>
+#include <limits>
+
+namespace LLGI
+{
+
+TimelineVulkan::TimelineVulkan(vk::Device device, bool isTimelineSemaphoreEnabled) : device_(device), completedValue_(0)
+{
+#if defined(VK_KHR_timeline_semaphore)
+	if (isTimelineSemaphoreEnabled)
+	{
+		// functions of the extension are not exported by a loader of Vulkan 1.0
+		getSemaphoreCounterValue_ =
+			reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(device_.getProcAddr("vkGetSemaphoreCounterValueKHR"));
+		waitSemaphores_ = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(device_.getProcAddr("vkWaitSemaphoresKHR"));
+
+		if (getSemaphoreCounterValue_ != nullptr && waitSemaphores_ != nullptr)
+		{
+			vk::SemaphoreTypeCreateInfoKHR typeCreateInfo;
+			typeCreateInfo.semaphoreType = vk::SemaphoreTypeKHR::eTimeline;
+			typeCreateInfo.initialValue = 0;
+
+			vk::SemaphoreCreateInfo createInfo;
+			createInfo.pNext = &typeCreateInfo;
+			semaphore_ = device_.createSemaphore(createInfo);
+		}
+	}
+#endif
+
+	if (!semaphore_)
+	{
+		Log(LogType::Info, "A timeline semaphore is not enabled. Submissions are tracked with fences.");
+	}
+}
+
+TimelineVulkan::~TimelineVulkan()
+{
+	Wait(GetSubmittedValue());
+
+	for (auto& pendingFence : pendingFences_)
+	{
+		device_.destroyFence(pendingFence.Fence);
+	}
+	pendingFences_.clear();
+
+	for (auto& fence : freeFences_)
+	{
+		device_.destroyFence(fence);
+	}
+	freeFences_.clear();
+
+	if (semaphore_)
+	{
+		device_.destroySemaphore(semaphore_);
+		semaphore_ = nullptr;
+	}
+}
+
+void TimelineVulkan::UpdateCompletedValue()
+{
+#if defined(VK_KHR_timeline_semaphore)
+	if (semaphore_)
+	{
+		uint64_t value = 0;
+		if (getSemaphoreCounterValue_(static_cast<VkDevice>(device_), static_cast<VkSemaphore>(semaphore_), &value) == VK_SUCCESS)
+		{
+			completedValue_ = std::max(completedValue_.load(), value);
+		}
+		return;
+	}
+#endif
+
+	while (!pendingFences_.empty() && device_.getFenceStatus(pendingFences_.front().Fence) == vk::Result::eSuccess)
+	{
+		completedValue_ = std::max(completedValue_.load(), pendingFences_.front().Value);
+		freeFences_.emplace_back(pendingFences_.front().Fence);
+		pendingFences_.pop_front();
+	}
+}
+
+bool TimelineVulkan::WaitFences(uint64_t value)
+{
+	vk::Fence fence;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		auto it = std::find_if(
+			pendingFences_.begin(), pendingFences_.end(), [value](const PendingFence& p) -> bool { return p.Value >= value; });
+		if (it == pendingFences_.end())
+		{
+			return true;
+		}
+
+		fence = it->Fence;
+	}
+
+	// the fence is reused only after it is signaled, so it is waited for without locking submissions
+	if (device_.waitForFences(1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max()) != vk::Result::eSuccess)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	UpdateCompletedValue();
+	completedValue_ = std::max(completedValue_.load(), value);
+	return true;
+}
+
+uint64_t TimelineVulkan::Submit(vk::Queue queue, const vk::SubmitInfo& submitInfo)
+{
+	// values must be signaled in the order of submissions
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const auto value = submittedValue_ + 1;
+
+#if defined(VK_KHR_timeline_semaphore)
+	if (semaphore_)
+	{
+		std::vector<vk::Semaphore> signalSemaphores(submitInfo.pSignalSemaphores,
+													submitInfo.pSignalSemaphores + submitInfo.signalSemaphoreCount);
+		signalSemaphores.emplace_back(semaphore_);
+
+		// values for binary semaphores are ignored
+		std::vector<uint64_t> signalValues(submitInfo.signalSemaphoreCount, 0);
+		signalValues.emplace_back(value);
+
+		vk::TimelineSemaphoreSubmitInfoKHR timelineSubmitInfo;
+		timelineSubmitInfo.pNext = submitInfo.pNext;
+		timelineSubmitInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+		timelineSubmitInfo.pSignalSemaphoreValues = signalValues.data();
+
+		auto timelineInfo = submitInfo;
+		timelineInfo.pNext = &timelineSubmitInfo;
+		timelineInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+		timelineInfo.pSignalSemaphores = signalSemaphores.data();
+
+		if (queue.submit(1, &timelineInfo, vk::Fence()) != vk::Result::eSuccess)
+		{
+			Log(LogType::Error, "Failed to submit");
+			return 0;
+		}
+
+		submittedValue_ = value;
+		return value;
+	}
+#endif
+
+	UpdateCompletedValue();
+
+	vk::Fence fence;
+	if (!freeFences_.empty())
+	{
+		fence = freeFences_.back();
+		freeFences_.pop_back();
+
+		if (device_.resetFences(1, &fence) != vk::Result::eSuccess)
+		{
+			Log(LogType::Error, "Failed to resetFences");
+		}
+	}
+	else
+	{
+		fence = device_.createFence(vk::FenceCreateInfo());
+	}
+
+	if (queue.submit(1, &submitInfo, fence) != vk::Result::eSuccess)
+	{
+		Log(LogType::Error, "Failed to submit");
+		freeFences_.emplace_back(fence);
+		return 0;
+	}
+
+	PendingFence pendingFence;
+	pendingFence.Value = value;
+	pendingFence.Fence = fence;
+	pendingFences_.emplace_back(pendingFence);
+
+	submittedValue_ = value;
+	return value;
+}
+
+bool TimelineVulkan::IsCompleted(uint64_t value)
+{
+	if (value <= completedValue_)
+	{
+		return true;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (value > submittedValue_)
+	{
+		return false;
+	}
+
+	UpdateCompletedValue();
+	return value <= completedValue_;
+}
+
+bool TimelineVulkan::Wait(uint64_t value)
+{
+	if (IsCompleted(value))
+	{
+		return true;
+	}
+
+	if (value > GetSubmittedValue())
+	{
+		Log(LogType::Error, "Failed to wait for a value which is not submitted.");
+		return false;
+	}
+
+#if defined(VK_KHR_timeline_semaphore)
+	if (semaphore_)
+	{
+		const auto semaphore = static_cast<VkSemaphore>(semaphore_);
+
+		VkSemaphoreWaitInfoKHR waitInfo = {};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &semaphore;
+		waitInfo.pValues = &value;
+
+		if (waitSemaphores_(static_cast<VkDevice>(device_), &waitInfo, std::numeric_limits<uint64_t>::max()) != VK_SUCCESS)
+		{
+			Log(LogType::Error, "Failed to wait for a timeline semaphore.");
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		completedValue_ = std::max(completedValue_.load(), value);
+		return true;
+	}
+#endif
+
+	if (!WaitFences(value))
+	{
+		Log(LogType::Error, "Failed to wait for a fence.");
+		return false;
+	}
+
+	return true;
+}
+
+uint64_t TimelineVulkan::GetSubmittedValue()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return submittedValue_;
+}
+
+uint64_t TimelineVulkan::GetCompletedValue()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	UpdateCompletedValue();
+	return completedValue_;
+}
+
+} // namespace LLGI
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "LLGI.BaseVulkan.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+namespace LLGI
+{
+
+/**
+	@brief	a timeline of submissions to a queue
+	@note
+	Each submission signals a value which is larger than values of previous submissions,
+	so completion of all submissions is tracked with one value.
+	A timeline semaphore is used if VK_KHR_timeline_semaphore is enabled, otherwise a fence is signaled with each value.
+	It is thread safe.
+*/
+class TimelineVulkan
+{
+private:
+	struct PendingFence
+	{
+		uint64_t Value = 0;
+		vk::Fence Fence;
+	};
+
+	vk::Device device_;
+
+	vk::Semaphore semaphore_;
+#if defined(VK_KHR_timeline_semaphore)
+	PFN_vkGetSemaphoreCounterValueKHR getSemaphoreCounterValue_ = nullptr;
+	PFN_vkWaitSemaphoresKHR waitSemaphores_ = nullptr;
+#endif
+
+	std::mutex mutex_;
+	uint64_t submittedValue_ = 0;
+
+	//! it is read without locking and written with locking
+	std::atomic<uint64_t> completedValue_;
+
+	//! fences which are signaled with values when a timeline semaphore is not enabled
+	std::deque<PendingFence> pendingFences_;
+	std::vector<vk::Fence> freeFences_;
+
+	void UpdateCompletedValue();
+
+	bool WaitFences(uint64_t value);
+
+public:
+	/**
+		@param	isTimelineSemaphoreEnabled	whether VK_KHR_timeline_semaphore and its feature are enabled with the device
+	*/
+	TimelineVulkan(vk::Device device, bool isTimelineSemaphoreEnabled);
+	~TimelineVulkan();
+
+	/**
+		@brief	submit commands which signal a next value
+		@return	the value, or 0 if it is failed to submit
+	*/
+	uint64_t Submit(vk::Queue queue, const vk::SubmitInfo& submitInfo);
+
+	/**
+		@brief	check whether submissions until the value are completed without waiting
+		@note
+		It returns true for 0 and false for a value which is not submitted.
+	*/
+	bool IsCompleted(uint64_t value);
+
+	bool Wait(uint64_t value);
+
+	uint64_t GetSubmittedValue();
+
+	uint64_t GetCompletedValue();
+
+	bool GetIsTimelineSemaphoreEnabled() const { return static_cast<bool>(semaphore_); }
+};
+
+} // namespace LLGI
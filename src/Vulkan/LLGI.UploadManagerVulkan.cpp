@@ -0,0 +1,361 @@
+#include "LLGI.UploadManagerVulkan.h"
+#include "LLGI.MemoryAllocatorVulkan.h"
+#include <algorithm>
+
+namespace LLGI
+{
+
+UploadManagerVulkan::UploadManagerVulkan(vk::Device device,
+										 vk::PhysicalDevice physicalDevice,
+										 vk::Queue queue,
+										 TimelineVulkan* timeline,
+										 int32_t queueFamilyIndex,
+										 MemoryAllocatorVulkan* memoryAllocator,
+										 vk::DeviceSize stagingPoolSize)
+	: device_(device)
+	, queue_(queue)
+	, timeline_(timeline)
+	, memoryAllocator_(memoryAllocator)
+	, stagingPoolAllocator_(stagingPoolSize)
+{
+	vk::CommandPoolCreateInfo cmdPoolInfo;
+	cmdPoolInfo.queueFamilyIndex = queueFamilyIndex;
+	cmdPoolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient;
+	commandPool_ = device_.createCommandPool(cmdPoolInfo);
+
+	// an offset of a copy into an image must be a multiple of a texel size and 4
+	const auto copyAlignment = physicalDevice.getProperties().limits.optimalBufferCopyOffsetAlignment;
+	if ((copyAlignment & (copyAlignment - 1)) == 0)
+	{
+		stagingAlignment_ = std::max(stagingAlignment_, copyAlignment);
+	}
+
+	StagingBufferVulkan stagingPool;
+	if (CreateStagingBuffer(stagingPoolSize, stagingPool))
+	{
+		stagingPool_ = stagingPool.Buffer;
+		stagingPoolAllocation_ = stagingPool.Allocation;
+		stagingPoolPointer_ = static_cast<uint8_t*>(stagingPool.Pointer);
+	}
+	else
+	{
+		Log(LogType::Warning, "Failed to create a staging pool. Staging buffers are created individually.");
+	}
+}
+
+UploadManagerVulkan::~UploadManagerVulkan()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		SubmitInternal();
+
+		while (!submittedBatches_.empty())
+		{
+			if (!WaitOldestBatch())
+			{
+				break;
+			}
+		}
+
+		for (auto& batch : submittedBatches_)
+		{
+			for (auto& stagingBuffer : batch->stagingBuffers)
+			{
+				FreeStagingBufferInternal(stagingBuffer);
+			}
+			freeBatches_.emplace_back(std::move(batch));
+		}
+		submittedBatches_.clear();
+	}
+
+	freeBatches_.clear();
+
+	// command buffers are freed with the pool
+	device_.destroyCommandPool(commandPool_);
+	commandPool_ = nullptr;
+
+	if (stagingPool_)
+	{
+		device_.destroyBuffer(stagingPool_);
+		memoryAllocator_->Free(stagingPoolAllocation_);
+		stagingPool_ = nullptr;
+	}
+}
+
+bool UploadManagerVulkan::CreateStagingBuffer(vk::DeviceSize size, StagingBufferVulkan& stagingBuffer)
+{
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.size = size;
+	bufferInfo.usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst;
+	bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+
+	auto buffer = device_.createBuffer(bufferInfo);
+	auto memReqs = device_.getBufferMemoryRequirements(buffer);
+
+	MemoryAllocationVulkan allocation;
+	if (!memoryAllocator_->Allocate(
+			memReqs, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, true, allocation))
+	{
+		device_.destroyBuffer(buffer);
+		return false;
+	}
+
+	device_.bindBufferMemory(buffer, allocation.Memory, allocation.Offset);
+
+	stagingBuffer.Buffer = buffer;
+	stagingBuffer.Offset = 0;
+	stagingBuffer.Size = size;
+	stagingBuffer.Pointer = memoryAllocator_->GetMappedPointer(allocation);
+	stagingBuffer.Allocation = allocation;
+	return true;
+}
+
+void UploadManagerVulkan::FreeStagingBufferInternal(StagingBufferVulkan& stagingBuffer)
+{
+	if (!stagingBuffer.Buffer)
+	{
+		return;
+	}
+
+	if (stagingBuffer.Buffer == stagingPool_)
+	{
+		stagingPoolAllocator_.Free(stagingBuffer.Offset, stagingBuffer.Size);
+	}
+	else
+	{
+		device_.destroyBuffer(stagingBuffer.Buffer);
+		memoryAllocator_->Free(stagingBuffer.Allocation);
+	}
+
+	stagingBuffer = StagingBufferVulkan();
+}
+
+UploadManagerVulkan::Batch* UploadManagerVulkan::GetRecordingBatch()
+{
+	if (recordingBatch_ != nullptr)
+	{
+		return recordingBatch_.get();
+	}
+
+	if (!freeBatches_.empty())
+	{
+		recordingBatch_ = std::move(freeBatches_.back());
+		freeBatches_.pop_back();
+
+		recordingBatch_->commandBuffer.reset(vk::CommandBufferResetFlags());
+	}
+	else
+	{
+		recordingBatch_ = std::make_unique<Batch>();
+
+		vk::CommandBufferAllocateInfo allocInfo;
+		allocInfo.commandPool = commandPool_;
+		allocInfo.level = vk::CommandBufferLevel::ePrimary;
+		allocInfo.commandBufferCount = 1;
+		recordingBatch_->commandBuffer = device_.allocateCommandBuffers(allocInfo)[0];
+	}
+
+	recordingBatch_->ticket = nextTicket_++;
+
+	vk::CommandBufferBeginInfo beginInfo;
+	beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+	recordingBatch_->commandBuffer.begin(beginInfo);
+
+	return recordingBatch_.get();
+}
+
+uint64_t UploadManagerVulkan::SubmitInternal()
+{
+	if (recordingBatch_ == nullptr)
+	{
+		return 0;
+	}
+
+	auto batch = std::move(recordingBatch_);
+	batch->commandBuffer.end();
+
+	vk::SubmitInfo submitInfo;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &(batch->commandBuffer);
+
+	batch->submittedValue = timeline_->Submit(queue_, submitInfo);
+	if (batch->submittedValue == 0)
+	{
+		Log(LogType::Error, "Failed to submit uploads");
+
+		// the batch is treated as completed because the timeline never reaches it
+		for (auto& stagingBuffer : batch->stagingBuffers)
+		{
+			FreeStagingBufferInternal(stagingBuffer);
+		}
+		batch->stagingBuffers.clear();
+		completedTicket_ = std::max(completedTicket_, batch->ticket);
+		freeBatches_.emplace_back(std::move(batch));
+		return 0;
+	}
+
+	const auto ticket = batch->ticket;
+	submittedBatches_.emplace_back(std::move(batch));
+	return ticket;
+}
+
+void UploadManagerVulkan::Reclaim()
+{
+	while (!submittedBatches_.empty())
+	{
+		auto& batch = submittedBatches_.front();
+		if (!timeline_->IsCompleted(batch->submittedValue))
+		{
+			break;
+		}
+
+		for (auto& stagingBuffer : batch->stagingBuffers)
+		{
+			FreeStagingBufferInternal(stagingBuffer);
+		}
+		batch->stagingBuffers.clear();
+
+		completedTicket_ = std::max(completedTicket_, batch->ticket);
+		freeBatches_.emplace_back(std::move(batch));
+		submittedBatches_.pop_front();
+	}
+}
+
+bool UploadManagerVulkan::WaitOldestBatch()
+{
+	if (submittedBatches_.empty())
+	{
+		return true;
+	}
+
+	if (!timeline_->Wait(submittedBatches_.front()->submittedValue))
+	{
+		Log(LogType::Error, "Failed to wait for uploads");
+		return false;
+	}
+
+	Reclaim();
+	return true;
+}
+
+bool UploadManagerVulkan::AllocateStagingBuffer(vk::DeviceSize size, StagingBufferVulkan& stagingBuffer)
+{
+	if (size == 0)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	Reclaim();
+
+	if (stagingPool_ && size <= stagingPoolAllocator_.GetCapacity())
+	{
+		while (true)
+		{
+			uint64_t offset = 0;
+			if (stagingPoolAllocator_.Allocate(size, stagingAlignment_, offset))
+			{
+				stagingBuffer.Buffer = stagingPool_;
+				stagingBuffer.Offset = offset;
+				stagingBuffer.Size = size;
+				stagingBuffer.Pointer = stagingPoolPointer_ + offset;
+				stagingBuffer.Allocation = MemoryAllocationVulkan();
+				return true;
+			}
+
+			// staging buffers of recorded copies are returned after they are completed
+			if (recordingBatch_ != nullptr && !recordingBatch_->stagingBuffers.empty())
+			{
+				SubmitInternal();
+			}
+
+			if (submittedBatches_.empty() || !WaitOldestBatch())
+			{
+				break;
+			}
+		}
+	}
+
+	return CreateStagingBuffer(size, stagingBuffer);
+}
+
+void UploadManagerVulkan::FreeStagingBuffer(StagingBufferVulkan& stagingBuffer)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	FreeStagingBufferInternal(stagingBuffer);
+}
+
+uint64_t UploadManagerVulkan::Record(StagingBufferVulkan& stagingBuffer,
+									 const std::function<void(vk::CommandBuffer&, const StagingBufferVulkan&)>& recorder)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto batch = GetRecordingBatch();
+	recorder(batch->commandBuffer, stagingBuffer);
+
+	if (stagingBuffer.Buffer)
+	{
+		batch->stagingBuffers.emplace_back(stagingBuffer);
+		stagingBuffer = StagingBufferVulkan();
+	}
+
+	return batch->ticket;
+}
+
+uint64_t UploadManagerVulkan::Record(const std::function<void(vk::CommandBuffer&)>& recorder)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto batch = GetRecordingBatch();
+	recorder(batch->commandBuffer);
+	return batch->ticket;
+}
+
+uint64_t UploadManagerVulkan::Submit()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	Reclaim();
+	return SubmitInternal();
+}
+
+bool UploadManagerVulkan::IsCompleted(uint64_t ticket)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (recordingBatch_ != nullptr && ticket >= recordingBatch_->ticket)
+	{
+		return false;
+	}
+
+	Reclaim();
+	return ticket <= completedTicket_;
+}
+
+void UploadManagerVulkan::Wait(uint64_t ticket)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (recordingBatch_ != nullptr && ticket >= recordingBatch_->ticket)
+	{
+		SubmitInternal();
+	}
+
+	while (!submittedBatches_.empty() && submittedBatches_.front()->ticket <= ticket)
+	{
+		if (!WaitOldestBatch())
+		{
+			break;
+		}
+	}
+}
+
+vk::DeviceSize UploadManagerVulkan::GetStagingPoolUsedSize()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	Reclaim();
+	return stagingPoolAllocator_.GetUsedSize();
+}
+
+} // namespace LLGI
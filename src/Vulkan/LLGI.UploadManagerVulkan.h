@@ -0,0 +1,145 @@
+#pragma once
+
+#include "../Utils/LLGI.FreeListAllocator.h"
+#include "LLGI.BaseVulkan.h"
+#include "LLGI.TimelineVulkan.h"
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace LLGI
+{
+
+class MemoryAllocatorVulkan;
+
+/**
+	@brief	a range of host visible memory which data is copied from or into
+*/
+struct StagingBufferVulkan
+{
+	vk::Buffer Buffer;
+	vk::DeviceSize Offset = 0;
+	vk::DeviceSize Size = 0;
+	void* Pointer = nullptr;
+
+	//! memory of a buffer which is created individually because the staging pool is short
+	MemoryAllocationVulkan Allocation;
+};
+
+/**
+	@brief	a manager which batches copies from cpu to gpu into one submission
+	@note
+	Initial layout transitions of textures are also recorded into the batch instead of waiting for each of them.
+	Data is put in staging buffers from a bounded pool and copies are recorded into a command buffer until Submit.
+	GraphicsVulkan calls Submit before a command list is executed, so uploads are completed before the command list runs.
+	Staging buffers are returned to the pool when the timeline reaches the value of the submission.
+	Resources borrow staging buffers only while they are uploaded or read back, so they don't keep memory on cpu.
+	It is thread safe. Submissions to the queue are serialized by the timeline.
+*/
+class UploadManagerVulkan
+{
+private:
+	struct Batch
+	{
+		vk::CommandBuffer commandBuffer;
+		uint64_t ticket = 0;
+
+		//! a value of the timeline which is signaled when the batch is completed
+		uint64_t submittedValue = 0;
+		std::vector<StagingBufferVulkan> stagingBuffers;
+	};
+
+	vk::Device device_;
+	vk::Queue queue_;
+	TimelineVulkan* timeline_ = nullptr;
+	vk::CommandPool commandPool_;
+	MemoryAllocatorVulkan* memoryAllocator_ = nullptr;
+
+	vk::Buffer stagingPool_;
+	MemoryAllocationVulkan stagingPoolAllocation_;
+	uint8_t* stagingPoolPointer_ = nullptr;
+	FreeListAllocator stagingPoolAllocator_;
+	vk::DeviceSize stagingAlignment_ = 16;
+
+	std::mutex mutex_;
+	std::unique_ptr<Batch> recordingBatch_;
+	std::deque<std::unique_ptr<Batch>> submittedBatches_;
+	std::vector<std::unique_ptr<Batch>> freeBatches_;
+	uint64_t nextTicket_ = 1;
+	uint64_t completedTicket_ = 0;
+
+	bool CreateStagingBuffer(vk::DeviceSize size, StagingBufferVulkan& stagingBuffer);
+
+	void FreeStagingBufferInternal(StagingBufferVulkan& stagingBuffer);
+
+	Batch* GetRecordingBatch();
+
+	uint64_t SubmitInternal();
+
+	//! return resources of batches which are completed
+	void Reclaim();
+
+	bool WaitOldestBatch();
+
+public:
+	UploadManagerVulkan(vk::Device device,
+						vk::PhysicalDevice physicalDevice,
+						vk::Queue queue,
+						TimelineVulkan* timeline,
+						int32_t queueFamilyIndex,
+						MemoryAllocatorVulkan* memoryAllocator,
+						vk::DeviceSize stagingPoolSize);
+	~UploadManagerVulkan();
+
+	/**
+		@brief	get a staging buffer which is written by cpu
+		@note
+		If the pool is short, it waits until submitted copies are completed.
+		A buffer is created individually if it is still short.
+	*/
+	bool AllocateStagingBuffer(vk::DeviceSize size, StagingBufferVulkan& stagingBuffer);
+
+	/**
+		@brief	return a staging buffer which is not passed to Record
+		@note
+		A caller must guarantee that gpu doesn't read it anymore.
+	*/
+	void FreeStagingBuffer(StagingBufferVulkan& stagingBuffer);
+
+	/**
+		@brief	record copies from a staging buffer into the current batch
+		@return	a ticket to wait for the copies, or 0 if it failed
+		@note
+		The staging buffer is owned by the batch and returned to the pool after copies are completed.
+	*/
+	uint64_t Record(StagingBufferVulkan& stagingBuffer,
+					const std::function<void(vk::CommandBuffer&, const StagingBufferVulkan&)>& recorder);
+
+	/**
+		@brief	record commands which don't need a staging buffer (ex. layout transitions) into the current batch
+		@return	a ticket to wait for the commands
+	*/
+	uint64_t Record(const std::function<void(vk::CommandBuffer&)>& recorder);
+
+	/**
+		@brief	submit recorded copies
+		@return	a ticket of the submitted copies, or 0 if nothing is recorded
+	*/
+	uint64_t Submit();
+
+	bool IsCompleted(uint64_t ticket);
+
+	/**
+		@brief	wait until copies of the ticket are completed
+		@note
+		The current batch is submitted if it contains the ticket.
+	*/
+	void Wait(uint64_t ticket);
+
+	vk::DeviceSize GetStagingPoolSize() const { return stagingPoolAllocator_.GetCapacity(); }
+
+	vk::DeviceSize GetStagingPoolUsedSize();
+};
+
+} // namespace LLGI
@@ -223,6 +223,32 @@ void TestHelper::CreateRectangle(LLGI::Graphics* graphics,
 	ib->Unlock();
 }
 
+std::shared_ptr<LLGI::PipelineState>
+TestHelper::CreatePipelineState(LLGI::Graphics* graphics, LLGI::RenderPass* renderPass, LLGI::Shader* vs, LLGI::Shader* ps)
+{
+	auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass));
+
+	auto pip = LLGI::CreateSharedPtr(graphics->CreatePiplineState());
+	pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+	pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+	pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+	pip->VertexLayoutNames[0] = "POSITION";
+	pip->VertexLayoutNames[1] = "UV";
+	pip->VertexLayoutNames[2] = "COLOR";
+	pip->VertexLayoutCount = 3;
+
+	pip->SetShader(LLGI::ShaderStageType::Vertex, vs);
+	pip->SetShader(LLGI::ShaderStageType::Pixel, ps);
+	pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+
+	if (!pip->Compile())
+	{
+		return nullptr;
+	}
+
+	return pip;
+}
+
 void TestHelper::CreateShader(LLGI::Graphics* graphics,
 							  LLGI::DeviceType deviceType,
 							  const char* vsBinaryPath,
@@ -54,6 +54,12 @@ public:
 							 std::shared_ptr<LLGI::Shader>& vs,
 							 std::shared_ptr<LLGI::Shader>& ps);
 
+	/**
+		@brief create a pipeline state which draws a rectangle created with CreateRectangle into render passes compatible with renderPass
+	*/
+	static std::shared_ptr<LLGI::PipelineState>
+	CreatePipelineState(LLGI::Graphics* graphics, LLGI::RenderPass* renderPass, LLGI::Shader* vs, LLGI::Shader* ps);
+
 	static void
 	CreateComputeShader(LLGI::Graphics* graphics, LLGI::DeviceType deviceType, const char* csBinaryPath, std::shared_ptr<LLGI::Shader>& cs);
 
@@ -0,0 +1,157 @@
+#include "TestHelper.h"
+#include "test.h"
+#include <LLGI.FrameGraph.h>
+#include <Null/LLGI.CommandListNull.h>
+
+void test_frame_graph()
+{
+	// the device specified with arguments is ignored, because the graph doesn't depend on backends
+	LLGI::PlatformParameter pp;
+	pp.Device = LLGI::DeviceType::Null;
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+	VERIFY(platform != nullptr);
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+	auto commandList = LLGI::CreateSharedPtr(graphics->CreateCommandList(sfMemoryPool.get()));
+
+	LLGI::TextureParameter rtParam;
+	rtParam.Usage = LLGI::TextureUsageType::RenderTarget;
+	rtParam.Size = LLGI::Vec3I(256, 256, 1);
+	auto output = LLGI::CreateSharedPtr(graphics->CreateTexture(rtParam));
+
+	auto frameGraph = std::make_shared<LLGI::FrameGraph>(graphics.get());
+
+	LLGI::Texture* previousSceneTexture = nullptr;
+
+	for (int32_t frame = 0; frame < 3; frame++)
+	{
+		VERIFY(platform->NewFrame());
+		sfMemoryPool->NewFrame();
+
+		std::vector<std::string> executedPasses;
+		auto record = [&](const char* name) -> std::function<void(LLGI::FrameGraphPassContext&)> {
+			return [&executedPasses, name](LLGI::FrameGraphPassContext& context) -> void {
+				VERIFY(context.GetCommandList() != nullptr);
+				executedPasses.emplace_back(name);
+			};
+		};
+
+		auto outputResource = frameGraph->ImportTexture(output.get());
+		LLGI::FrameGraphResource scene;
+		LLGI::FrameGraphResource unused;
+		LLGI::FrameGraphResource blurX;
+		LLGI::FrameGraphResource blurY;
+
+		frameGraph->AddPass(
+			"Scene",
+			LLGI::FrameGraphPassType::Render,
+			[&](LLGI::FrameGraphPassBuilder& builder) -> void {
+				scene = builder.CreateTexture(rtParam);
+				builder.SetRenderTarget(0, scene);
+				builder.SetClearColor(LLGI::Color8());
+			},
+			record("Scene"));
+
+		// nothing reads it
+		frameGraph->AddPass(
+			"Unused",
+			LLGI::FrameGraphPassType::Render,
+			[&](LLGI::FrameGraphPassBuilder& builder) -> void {
+				unused = builder.CreateTexture(rtParam);
+				builder.SetRenderTarget(0, unused);
+				builder.SetClearColor(LLGI::Color8());
+			},
+			record("Unused"));
+
+		frameGraph->AddPass(
+			"BlurX",
+			LLGI::FrameGraphPassType::Render,
+			[&](LLGI::FrameGraphPassBuilder& builder) -> void {
+				builder.Read(scene);
+				blurX = builder.CreateTexture(rtParam);
+				builder.SetRenderTarget(0, blurX);
+				builder.SetClearColor(LLGI::Color8());
+			},
+			record("BlurX"));
+
+		frameGraph->AddPass(
+			"BlurY",
+			LLGI::FrameGraphPassType::Render,
+			[&](LLGI::FrameGraphPassBuilder& builder) -> void {
+				builder.Read(blurX);
+				blurY = builder.CreateTexture(rtParam);
+				builder.SetRenderTarget(0, blurY);
+				builder.SetClearColor(LLGI::Color8());
+			},
+			record("BlurY"));
+
+		frameGraph->AddPass(
+			"Composite",
+			LLGI::FrameGraphPassType::Render,
+			[&](LLGI::FrameGraphPassBuilder& builder) -> void {
+				builder.Read(blurY);
+				builder.SetRenderTarget(0, outputResource);
+				builder.SetClearColor(LLGI::Color8());
+			},
+			record("Composite"));
+
+		frameGraph->AddPass(
+			"Screen",
+			LLGI::FrameGraphPassType::Render,
+			[&](LLGI::FrameGraphPassBuilder& builder) -> void {
+				builder.Read(outputResource);
+				builder.SetRenderPass(platform->GetCurrentScreen(LLGI::Color8(), true, false));
+			},
+			record("Screen"));
+
+		VERIFY(frameGraph->Compile());
+
+		const auto& stats = frameGraph->GetStats();
+		VERIFY(stats.PassCount == 6);
+		VERIFY(stats.CulledPassCount == 1);
+		VERIFY(stats.TransientTextureCount == 3);
+
+		// blurY is written after scene is read, so they share a texture
+		VERIFY(stats.PhysicalTextureCount == 2);
+		VERIFY(frameGraph->GetTexture(scene) == frameGraph->GetTexture(blurY));
+		VERIFY(frameGraph->GetTexture(scene) != frameGraph->GetTexture(blurX));
+		VERIFY(frameGraph->GetTexture(unused) == nullptr);
+		VERIFY(frameGraph->GetTexture(outputResource) == output.get());
+
+		// textures are kept over frames
+		if (previousSceneTexture != nullptr)
+		{
+			VERIFY(frameGraph->GetTexture(scene) == previousSceneTexture);
+		}
+		previousSceneTexture = frameGraph->GetTexture(scene);
+
+		commandList->Begin();
+		frameGraph->Execute(commandList.get());
+		commandList->End();
+
+		graphics->Execute(commandList.get());
+		platform->Present();
+
+		const std::vector<std::string> expectedPasses = {"Scene", "BlurX", "BlurY", "Composite", "Screen"};
+		VERIFY(executedPasses == expectedPasses);
+
+		const auto& stream = static_cast<LLGI::CommandListNull*>(commandList.get())->GetCommandStream();
+		VERIFY(stream.GetCommandCount(LLGI::CommandTypeNull::BeginRenderPass) == 5);
+		VERIFY(stream.GetCommandCount(LLGI::CommandTypeNull::EndRenderPass) == 5);
+
+		frameGraph->Reset();
+	}
+
+	// textures which are not used are kept while previous frames may use them
+	for (int32_t frame = 0; frame <= 3; frame++)
+	{
+		VERIFY(frameGraph->Compile());
+		VERIFY(frameGraph->GetStats().PhysicalTextureCount == (frame < 3 ? 2 : 0));
+		frameGraph->Reset();
+	}
+
+	graphics->WaitFinish();
+}
+
+TestRegister FrameGraph_Basic("FrameGraph.Basic", [](LLGI::DeviceType device) -> void { test_frame_graph(); });
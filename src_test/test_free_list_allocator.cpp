@@ -0,0 +1,70 @@
+#include "TestHelper.h"
+#include "test.h"
+
+#include <Utils/LLGI.FreeListAllocator.h>
+
+void test_free_list_allocator()
+{
+	LLGI::FreeListAllocator allocator(1024);
+
+	// ranges are aligned
+	uint64_t offset0 = 0;
+	uint64_t offset1 = 0;
+	uint64_t offset2 = 0;
+	VERIFY(allocator.Allocate(100, 1, offset0));
+	VERIFY(allocator.Allocate(100, 256, offset1));
+	VERIFY(allocator.Allocate(200, 16, offset2));
+	VERIFY(offset0 == 0);
+	VERIFY(offset1 == 256);
+	VERIFY(offset2 % 16 == 0);
+	VERIFY(offset2 < offset1 || offset2 >= offset1 + 100);
+	VERIFY(allocator.GetAllocationCount() == 3);
+	VERIFY(allocator.GetUsedSize() == 400);
+
+	// too large
+	uint64_t offset = 0;
+	VERIFY(!allocator.Allocate(1024, 1, offset));
+
+	// the best fit range is used
+	allocator.Free(offset0, 100);
+	VERIFY(allocator.Allocate(50, 1, offset));
+	VERIFY(offset == 0);
+	allocator.Free(offset, 50);
+
+	// free ranges are merged
+	allocator.Free(offset1, 100);
+	allocator.Free(offset2, 200);
+	VERIFY(allocator.IsEmpty());
+	VERIFY(allocator.GetUsedSize() == 0);
+	VERIFY(allocator.GetFreeRangeCount() == 1);
+	VERIFY(allocator.GetLargestFreeRange() == 1024);
+
+	VERIFY(allocator.Allocate(1024, 1, offset));
+	VERIFY(offset == 0);
+	allocator.Free(offset, 1024);
+
+	// fragmented
+	std::vector<uint64_t> offsets;
+	while (allocator.Allocate(64, 64, offset))
+	{
+		offsets.push_back(offset);
+	}
+	VERIFY(offsets.size() == 16);
+
+	for (size_t i = 0; i < offsets.size(); i += 2)
+	{
+		allocator.Free(offsets[i], 64);
+	}
+	VERIFY(allocator.GetFreeRangeCount() == 8);
+	VERIFY(allocator.GetLargestFreeRange() == 64);
+	VERIFY(!allocator.Allocate(128, 1, offset));
+
+	for (size_t i = 1; i < offsets.size(); i += 2)
+	{
+		allocator.Free(offsets[i], 64);
+	}
+	VERIFY(allocator.GetFreeRangeCount() == 1);
+	VERIFY(allocator.IsEmpty());
+}
+
+TestRegister Utils_FreeListAllocator("Utils.FreeListAllocator", [](LLGI::DeviceType device) -> void { test_free_list_allocator(); });
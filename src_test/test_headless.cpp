@@ -0,0 +1,72 @@
+#include "TestHelper.h"
+#include "test.h"
+#include <Utils/LLGI.CommandListPool.h>
+
+void test_headless(LLGI::DeviceType deviceType, int32_t maxFramesInFlight)
+{
+	// headless mode is supported only with Vulkan
+	if (deviceType != LLGI::DeviceType::Vulkan)
+		return;
+
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.IsHeadless = true;
+	pp.HeadlessScreenSize = LLGI::Vec2I(320, 240);
+	pp.MaxFramesInFlight = maxFramesInFlight;
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+	VERIFY(platform != nullptr);
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+	auto commandListPool = std::make_shared<LLGI::CommandListPool>(graphics.get(), sfMemoryPool.get(), 3);
+
+	LLGI::Color8 color;
+	LLGI::Texture* screen = nullptr;
+
+	while (count < 10)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		color.R = count * 20;
+		color.G = 64;
+		color.B = 128;
+		color.A = 255;
+
+		auto renderPass = platform->GetCurrentScreen(color, true, false);
+		screen = renderPass->GetRenderTexture(0);
+
+		auto commandList = commandListPool->Get();
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+	}
+
+	VERIFY(screen != nullptr);
+	VERIFY(screen->GetSizeAs2D() == LLGI::Vec2I(320, 240));
+
+	// the last screen is kept until NewFrame reuses it
+	auto data = graphics->CaptureRenderTarget(screen);
+	VERIFY(data.size() == 320 * 240 * 4);
+	VERIFY(data[0] == color.R);
+	VERIFY(data[1] == color.G);
+	VERIFY(data[2] == color.B);
+	VERIFY(data[3] == color.A);
+
+	graphics->WaitFinish();
+}
+
+TestRegister Headless_Basic("Headless.Basic", [](LLGI::DeviceType device) -> void { test_headless(device, 2); });
+
+// frames in flight are more than screens
+TestRegister Headless_FramesInFlight("Headless.FramesInFlight", [](LLGI::DeviceType device) -> void { test_headless(device, 5); });
@@ -0,0 +1,405 @@
+#include "TestHelper.h"
+#include "test.h"
+#include <Null/LLGI.CommandListNull.h>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+void test_null_draw(int32_t drawCount)
+{
+	// the device specified with arguments is ignored, because Null measures an overhead of LLGI itself
+	LLGI::PlatformParameter pp;
+	pp.Device = LLGI::DeviceType::Null;
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+	VERIFY(platform != nullptr);
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+	auto commandList = LLGI::CreateSharedPtr(graphics->CreateCommandList(sfMemoryPool.get()));
+
+	auto vb = LLGI::CreateSharedPtr(graphics->CreateBuffer(LLGI::BufferUsageType::Vertex | LLGI::BufferUsageType::MapWrite,
+															 sizeof(SimpleVertex) * 4));
+	auto ib = LLGI::CreateSharedPtr(graphics->CreateBuffer(LLGI::BufferUsageType::Index | LLGI::BufferUsageType::MapWrite, 2 * 6));
+
+	LLGI::TextureInitializationParameter texParam;
+	texParam.Size = LLGI::Vec2I(16, 16);
+	auto texture = LLGI::CreateSharedPtr(graphics->CreateTexture(texParam));
+
+	const char code[] = "null";
+	LLGI::DataStructure data;
+	data.Data = code;
+	data.Size = sizeof(code);
+	auto shaderVS = LLGI::CreateSharedPtr(graphics->CreateShader(&data, 1));
+	auto shaderPS = LLGI::CreateSharedPtr(graphics->CreateShader(&data, 1));
+
+	auto renderPass = platform->GetCurrentScreen(LLGI::Color8(), true, true);
+	auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass));
+
+	auto pip = LLGI::CreateSharedPtr(graphics->CreatePiplineState());
+	pip->SetShader(LLGI::ShaderStageType::Vertex, shaderVS.get());
+	pip->SetShader(LLGI::ShaderStageType::Pixel, shaderPS.get());
+	pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+	VERIFY(pip->Compile());
+
+	auto nullCommandList = static_cast<LLGI::CommandListNull*>(commandList.get());
+
+	for (int32_t frame = 0; frame < 3; frame++)
+	{
+		VERIFY(platform->NewFrame());
+		sfMemoryPool->NewFrame();
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		commandList->Begin();
+		commandList->BeginRenderPass(platform->GetCurrentScreen(LLGI::Color8(), true, true));
+
+		for (int32_t i = 0; i < drawCount; i++)
+		{
+			auto cb = sfMemoryPool->CreateConstantBuffer(sizeof(float) * 4);
+			commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+			commandList->SetIndexBuffer(ib.get(), 2);
+			commandList->SetPipelineState(pip.get());
+			commandList->SetConstantBuffer(cb, 0);
+			commandList->SetTexture(texture.get(), LLGI::TextureWrapMode::Repeat, LLGI::TextureMinMagFilter::Linear, 0);
+			commandList->Draw(2);
+			LLGI::SafeRelease(cb);
+		}
+
+		commandList->EndRenderPass();
+		commandList->End();
+
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		graphics->Execute(commandList.get());
+		platform->Present();
+
+		const auto& stream = nullCommandList->GetCommandStream();
+		VERIFY(stream.GetCommandCount(LLGI::CommandTypeNull::Draw) == drawCount);
+		VERIFY(stream.GetCommandCount(LLGI::CommandTypeNull::SetVertexBuffer) == 1);
+		VERIFY(stream.GetCommandCount(LLGI::CommandTypeNull::SetIndexBuffer) == 1);
+		VERIFY(stream.GetCommandCount(LLGI::CommandTypeNull::SetConstantBuffer) == drawCount);
+		VERIFY(stream.GetCommandCount(LLGI::CommandTypeNull::SetTexture) == drawCount);
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		std::cout << "Null.Draw : " << drawCount << " draws, " << static_cast<double>(elapsed) / drawCount << " ns/draw, "
+				  << stream.GetSize() << " bytes" << std::endl;
+	}
+
+	graphics->WaitFinish();
+}
+
+void test_null_sub_command_lists(int32_t threadCount, int32_t drawCountPerThread)
+{
+	LLGI::PlatformParameter pp;
+	pp.Device = LLGI::DeviceType::Null;
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+	auto commandList = LLGI::CreateSharedPtr(graphics->CreateCommandList(sfMemoryPool.get()));
+
+	// a memory pool and a sub command list for each thread
+	std::vector<std::shared_ptr<LLGI::SingleFrameMemoryPool>> subMemoryPools;
+	std::vector<std::shared_ptr<LLGI::CommandList>> subCommandLists;
+	for (int32_t i = 0; i < threadCount; i++)
+	{
+		subMemoryPools.emplace_back(LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128)));
+		subCommandLists.emplace_back(LLGI::CreateSharedPtr(graphics->CreateSubCommandList(subMemoryPools.back().get())));
+		VERIFY(subCommandLists.back() != nullptr);
+	}
+
+	auto vb = LLGI::CreateSharedPtr(graphics->CreateBuffer(LLGI::BufferUsageType::Vertex | LLGI::BufferUsageType::MapWrite,
+															 sizeof(SimpleVertex) * 4));
+	auto ib = LLGI::CreateSharedPtr(graphics->CreateBuffer(LLGI::BufferUsageType::Index | LLGI::BufferUsageType::MapWrite, 2 * 6));
+
+	const char code[] = "null";
+	LLGI::DataStructure data;
+	data.Data = code;
+	data.Size = sizeof(code);
+	auto shader = LLGI::CreateSharedPtr(graphics->CreateShader(&data, 1));
+
+	auto renderPassPipelineState =
+		LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(platform->GetCurrentScreen(LLGI::Color8(), true, true)));
+
+	auto pip = LLGI::CreateSharedPtr(graphics->CreatePiplineState());
+	pip->SetShader(LLGI::ShaderStageType::Vertex, shader.get());
+	pip->SetShader(LLGI::ShaderStageType::Pixel, shader.get());
+	pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+	VERIFY(pip->Compile());
+
+	for (int32_t frame = 0; frame < 3; frame++)
+	{
+		VERIFY(platform->NewFrame());
+		sfMemoryPool->NewFrame();
+
+		auto renderPass = platform->GetCurrentScreen(LLGI::Color8(), true, true);
+
+		std::vector<std::thread> threads;
+		for (int32_t t = 0; t < threadCount; t++)
+		{
+			threads.emplace_back([&, t]() -> void {
+				auto memoryPool = subMemoryPools[t];
+				auto subCommandList = subCommandLists[t];
+				memoryPool->NewFrame();
+
+				subCommandList->Begin();
+				subCommandList->BeginRenderPass(renderPass);
+				for (int32_t i = 0; i < drawCountPerThread; i++)
+				{
+					auto cb = memoryPool->CreateConstantBuffer(sizeof(float) * 4);
+					subCommandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+					subCommandList->SetIndexBuffer(ib.get(), 2);
+					subCommandList->SetPipelineState(pip.get());
+					subCommandList->SetConstantBuffer(cb, 0);
+					subCommandList->Draw(2);
+					LLGI::SafeRelease(cb);
+				}
+				subCommandList->EndRenderPass();
+				subCommandList->End();
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		std::vector<LLGI::CommandList*> subCommandListPtrs;
+		for (auto& subCommandList : subCommandLists)
+		{
+			subCommandListPtrs.emplace_back(subCommandList.get());
+		}
+
+		commandList->Begin();
+		commandList->BeginRenderPassWithSubCommandLists(renderPass);
+		commandList->ExecuteSubCommandLists(subCommandListPtrs.data(), static_cast<int32_t>(subCommandListPtrs.size()));
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList.get());
+		platform->Present();
+
+		const auto& stream = static_cast<LLGI::CommandListNull*>(commandList.get())->GetCommandStream();
+		VERIFY(stream.GetCommandCount(LLGI::CommandTypeNull::Draw) == threadCount * drawCountPerThread);
+		VERIFY(stream.GetCommandCount(LLGI::CommandTypeNull::BeginRenderPass) == 1);
+		VERIFY(stream.GetCommandCount(LLGI::CommandTypeNull::EndRenderPass) == 1);
+	}
+
+	graphics->WaitFinish();
+}
+
+void test_null_render_pass_key()
+{
+	LLGI::PlatformParameter pp;
+	pp.Device = LLGI::DeviceType::Null;
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+	VERIFY(platform != nullptr);
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+
+	LLGI::RenderTextureInitializationParameter rtParam;
+	rtParam.Size = LLGI::Vec2I(64, 64);
+	rtParam.SamplingCount = 4;
+	rtParam.IsTransient = true;
+	auto msaaTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(rtParam));
+
+	rtParam.SamplingCount = 1;
+	rtParam.IsTransient = false;
+	auto resolvedTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(rtParam));
+
+	LLGI::DepthTextureInitializationParameter depthParam;
+	depthParam.Size = rtParam.Size;
+	depthParam.SamplingCount = 4;
+	auto depthTexture = LLGI::CreateSharedPtr(graphics->CreateDepthTexture(depthParam));
+
+	auto renderPass = LLGI::CreateSharedPtr(
+		graphics->CreateRenderPass(msaaTexture.get(), resolvedTexture.get(), depthTexture.get(), nullptr));
+
+	// previous contents are loaded and stored by default
+	auto key = renderPass->GetKey();
+	VERIFY(key.ColorLoadOps.at(0) == LLGI::AttachmentLoadOp::Load);
+	VERIFY(key.DepthLoadOp == LLGI::AttachmentLoadOp::Load);
+	VERIFY(key.DepthStoreOp == LLGI::AttachmentStoreOp::Store);
+
+	// a transient texture is only resolved
+	VERIFY(key.ColorStoreOps.at(0) == LLGI::AttachmentStoreOp::Resolve);
+	VERIFY(key.TransientRenderTargets == 1);
+
+	renderPass->SetIsColorCleared(true);
+	renderPass->SetClearColor(LLGI::Color8(1, 2, 3, 4));
+	VERIFY(renderPass->GetColorLoadOp(0) == LLGI::AttachmentLoadOp::Clear);
+	VERIFY(renderPass->GetClearColor(0).R == 1);
+
+	renderPass->SetDepthLoadOp(LLGI::AttachmentLoadOp::DontCare);
+	renderPass->SetDepthStoreOp(LLGI::AttachmentStoreOp::Discard);
+	renderPass->SetClearDepth(0.0f);
+	renderPass->SetClearStencil(1);
+	VERIFY(!renderPass->GetIsDepthCleared());
+	VERIFY(renderPass->GetClearDepth() == 0.0f);
+	VERIFY(renderPass->GetClearStencil() == 1);
+
+	auto clearedKey = renderPass->GetKey();
+	VERIFY(clearedKey.ColorLoadOps.at(0) == LLGI::AttachmentLoadOp::Clear);
+	VERIFY(clearedKey.DepthLoadOp == LLGI::AttachmentLoadOp::DontCare);
+	VERIFY(clearedKey.DepthStoreOp == LLGI::AttachmentStoreOp::Discard);
+	VERIFY(clearedKey != key);
+
+	// clear values don't change a render pass pipeline state
+	renderPass->SetClearColor(LLGI::Color8(5, 6, 7, 8));
+	VERIFY(renderPass->GetKey() == clearedKey);
+	VERIFY(LLGI::RenderPassPipelineStateKey::Hash()(renderPass->GetKey()) == LLGI::RenderPassPipelineStateKey::Hash()(clearedKey));
+
+	// ids are same if and only if keys are same
+	auto clearedKeyID = renderPass->GetKeyID();
+	VERIFY(clearedKeyID == LLGI::RenderPassPipelineStateKeyTable::Intern(clearedKey));
+	VERIFY(clearedKeyID != LLGI::RenderPassPipelineStateKeyTable::Intern(key));
+
+	renderPass->SetIsColorCleared(false);
+	VERIFY(renderPass->GetKeyID() != clearedKeyID);
+
+	auto pipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass.get()));
+	VERIFY(pipelineState->GetKeyID() == renderPass->GetKeyID());
+
+	// the order of render targets changes a hash
+	LLGI::RenderPassPipelineStateKey mrtKey;
+	mrtKey.RenderTargetFormats.resize(2);
+	mrtKey.ColorLoadOps.resize(2);
+	mrtKey.ColorStoreOps.resize(2);
+	mrtKey.ColorLoadOps.at(0) = LLGI::AttachmentLoadOp::Load;
+	mrtKey.ColorLoadOps.at(1) = LLGI::AttachmentLoadOp::Load;
+	mrtKey.ColorStoreOps.at(0) = LLGI::AttachmentStoreOp::Store;
+	mrtKey.ColorStoreOps.at(1) = LLGI::AttachmentStoreOp::Store;
+	mrtKey.RenderTargetFormats.at(0) = LLGI::TextureFormatType::R8G8B8A8_UNORM;
+	mrtKey.RenderTargetFormats.at(1) = LLGI::TextureFormatType::R16G16B16A16_FLOAT;
+
+	auto permutedKey = mrtKey;
+	permutedKey.RenderTargetFormats.at(0) = mrtKey.RenderTargetFormats.at(1);
+	permutedKey.RenderTargetFormats.at(1) = mrtKey.RenderTargetFormats.at(0);
+	VERIFY(mrtKey.GetHash() != permutedKey.GetHash());
+	VERIFY(LLGI::RenderPassPipelineStateKeyTable::Intern(mrtKey) != LLGI::RenderPassPipelineStateKeyTable::Intern(permutedKey));
+}
+
+//! objects which are used to draw with Null
+struct NullTestObjects
+{
+	std::shared_ptr<LLGI::Platform> platform;
+	std::shared_ptr<LLGI::Graphics> graphics;
+	std::shared_ptr<LLGI::SingleFrameMemoryPool> sfMemoryPool;
+	std::shared_ptr<LLGI::CommandList> commandList;
+	std::shared_ptr<LLGI::Shader> shader;
+	std::shared_ptr<LLGI::RenderPassPipelineState> renderPassPipelineState;
+	std::shared_ptr<LLGI::PipelineState> pip;
+	std::shared_ptr<LLGI::Buffer> vb;
+	std::shared_ptr<LLGI::Buffer> ib;
+
+	void Initialize()
+	{
+		// the device specified with arguments is ignored, because commands are checked on cpu
+		LLGI::PlatformParameter pp;
+		pp.Device = LLGI::DeviceType::Null;
+		platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+		VERIFY(platform != nullptr);
+
+		graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+		sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+		commandList = LLGI::CreateSharedPtr(graphics->CreateCommandList(sfMemoryPool.get()));
+
+		vb = LLGI::CreateSharedPtr(
+			graphics->CreateBuffer(LLGI::BufferUsageType::Vertex | LLGI::BufferUsageType::MapWrite, sizeof(SimpleVertex) * 4));
+		ib = LLGI::CreateSharedPtr(graphics->CreateBuffer(LLGI::BufferUsageType::Index | LLGI::BufferUsageType::MapWrite, 2 * 6));
+
+		const char code[] = "null";
+		LLGI::DataStructure data;
+		data.Data = code;
+		data.Size = sizeof(code);
+		shader = LLGI::CreateSharedPtr(graphics->CreateShader(&data, 1));
+
+		renderPassPipelineState =
+			LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(platform->GetCurrentScreen(LLGI::Color8(), true, true)));
+
+		pip = LLGI::CreateSharedPtr(graphics->CreatePiplineState());
+		pip->SetShader(LLGI::ShaderStageType::Vertex, shader.get());
+		pip->SetShader(LLGI::ShaderStageType::Pixel, shader.get());
+		pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+		VERIFY(pip->Compile());
+	}
+};
+
+void test_null_sampler()
+{
+	NullTestObjects objects;
+	objects.Initialize();
+
+	LLGI::TextureInitializationParameter texParam;
+	texParam.Size = LLGI::Vec2I(16, 16);
+	auto texture = LLGI::CreateSharedPtr(objects.graphics->CreateTexture(texParam));
+
+	LLGI::DepthTextureInitializationParameter depthParam;
+	depthParam.Size = texParam.Size;
+	auto depthTexture = LLGI::CreateSharedPtr(objects.graphics->CreateDepthTexture(depthParam));
+
+	LLGI::SamplerParameter anisotropic;
+	anisotropic.WrapModeU = LLGI::TextureWrapMode::Repeat;
+	anisotropic.WrapModeV = LLGI::TextureWrapMode::Border;
+	anisotropic.MinFilter = LLGI::TextureMinMagFilter::Linear;
+	anisotropic.MagFilter = LLGI::TextureMinMagFilter::Linear;
+	anisotropic.MaxAnisotropy = 16;
+	anisotropic.MipLodBias = -0.5f;
+	anisotropic.BorderColor = LLGI::TextureBorderColor::OpaqueWhite;
+
+	LLGI::SamplerParameter shadow;
+	shadow.IsCompareEnabled = true;
+	shadow.CompareFunc = LLGI::CompareFuncType::Less;
+
+	// descriptions which are different in any field are different samplers
+	VERIFY(anisotropic != shadow);
+	VERIFY(LLGI::SamplerParameter::Hash()(anisotropic) != LLGI::SamplerParameter::Hash()(shadow));
+
+	// the legacy arguments are converted into a description
+	const auto legacy = LLGI::SamplerParameter(LLGI::TextureWrapMode::Mirror, LLGI::TextureMinMagFilter::Linear);
+	VERIFY(legacy.WrapModeU == LLGI::TextureWrapMode::Mirror && legacy.WrapModeW == LLGI::TextureWrapMode::Mirror);
+	VERIFY(legacy.MinFilter == LLGI::TextureMinMagFilter::Linear && legacy.MaxAnisotropy == 1);
+
+	VERIFY(objects.platform->NewFrame());
+	objects.sfMemoryPool->NewFrame();
+
+	objects.commandList->Begin();
+	objects.commandList->BeginRenderPass(objects.platform->GetCurrentScreen(LLGI::Color8(), true, true));
+	objects.commandList->SetVertexBuffer(objects.vb.get(), sizeof(SimpleVertex), 0);
+	objects.commandList->SetIndexBuffer(objects.ib.get(), 2);
+	objects.commandList->SetPipelineState(objects.pip.get());
+	objects.commandList->SetTexture(texture.get(), anisotropic, 0);
+	objects.commandList->SetTexture(depthTexture.get(), shadow, 1);
+	objects.commandList->SetTexture(texture.get(), LLGI::TextureWrapMode::Mirror, LLGI::TextureMinMagFilter::Linear, 2);
+	objects.commandList->Draw(2);
+	objects.commandList->EndRenderPass();
+	objects.commandList->End();
+
+	objects.graphics->Execute(objects.commandList.get());
+	objects.platform->Present();
+
+	std::array<LLGI::SamplerParameter, 3> recorded;
+	auto nullCommandList = static_cast<LLGI::CommandListNull*>(objects.commandList.get());
+	nullCommandList->GetCommandStream().Visit([&recorded](LLGI::CommandTypeNull type, const void* payload) -> void {
+		if (type != LLGI::CommandTypeNull::SetTexture)
+			return;
+
+		LLGI::CommandTextureNull command;
+		memcpy(&command, payload, sizeof(command));
+		recorded.at(command.Unit) = command.Sampler;
+	});
+
+	VERIFY(recorded.at(0) == anisotropic);
+	VERIFY(recorded.at(1) == shadow);
+	VERIFY(recorded.at(2) == legacy);
+
+	objects.graphics->WaitFinish();
+}
+
+TestRegister Null_Draw("Null.Draw", [](LLGI::DeviceType device) -> void { test_null_draw(10000); });
+
+TestRegister Null_SubCommandLists("Null.SubCommandLists", [](LLGI::DeviceType device) -> void { test_null_sub_command_lists(4, 2500); });
+
+TestRegister Null_RenderPassKey("Null.RenderPassKey", [](LLGI::DeviceType device) -> void { test_null_render_pass_key(); });
+
+TestRegister Null_Sampler("Null.Sampler", [](LLGI::DeviceType device) -> void { test_null_sampler(); });
@@ -0,0 +1,69 @@
+#include "TestHelper.h"
+#include "test.h"
+#include <cstdio>
+
+void test_pipeline_cache(LLGI::DeviceType deviceType)
+{
+	// a pipeline cache is supported only with Vulkan
+	if (deviceType != LLGI::DeviceType::Vulkan)
+		return;
+
+	const char* path = "PipelineCache.bin";
+
+	// a cache left by a previous run would hide compiling without a cache
+	std::remove(path);
+
+	for (int32_t loop = 0; loop < 2; loop++)
+	{
+		LLGI::PlatformParameter pp;
+		pp.Device = deviceType;
+		pp.IsHeadless = true;
+		auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+		VERIFY(platform != nullptr);
+
+		auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+
+		// the cache saved in the first loop is loaded in the second loop
+		if (loop == 1)
+		{
+			VERIFY(graphics->LoadPipelineCache(path));
+
+			// a cache created with another device is rejected
+			auto data = graphics->GetPipelineCacheData();
+			VERIFY(data.size() > 16);
+			data[16] = ~data[16];
+			VERIFY(!graphics->LoadPipelineCacheData(data.data(), static_cast<int32_t>(data.size())));
+		}
+
+		std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+		std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+		TestHelper::CreateShader(graphics.get(), deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+		auto renderPass = platform->GetCurrentScreen(LLGI::Color8(), true, false);
+		auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass));
+
+		auto pip = LLGI::CreateSharedPtr(graphics->CreatePiplineState());
+		pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+		pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+		pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+		pip->VertexLayoutNames[0] = "POSITION";
+		pip->VertexLayoutNames[1] = "UV";
+		pip->VertexLayoutNames[2] = "COLOR";
+		pip->VertexLayoutCount = 3;
+		pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs.get());
+		pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps.get());
+		pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+		VERIFY(pip->Compile());
+
+		if (loop == 0)
+		{
+			VERIFY(graphics->SavePipelineCache(path));
+		}
+
+		graphics->WaitFinish();
+	}
+
+	std::remove(path);
+}
+
+TestRegister PipelineCache_SaveLoad("PipelineCache.SaveLoad", [](LLGI::DeviceType device) -> void { test_pipeline_cache(device); });
@@ -0,0 +1,110 @@
+#include "TestHelper.h"
+#include "test.h"
+
+#include <Utils/LLGI.CommandListPool.h>
+
+void test_pipeline_state_compile_async(LLGI::DeviceType deviceType)
+{
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("CompileAsync", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, window.get()));
+	VERIFY(platform != nullptr);
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+	auto commandListPool = std::make_shared<LLGI::CommandListPool>(graphics.get(), sfMemoryPool.get(), 3);
+
+	std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+	TestHelper::CreateShader(graphics.get(), deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+	std::shared_ptr<LLGI::Buffer> vb;
+	std::shared_ptr<LLGI::Buffer> ib;
+	TestHelper::CreateRectangle(graphics.get(),
+								LLGI::Vec3F(-0.5, 0.5, 0.5),
+								LLGI::Vec3F(0.5, -0.5, 0.5),
+								LLGI::Color8(255, 255, 255, 255),
+								LLGI::Color8(0, 255, 0, 255),
+								vb,
+								ib);
+
+	auto renderPassPipelineState =
+		LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(platform->GetCurrentScreen(LLGI::Color8(), true, false)));
+
+	// compile pipeline states with different states in parallel
+	const std::array<LLGI::CullingMode, 3> cullings = {
+		LLGI::CullingMode::Clockwise, LLGI::CullingMode::CounterClockwise, LLGI::CullingMode::DoubleSide};
+
+	std::vector<std::shared_ptr<LLGI::PipelineState>> pips;
+	std::vector<std::shared_future<bool>> tasks;
+
+	for (int32_t i = 0; i < 12; i++)
+	{
+		auto pip = LLGI::CreateSharedPtr(graphics->CreatePiplineState());
+		pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+		pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+		pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+		pip->VertexLayoutNames[0] = "POSITION";
+		pip->VertexLayoutNames[1] = "UV";
+		pip->VertexLayoutNames[2] = "COLOR";
+		pip->VertexLayoutCount = 3;
+		pip->Culling = cullings[i % cullings.size()];
+		pip->IsBlendEnabled = (i / cullings.size()) % 2 == 0;
+		pip->IsDepthTestEnabled = (i / cullings.size()) / 2 == 0;
+		pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs.get());
+		pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps.get());
+		pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+
+		tasks.emplace_back(pip->CompileAsync());
+		pips.emplace_back(pip);
+	}
+
+	int count = 0;
+	while (count < 10)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		auto renderPass = platform->GetCurrentScreen(LLGI::Color8(), true, false);
+
+		auto commandList = commandListPool->Get();
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get(), 2);
+
+		for (auto& pip : pips)
+		{
+			// a draw is skipped while the pipeline state is compiled
+			commandList->SetPipelineState(pip.get(), nullptr);
+			commandList->Draw(2);
+		}
+
+		// wait until the last one is compiled
+		commandList->SetPipelineState(pips.back().get());
+		VERIFY(!pips.back()->GetIsCompiling());
+		commandList->Draw(2);
+
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+	}
+
+	for (auto& task : tasks)
+	{
+		VERIFY(task.get());
+	}
+
+	graphics->WaitFinish();
+}
+
+TestRegister PipelineState_CompileAsync("PipelineState.CompileAsync",
+										[](LLGI::DeviceType device) -> void { test_pipeline_state_compile_async(device); });
@@ -0,0 +1,145 @@
+#include "TestHelper.h"
+#include "test.h"
+#include <LLGI.Readback.h>
+#include <Utils/LLGI.CommandListPool.h>
+
+#ifdef ENABLE_VULKAN
+#include <Vulkan/LLGI.CommandListVulkan.h>
+#endif
+
+void test_readback_async(LLGI::DeviceType deviceType)
+{
+	// asynchronous readback is supported only with Vulkan
+	if (deviceType != LLGI::DeviceType::Vulkan)
+		return;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.IsHeadless = true;
+	pp.HeadlessScreenSize = LLGI::Vec2I(320, 240);
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+	VERIFY(platform != nullptr);
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+	auto commandListPool = std::make_shared<LLGI::CommandListPool>(graphics.get(), sfMemoryPool.get(), 3);
+
+	const int32_t bufferSize = 256;
+	auto buffer = LLGI::CreateSharedPtr(graphics->CreateBuffer(LLGI::BufferUsageType::MapWrite | LLGI::BufferUsageType::CopySrc, bufferSize));
+
+	std::vector<std::shared_ptr<LLGI::Readback>> screenReadbacks;
+	std::vector<std::shared_ptr<LLGI::Readback>> bufferReadbacks;
+	std::vector<LLGI::Color8> colors;
+
+	// readbacks of frames overlap with rendering of next frames
+	for (int32_t count = 0; count < 10; count++)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		LLGI::Color8 color;
+		color.R = count * 20;
+		color.G = 64;
+		color.B = 128;
+		color.A = 255;
+		colors.emplace_back(color);
+
+		auto data = static_cast<uint8_t*>(buffer->Lock());
+		VERIFY(data != nullptr);
+		for (int32_t i = 0; i < bufferSize; i++)
+		{
+			data[i] = static_cast<uint8_t>(count + i);
+		}
+		buffer->Unlock();
+
+		auto renderPass = platform->GetCurrentScreen(color, true, false);
+
+		auto commandList = commandListPool->Get();
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+		commandList->EndRenderPass();
+
+		auto screenReadback = LLGI::CreateSharedPtr(commandList->ReadbackTexture(renderPass->GetRenderTexture(0)));
+		VERIFY(screenReadback != nullptr);
+		VERIFY(screenReadback->GetSize() == 320 * 240 * 4);
+		screenReadbacks.emplace_back(screenReadback);
+
+		auto bufferReadback = LLGI::CreateSharedPtr(commandList->ReadbackBuffer(buffer.get()));
+		VERIFY(bufferReadback != nullptr);
+		bufferReadbacks.emplace_back(bufferReadback);
+
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		// the buffer is rewritten in the next frame
+		bufferReadback->Wait();
+
+		platform->Present();
+	}
+
+	VERIFY(screenReadbacks.size() == 10);
+
+	for (size_t i = 0; i < screenReadbacks.size(); i++)
+	{
+		std::vector<uint8_t> data;
+		VERIFY(screenReadbacks[i]->GetData(data));
+		VERIFY(screenReadbacks[i]->GetIsCompleted());
+		VERIFY(data.size() == 320 * 240 * 4);
+		VERIFY(data[0] == colors[i].R);
+		VERIFY(data[1] == colors[i].G);
+		VERIFY(data[2] == colors[i].B);
+		VERIFY(data[3] == colors[i].A);
+
+		VERIFY(bufferReadbacks[i]->GetData(data));
+		VERIFY(data.size() == bufferSize);
+		VERIFY(data[0] == static_cast<uint8_t>(i));
+		VERIFY(data[bufferSize - 1] == static_cast<uint8_t>(i + bufferSize - 1));
+	}
+
+	graphics->WaitFinish();
+}
+
+void test_readback_with_platform(LLGI::DeviceType deviceType)
+{
+#ifdef ENABLE_VULKAN
+	if (deviceType != LLGI::DeviceType::Vulkan)
+		return;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.IsHeadless = true;
+	pp.HeadlessScreenSize = LLGI::Vec2I(320, 240);
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+	VERIFY(platform != nullptr);
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+	auto commandList = LLGI::CreateSharedPtr(graphics->CreateCommandList(sfMemoryPool.get()));
+
+	auto buffer = LLGI::CreateSharedPtr(graphics->CreateBuffer(LLGI::BufferUsageType::MapWrite | LLGI::BufferUsageType::CopySrc, 256));
+
+	LLGI::TextureParameter texParam;
+	texParam.Usage = LLGI::TextureUsageType::RenderTarget;
+	texParam.Size = LLGI::Vec3I(64, 64, 1);
+	auto texture = LLGI::CreateSharedPtr(graphics->CreateTexture(texParam));
+
+	// readbacks are rejected because a command buffer of a caller is submitted without Graphics::Execute
+	LLGI::PlatformContextVulkan context;
+	context.commandBuffer = VK_NULL_HANDLE;
+
+	sfMemoryPool->NewFrame();
+	VERIFY(commandList->BeginWithPlatform(&context));
+	VERIFY(commandList->ReadbackBuffer(buffer.get()) == nullptr);
+	VERIFY(commandList->ReadbackTexture(texture.get()) == nullptr);
+	commandList->EndWithPlatform();
+
+	graphics->WaitFinish();
+#endif
+}
+
+TestRegister Readback_Async("Readback.Async", [](LLGI::DeviceType device) -> void { test_readback_async(device); });
+
+TestRegister Readback_WithPlatform("Readback.WithPlatform", [](LLGI::DeviceType device) -> void { test_readback_with_platform(device); });
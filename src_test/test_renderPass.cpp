@@ -8,19 +8,22 @@ enum class RenderPassTestMode
 	None,
 	MSAA,
 	MSAADepth,
+	MSAATransient,
 	CopyTexture,
 };
 
 void test_renderPass(LLGI::DeviceType deviceType, RenderPassTestMode mode)
 {
 #if !(defined(__linux__) || defined(__APPLE__) || defined(WIN32))
-	if (mode == RenderPassTestMode::MSAA || mode == RenderPassTestMode::MSAADepth)
+	if (mode == RenderPassTestMode::MSAA || mode == RenderPassTestMode::MSAADepth || mode == RenderPassTestMode::MSAATransient)
 	{
 		return;
 	}
 #endif
 
-	bool isMSAATest = mode == RenderPassTestMode::MSAA || mode == RenderPassTestMode::MSAADepth;
+	bool isMSAATest =
+		mode == RenderPassTestMode::MSAA || mode == RenderPassTestMode::MSAADepth || mode == RenderPassTestMode::MSAATransient;
+	bool hasDepth = mode == RenderPassTestMode::MSAADepth || mode == RenderPassTestMode::MSAATransient;
 
 	int count = 0;
 
@@ -45,20 +48,25 @@ void test_renderPass(LLGI::DeviceType deviceType, RenderPassTestMode mode)
 		params.SamplingCount = 4;
 	}
 
+	// multisampled textures are only resolved, so they don't need memory after the render pass
+	params.IsTransient = mode == RenderPassTestMode::MSAATransient;
+
 	auto renderTexture = graphics->CreateRenderTexture(params);
 	assert(renderTexture->GetType() == LLGI::TextureType::Render);
 
 	params.SamplingCount = 1;
+	params.IsTransient = false;
 	auto renderTextureDst = graphics->CreateRenderTexture(params);
 
 	LLGI::Texture* depthTexture = nullptr;
 	LLGI::Texture* depthTextureDst = nullptr;
 
-	if (mode == RenderPassTestMode::MSAADepth)
+	if (hasDepth)
 	{
 		LLGI::DepthTextureInitializationParameter depthParam;
 		depthParam.Size = params.Size;
 		depthParam.SamplingCount = 4;
+		depthParam.IsTransient = mode == RenderPassTestMode::MSAATransient;
 
 		depthTexture = graphics->CreateDepthTexture(depthParam);
 
@@ -70,7 +78,7 @@ void test_renderPass(LLGI::DeviceType deviceType, RenderPassTestMode mode)
 
 	LLGI::RenderPass* renderPass = nullptr;
 
-	if (mode == RenderPassTestMode::MSAADepth)
+	if (hasDepth)
 	{
 		if (graphics->IsResolvedDepthSupported())
 		{
@@ -273,6 +281,11 @@ void test_renderPass(LLGI::DeviceType deviceType, RenderPassTestMode mode)
 				Bitmap2D(data, screenTex->GetSizeAs2D().X, screenTex->GetSizeAs2D().Y, screenTex->GetFormat())
 					.Save("RenderPass.MSAA_" + TestHelper::GetDeviceName(deviceType) + ".png");
 			}
+			else if (mode == RenderPassTestMode::MSAATransient)
+			{
+				Bitmap2D(data, screenTex->GetSizeAs2D().X, screenTex->GetSizeAs2D().Y, screenTex->GetFormat())
+					.Save("RenderPass.MSAATransient_" + TestHelper::GetDeviceName(deviceType) + ".png");
+			}
 			else if (mode == RenderPassTestMode::None)
 			{
 				Bitmap2D(data, screenTex->GetSizeAs2D().X, screenTex->GetSizeAs2D().Y, screenTex->GetFormat())
@@ -608,6 +621,237 @@ void test_multiRenderPass(LLGI::DeviceType deviceType)
 	LLGI::SafeRelease(compiler);
 }
 
+//! objects which are shared among tests which check pixels of a render texture
+struct RenderPassTestObjects
+{
+	std::unique_ptr<LLGI::Window> window;
+	std::shared_ptr<LLGI::Platform> platform;
+	std::shared_ptr<LLGI::Graphics> graphics;
+	std::shared_ptr<LLGI::SingleFrameMemoryPool> sfMemoryPool;
+	std::shared_ptr<LLGI::CommandList> commandList;
+	std::shared_ptr<LLGI::Shader> vs;
+	std::shared_ptr<LLGI::Shader> ps;
+
+	//! a blue rectangle which covers the center of a render texture
+	std::shared_ptr<LLGI::Buffer> vb;
+	std::shared_ptr<LLGI::Buffer> ib;
+
+	void Initialize(LLGI::DeviceType deviceType)
+	{
+		LLGI::PlatformParameter pp;
+		pp.Device = deviceType;
+		window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("RenderPass", LLGI::Vec2I(1280, 720)));
+		platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, window.get()));
+		VERIFY(platform != nullptr);
+
+		graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+		sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+		commandList = LLGI::CreateSharedPtr(graphics->CreateCommandList(sfMemoryPool.get()));
+
+		TestHelper::CreateShader(graphics.get(), deviceType, "simple_rectangle.vert", "simple_rectangle.frag", vs, ps);
+		TestHelper::CreateRectangle(graphics.get(),
+									LLGI::Vec3F(-0.5, 0.5, 0.5),
+									LLGI::Vec3F(0.5, -0.5, 0.5),
+									LLGI::Color8(0, 0, 255, 255),
+									LLGI::Color8(0, 0, 255, 255),
+									vb,
+									ib);
+	}
+
+	void Draw(LLGI::PipelineState* pip)
+	{
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get(), 2);
+		commandList->SetPipelineState(pip);
+		commandList->Draw(2);
+	}
+
+	Bitmap2D::Color GetPixel(LLGI::Texture* texture, int x, int y)
+	{
+		auto data = graphics->CaptureRenderTarget(texture);
+		return Bitmap2D(data, texture->GetSizeAs2D().X, texture->GetSizeAs2D().Y, texture->GetFormat()).GetPixel(x, y);
+	}
+};
+
+void test_renderPass_loadOp(LLGI::DeviceType deviceType)
+{
+	RenderPassTestObjects objects;
+	objects.Initialize(deviceType);
+	auto graphics = objects.graphics;
+	auto commandList = objects.commandList;
+
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(64, 64);
+	auto renderTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+	auto copiedTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+
+	LLGI::Texture* renderTextures[] = {renderTexture.get()};
+	auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(renderTextures, 1, nullptr));
+	renderPass->SetClearColor(0, LLGI::Color8(255, 0, 0, 255));
+
+	renderPass->SetColorLoadOp(0, LLGI::AttachmentLoadOp::Load);
+	auto pip = TestHelper::CreatePipelineState(graphics.get(), renderPass.get(), objects.vs.get(), objects.ps.get());
+	VERIFY(pip != nullptr);
+
+	VERIFY(objects.platform->NewFrame());
+	objects.sfMemoryPool->NewFrame();
+	commandList->Begin();
+
+	renderPass->SetColorLoadOp(0, LLGI::AttachmentLoadOp::Clear);
+	commandList->BeginRenderPass(renderPass.get());
+	commandList->EndRenderPass();
+
+	// the render texture is copied in between, so it is not in the layout which a render pass leaves
+	commandList->CopyTexture(renderTexture.get(), copiedTexture.get());
+
+	renderPass->SetColorLoadOp(0, LLGI::AttachmentLoadOp::Load);
+	commandList->BeginRenderPass(renderPass.get());
+	objects.Draw(pip.get());
+	commandList->EndRenderPass();
+
+	commandList->End();
+	graphics->Execute(commandList.get());
+	graphics->WaitFinish();
+
+	// the cleared color is kept around the rectangle
+	auto corner = objects.GetPixel(renderTexture.get(), 2, 2);
+	VERIFY(corner.r == 255 && corner.g == 0 && corner.b == 0);
+
+	auto center = objects.GetPixel(renderTexture.get(), 32, 32);
+	VERIFY(center.r == 0 && center.g == 0 && center.b == 255);
+
+	auto copied = objects.GetPixel(copiedTexture.get(), 32, 32);
+	VERIFY(copied.r == 255 && copied.g == 0 && copied.b == 0);
+}
+
+void test_renderPass_compatibleKey(LLGI::DeviceType deviceType)
+{
+	RenderPassTestObjects objects;
+	objects.Initialize(deviceType);
+	auto graphics = objects.graphics;
+	auto commandList = objects.commandList;
+
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(64, 64);
+	auto renderTexture1 = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+	auto renderTexture2 = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+
+	LLGI::Texture* renderTextures1[] = {renderTexture1.get()};
+	LLGI::Texture* renderTextures2[] = {renderTexture2.get()};
+	auto renderPass1 = LLGI::CreateSharedPtr(graphics->CreateRenderPass(renderTextures1, 1, nullptr));
+	auto renderPass2 = LLGI::CreateSharedPtr(graphics->CreateRenderPass(renderTextures2, 1, nullptr));
+	renderPass1->SetIsColorCleared(true);
+	renderPass2->SetIsColorCleared(true);
+	renderPass2->SetClearColor(LLGI::Color8(255, 0, 0, 255));
+
+	// render passes with the same formats and operations are compatible even if their textures are different
+	VERIFY(renderPass1->GetKeyID() == renderPass2->GetKeyID());
+
+	auto pip = TestHelper::CreatePipelineState(graphics.get(), renderPass1.get(), objects.vs.get(), objects.ps.get());
+	VERIFY(pip != nullptr);
+
+	VERIFY(objects.platform->NewFrame());
+	objects.sfMemoryPool->NewFrame();
+	commandList->Begin();
+	commandList->BeginRenderPass(renderPass2.get());
+	objects.Draw(pip.get());
+	commandList->EndRenderPass();
+	commandList->End();
+	graphics->Execute(commandList.get());
+	graphics->WaitFinish();
+
+	// a pipeline state created from the other render pass draws
+	auto center = objects.GetPixel(renderTexture2.get(), 32, 32);
+	VERIFY(center.r == 0 && center.g == 0 && center.b == 255);
+
+	// a different load operation makes a render pass incompatible
+	renderPass2->SetColorLoadOp(0, LLGI::AttachmentLoadOp::Load);
+	VERIFY(renderPass1->GetKeyID() != renderPass2->GetKeyID());
+}
+
+void test_renderPass_subCommandLists(LLGI::DeviceType deviceType)
+{
+	RenderPassTestObjects objects;
+	objects.Initialize(deviceType);
+	auto graphics = objects.graphics;
+	auto commandList = objects.commandList;
+
+	auto subMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+	auto subCommandList = LLGI::CreateSharedPtr(graphics->CreateSubCommandList(subMemoryPool.get()));
+
+	// sub command lists are supported in some platform
+	if (subCommandList == nullptr)
+		return;
+
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(64, 64);
+	auto renderTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+
+	LLGI::Texture* renderTextures[] = {renderTexture.get()};
+	auto clearedRenderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(renderTextures, 1, nullptr));
+	clearedRenderPass->SetClearColor(0, LLGI::Color8(255, 0, 0, 255));
+	clearedRenderPass->SetColorLoadOp(0, LLGI::AttachmentLoadOp::Clear);
+
+	auto loadedRenderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(renderTextures, 1, nullptr));
+	loadedRenderPass->SetColorLoadOp(0, LLGI::AttachmentLoadOp::Load);
+
+	auto clearedPip = TestHelper::CreatePipelineState(graphics.get(), clearedRenderPass.get(), objects.vs.get(), objects.ps.get());
+	auto loadedPip = TestHelper::CreatePipelineState(graphics.get(), loadedRenderPass.get(), objects.vs.get(), objects.ps.get());
+	VERIFY(clearedPip != nullptr && loadedPip != nullptr);
+
+	// a green rectangle which covers the upper left and the center
+	std::shared_ptr<LLGI::Buffer> subVB;
+	std::shared_ptr<LLGI::Buffer> subIB;
+	TestHelper::CreateRectangle(graphics.get(),
+								LLGI::Vec3F(-1.0, 1.0, 0.5),
+								LLGI::Vec3F(0.25, -0.25, 0.5),
+								LLGI::Color8(0, 255, 0, 255),
+								LLGI::Color8(0, 255, 0, 255),
+								subVB,
+								subIB);
+
+	VERIFY(objects.platform->NewFrame());
+	objects.sfMemoryPool->NewFrame();
+	subMemoryPool->NewFrame();
+	commandList->Begin();
+
+	commandList->BeginRenderPass(clearedRenderPass.get());
+	objects.Draw(clearedPip.get());
+	commandList->EndRenderPass();
+
+	subCommandList->Begin();
+	subCommandList->BeginRenderPass(loadedRenderPass.get());
+	subCommandList->SetVertexBuffer(subVB.get(), sizeof(SimpleVertex), 0);
+	subCommandList->SetIndexBuffer(subIB.get(), 2);
+	subCommandList->SetPipelineState(loadedPip.get());
+	subCommandList->Draw(2);
+	subCommandList->EndRenderPass();
+	subCommandList->End();
+
+	LLGI::CommandList* subCommandLists[] = {subCommandList.get()};
+	commandList->BeginRenderPassWithSubCommandLists(loadedRenderPass.get());
+	commandList->ExecuteSubCommandLists(subCommandLists, 1);
+	commandList->EndRenderPass();
+
+	// the same buffers as the first render pass are bound again after sub command lists
+	commandList->BeginRenderPass(loadedRenderPass.get());
+	objects.Draw(loadedPip.get());
+	commandList->EndRenderPass();
+
+	commandList->End();
+	graphics->Execute(commandList.get());
+	graphics->WaitFinish();
+
+	auto upperLeft = objects.GetPixel(renderTexture.get(), 2, 2);
+	VERIFY(upperLeft.r == 0 && upperLeft.g == 255 && upperLeft.b == 0);
+
+	auto lowerRight = objects.GetPixel(renderTexture.get(), 61, 61);
+	VERIFY(lowerRight.r == 255 && lowerRight.g == 0 && lowerRight.b == 0);
+
+	auto center = objects.GetPixel(renderTexture.get(), 32, 32);
+	VERIFY(center.r == 0 && center.g == 0 && center.b == 255);
+}
+
 TestRegister RenderPass_Basic("RenderPass.Basic",
 							  [](LLGI::DeviceType device) -> void { test_renderPass(device, RenderPassTestMode::None); });
 
@@ -616,6 +860,9 @@ TestRegister RenderPass_MSAA("RenderPass.MSAA", [](LLGI::DeviceType device) -> v
 TestRegister RenderPass_MSAADepth("RenderPass.MSAADepth",
 								  [](LLGI::DeviceType device) -> void { test_renderPass(device, RenderPassTestMode::MSAADepth); });
 
+TestRegister RenderPass_MSAATransient("RenderPass.MSAATransient",
+									  [](LLGI::DeviceType device) -> void { test_renderPass(device, RenderPassTestMode::MSAATransient); });
+
 TestRegister RenderPass_CopyTexture("RenderPass.CopyTexture",
 									[](LLGI::DeviceType device) -> void { test_renderPass(device, RenderPassTestMode::CopyTexture); });
 
@@ -623,3 +870,11 @@ TestRegister RenderPass_CopyTextureToScreen("RenderPass.CopyTextureToScreen",
 											[](LLGI::DeviceType device) -> void { test_copyTextureToScreen(device); });
 
 TestRegister RenderPass_MRT("RenderPass.MRT", [](LLGI::DeviceType device) -> void { test_multiRenderPass(device); });
+
+TestRegister RenderPass_LoadOp("RenderPass.LoadOp", [](LLGI::DeviceType device) -> void { test_renderPass_loadOp(device); });
+
+TestRegister RenderPass_CompatibleKey("RenderPass.CompatibleKey",
+									  [](LLGI::DeviceType device) -> void { test_renderPass_compatibleKey(device); });
+
+TestRegister RenderPass_SubCommandLists("RenderPass.SubCommandLists",
+										[](LLGI::DeviceType device) -> void { test_renderPass_subCommandLists(device); });
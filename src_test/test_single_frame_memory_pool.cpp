@@ -0,0 +1,121 @@
+#include "TestHelper.h"
+#include "test.h"
+
+void test_single_frame_memory_pool_grow(LLGI::DeviceType deviceType)
+{
+	// chaining pages is supported only with Vulkan
+	if (deviceType != LLGI::DeviceType::Vulkan)
+		return;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.IsHeadless = true;
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+	VERIFY(platform != nullptr);
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+
+	const int32_t poolSize = 1024;
+	const int32_t cbSize = 256;
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(poolSize, 16));
+
+	// the pool grows when it is full
+	sfMemoryPool->NewFrame();
+	for (int32_t i = 0; i < 64; i++)
+	{
+		auto cb = sfMemoryPool->CreateConstantBuffer(cbSize);
+		VERIFY(cb != nullptr);
+
+		auto data = static_cast<float*>(cb->Lock());
+		VERIFY(data != nullptr);
+		data[0] = static_cast<float>(i);
+		cb->Unlock();
+
+		LLGI::SafeRelease(cb);
+	}
+
+	auto stats = sfMemoryPool->GetStats();
+	VERIFY(stats.ConstantBufferCount == 64);
+	VERIFY(stats.UsedSize == 64 * cbSize);
+	VERIFY(stats.CapacitySize >= stats.UsedSize);
+	VERIFY(stats.PageCount > 1);
+	VERIFY(stats.HighWaterMark == stats.UsedSize);
+
+	// a larger buffer than a page
+	{
+		auto cb = sfMemoryPool->CreateConstantBuffer(poolSize * 2);
+		VERIFY(cb != nullptr);
+		LLGI::SafeRelease(cb);
+	}
+
+	// extra pages are released after the peak is forgotten
+	for (int32_t frame = 0; frame < 300; frame++)
+	{
+		sfMemoryPool->NewFrame();
+		auto cb = sfMemoryPool->CreateConstantBuffer(cbSize);
+		VERIFY(cb != nullptr);
+		LLGI::SafeRelease(cb);
+	}
+
+	stats = sfMemoryPool->GetStats();
+	VERIFY(stats.ConstantBufferCount == 1);
+	VERIFY(stats.UsedSize == cbSize);
+	VERIFY(stats.PageCount == 1);
+	VERIFY(stats.CapacitySize == poolSize);
+	VERIFY(stats.HighWaterMark == cbSize);
+
+	graphics->WaitFinish();
+}
+
+void test_single_frame_memory_pool_transient(LLGI::DeviceType deviceType)
+{
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("Transient", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, window.get()));
+	VERIFY(platform != nullptr);
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024, 16));
+
+	for (int32_t frame = 0; frame < 3; frame++)
+	{
+		sfMemoryPool->NewFrame();
+
+		// allocations in a frame are packed into the same buffer
+		LLGI::Buffer* prevVB = nullptr;
+		int32_t prevOffset = -1;
+		for (int32_t i = 0; i < 16; i++)
+		{
+			const int32_t size = sizeof(SimpleVertex) * 4;
+			LLGI::Buffer* vb = nullptr;
+			int32_t offset = 0;
+			VERIFY(sfMemoryPool->AllocateVertexBuffer(size, vb, offset));
+			VERIFY(vb != nullptr);
+			VERIFY(prevVB == nullptr || (vb == prevVB && offset > prevOffset));
+
+			auto data = static_cast<SimpleVertex*>(vb->Lock(offset, size));
+			VERIFY(data != nullptr);
+			data[0].Pos = LLGI::Vec3F(static_cast<float>(i), 0.0f, 0.0f);
+			vb->Unlock();
+
+			prevVB = vb;
+			prevOffset = offset;
+		}
+
+		// a large allocation
+		LLGI::Buffer* ib = nullptr;
+		int32_t offset = 0;
+		VERIFY(sfMemoryPool->AllocateIndexBuffer(4 * 1024 * 1024, ib, offset));
+		VERIFY(ib != nullptr && offset == 0);
+		VERIFY(ib->GetSize() >= 4 * 1024 * 1024);
+	}
+
+	graphics->WaitFinish();
+}
+
+TestRegister SingleFrameMemoryPool_Grow("SingleFrameMemoryPool.Grow",
+										[](LLGI::DeviceType device) -> void { test_single_frame_memory_pool_grow(device); });
+
+TestRegister SingleFrameMemoryPool_Transient("SingleFrameMemoryPool.Transient",
+											 [](LLGI::DeviceType device) -> void { test_single_frame_memory_pool_transient(device); });
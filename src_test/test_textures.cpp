@@ -8,6 +8,10 @@
 #include <iostream>
 #include <map>
 
+#ifdef ENABLE_VULKAN
+#include <Vulkan/LLGI.GraphicsVulkan.h>
+#endif
+
 void test_textures(LLGI::DeviceType deviceType)
 {
 	auto compiler = LLGI::CreateCompiler(deviceType);
@@ -245,3 +249,98 @@ void test_textures(LLGI::DeviceType deviceType)
 	LLGI::SafeRelease(compiler);
 }
 TestRegister SimpleRender_Textures("SimpleRender.Textures", [](LLGI::DeviceType device) -> void { test_textures(device); });
+
+void test_textures_samplerCache(LLGI::DeviceType deviceType)
+{
+#ifdef ENABLE_VULKAN
+	// samplers are cached only with Vulkan
+	if (deviceType != LLGI::DeviceType::Vulkan)
+		return;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.IsHeadless = true;
+	pp.HeadlessScreenSize = LLGI::Vec2I(320, 240);
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+	VERIFY(platform != nullptr);
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+
+	std::array<std::shared_ptr<LLGI::CommandList>, 3> commandLists;
+	for (auto& commandList : commandLists)
+		commandList = LLGI::CreateSharedPtr(graphics->CreateCommandList(sfMemoryPool.get()));
+
+	LLGI::TextureParameter texParam;
+	texParam.Size = LLGI::Vec3I(16, 16, 1);
+	auto texture = LLGI::CreateSharedPtr(graphics->CreateTexture(texParam));
+	TestHelper::WriteDummyTexture(texture.get());
+
+	LLGI::TextureParameter renderTexParam;
+	renderTexParam.Usage = LLGI::TextureUsageType::RenderTarget;
+	renderTexParam.Size = LLGI::Vec3I(64, 64, 1);
+	auto renderTexture = LLGI::CreateSharedPtr(graphics->CreateTexture(renderTexParam));
+
+	LLGI::Texture* renderTextures[] = {renderTexture.get()};
+	auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(renderTextures, 1, nullptr));
+	renderPass->SetIsColorCleared(true);
+
+	std::shared_ptr<LLGI::Shader> vs;
+	std::shared_ptr<LLGI::Shader> ps;
+	TestHelper::CreateShader(graphics.get(), deviceType, "simple_texture_rectangle.vert", "simple_texture_rectangle.frag", vs, ps);
+
+	std::shared_ptr<LLGI::Buffer> vb;
+	std::shared_ptr<LLGI::Buffer> ib;
+	TestHelper::CreateRectangle(graphics.get(),
+								LLGI::Vec3F(-0.5, 0.5, 0.5),
+								LLGI::Vec3F(0.5, -0.5, 0.5),
+								LLGI::Color8(255, 255, 255, 255),
+								LLGI::Color8(255, 255, 255, 255),
+								vb,
+								ib);
+
+	auto pip = TestHelper::CreatePipelineState(graphics.get(), renderPass.get(), vs.get(), ps.get());
+	VERIFY(pip != nullptr);
+
+	LLGI::SamplerParameter linearSampler(LLGI::TextureWrapMode::Clamp, LLGI::TextureMinMagFilter::Linear);
+
+	LLGI::SamplerParameter repeatSampler = linearSampler;
+	repeatSampler.WrapModeU = LLGI::TextureWrapMode::Repeat;
+
+	// the same sampler is used from two command lists
+	std::array<LLGI::SamplerParameter, 3> samplers = {linearSampler, linearSampler, repeatSampler};
+
+	auto samplerCache = static_cast<LLGI::GraphicsVulkan*>(graphics.get())->GetSamplerCache();
+	auto initialCount = samplerCache->GetCount();
+
+	sfMemoryPool->NewFrame();
+
+	for (size_t i = 0; i < commandLists.size(); i++)
+	{
+		auto commandList = commandLists[i];
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass.get());
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get(), 2);
+		commandList->SetPipelineState(pip.get());
+		commandList->SetTexture(texture.get(), samplers[i], 0);
+		commandList->Draw(2);
+		commandList->EndRenderPass();
+		commandList->End();
+		graphics->Execute(commandList.get());
+
+		if (i == 1)
+		{
+			// a sampler created by the first command list is reused
+			VERIFY(samplerCache->GetCount() == initialCount + 1);
+		}
+	}
+
+	graphics->WaitFinish();
+
+	VERIFY(samplerCache->GetCount() == initialCount + 2);
+#endif
+}
+
+TestRegister SimpleRender_SamplerCache("SimpleRender.SamplerCache",
+									   [](LLGI::DeviceType device) -> void { test_textures_samplerCache(device); });
@@ -0,0 +1,101 @@
+#include "TestHelper.h"
+#include "test.h"
+#include <Utils/LLGI.CommandListPool.h>
+
+void test_upload_batch(LLGI::DeviceType deviceType)
+{
+	// batched uploads are supported only with Vulkan
+	if (deviceType != LLGI::DeviceType::Vulkan)
+		return;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.IsHeadless = true;
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, nullptr));
+	VERIFY(platform != nullptr);
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+	auto commandListPool = std::make_shared<LLGI::CommandListPool>(graphics.get(), sfMemoryPool.get(), 3);
+
+	// uploads of many textures are submitted at once
+	const int32_t textureCount = 64;
+	const int32_t textureSize = 16;
+	std::vector<std::shared_ptr<LLGI::Texture>> textures;
+
+	for (int32_t i = 0; i < textureCount; i++)
+	{
+		LLGI::TextureParameter texParam;
+		texParam.Size = LLGI::Vec3I(textureSize, textureSize, 1);
+		auto texture = LLGI::CreateSharedPtr(graphics->CreateTexture(texParam));
+		VERIFY(texture != nullptr);
+
+		auto data = static_cast<uint8_t*>(texture->Lock());
+		VERIFY(data != nullptr);
+		for (int32_t j = 0; j < textureSize * textureSize * 4; j++)
+		{
+			data[j] = static_cast<uint8_t>(i);
+		}
+		texture->Unlock();
+
+		textures.emplace_back(texture);
+	}
+
+	// a buffer on gpu is written through a staging buffer
+	const int32_t bufferSize = 256;
+	auto gpuBuffer =
+		LLGI::CreateSharedPtr(graphics->CreateBuffer(LLGI::BufferUsageType::Vertex | LLGI::BufferUsageType::CopySrc, bufferSize));
+	auto readBuffer =
+		LLGI::CreateSharedPtr(graphics->CreateBuffer(LLGI::BufferUsageType::MapRead | LLGI::BufferUsageType::CopyDst, bufferSize));
+
+	{
+		auto data = static_cast<uint8_t*>(gpuBuffer->Lock());
+		VERIFY(data != nullptr);
+		for (int32_t i = 0; i < bufferSize; i++)
+		{
+			data[i] = static_cast<uint8_t>(i);
+		}
+		gpuBuffer->Unlock();
+	}
+
+	// a region is overwritten in a command list
+	std::vector<uint8_t> region(4 * 4 * 4, 255);
+
+	auto commandList = commandListPool->Get();
+	commandList->Begin();
+	commandList->SetImageData2D(textures[0].get(), 4, 4, 4, 4, region.data());
+	commandList->CopyBuffer(gpuBuffer.get(), readBuffer.get());
+	commandList->End();
+
+	graphics->Execute(commandList);
+	graphics->WaitFinish();
+
+	for (int32_t i = 0; i < textureCount; i++)
+	{
+		std::vector<uint8_t> data;
+		VERIFY(textures[i]->GetData(data));
+		VERIFY(data.size() == textureSize * textureSize * 4);
+		VERIFY(data[0] == i);
+	}
+
+	{
+		std::vector<uint8_t> data;
+		VERIFY(textures[0]->GetData(data));
+		VERIFY(data[(5 * textureSize + 5) * 4] == 255);
+		VERIFY(data[(9 * textureSize + 9) * 4] == 0);
+	}
+
+	{
+		auto data = static_cast<uint8_t*>(readBuffer->Lock());
+		VERIFY(data != nullptr);
+		for (int32_t i = 0; i < bufferSize; i++)
+		{
+			VERIFY(data[i] == static_cast<uint8_t>(i));
+		}
+		readBuffer->Unlock();
+	}
+
+	graphics->WaitFinish();
+}
+
+TestRegister Upload_Batch("Upload.Batch", [](LLGI::DeviceType device) -> void { test_upload_batch(device); });